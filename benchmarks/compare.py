@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""Compares a benchmarker run against a baseline.
+
+Both files are the JSON output of benchmarker (see main.cpp), run with
+--benchmark_repetitions so each benchmark has several samples. A benchmark
+is flagged as slower when its median time went up by more than the
+threshold and a two-sided Mann-Whitney U test says the difference is
+significant. The exit status is 1 if any benchmark was flagged.
+
+The repetitions of one run share the machine's state, so the test is only
+meaningful against a baseline from the same quiet machine; the defaults
+are conservative for that reason.
+
+    compare.py baseline.json benchmark_results.json
+"""
+
+import argparse
+import json
+import math
+import sys
+
+# context keys that change what a benchmark measures
+MACHINE_KEYS = (
+    "host_name",
+    "num_cpus",
+    "mhz_per_cpu",
+    "cpu_scaling_enabled",
+    "library_build_type",
+    "compiler",
+    "operating_system",
+    "nhl_build_type",
+    "nhl_instrumentation",
+)
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+# fewer samples than this can't show a significant difference
+MIN_SAMPLES = 3
+
+
+def load_run(path, metric):
+    """The run's context and its samples in ns, by benchmark name"""
+    with open(path, encoding="utf-8") as f:
+        run = json.load(f)
+
+    samples = {}
+    for b in run.get("benchmarks", []):
+        if b.get("run_type", "iteration") != "iteration":
+            continue
+        if "error_occurred" in b:
+            continue
+
+        name = b.get("run_name", b["name"])
+        scale = TIME_UNITS[b.get("time_unit", "ns")]
+        samples.setdefault(name, []).append(b[metric] * scale)
+
+    return run.get("context", {}), samples
+
+
+def median(values):
+    s = sorted(values)
+    mid = len(s) // 2
+    return s[mid] if len(s) % 2 else (s[mid - 1] + s[mid]) / 2.0
+
+
+def mann_whitney_p(a, b):
+    """Two-sided p-value of the U test, with the normal approximation
+    (corrected for ties and continuity)"""
+    n1, n2 = len(a), len(b)
+    values = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+
+    # average ranks for ties
+    ranks = [0.0] * len(values)
+    tie_term = 0.0
+    i = 0
+    while i < len(values):
+        j = i
+        while j + 1 < len(values) and values[j + 1][0] == values[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = (i + j) / 2.0 + 1.0
+        t = j - i + 1
+        tie_term += t ** 3 - t
+        i = j + 1
+
+    r1 = sum(r for r, (_, side) in zip(ranks, values) if side == 0)
+    u = r1 - n1 * (n1 + 1) / 2.0
+
+    n = n1 + n2
+    mean = n1 * n2 / 2.0
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)))
+    if variance <= 0.0:
+        return 1.0
+
+    z = max(abs(u - mean) - 0.5, 0.0) / math.sqrt(variance)
+    return math.erfc(z / math.sqrt(2.0))
+
+
+def format_time(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.3f} {unit}"
+    return f"{ns:.1f} ns"
+
+
+def compare_context(baseline, contender):
+    differences = []
+    for key in MACHINE_KEYS:
+        if baseline.get(key) != contender.get(key):
+            differences.append(
+                f"  {key}: {baseline.get(key)} -> {contender.get(key)}")
+
+    if differences:
+        print("Warning: the runs weren't measured the same way, so the "
+              "times may not be comparable")
+        print("\n".join(differences))
+        print()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Flag the benchmarks that got significantly slower "
+                    "than the baseline")
+    parser.add_argument("baseline", help="the baseline JSON results")
+    parser.add_argument("contender", help="the JSON results to check")
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"),
+                        default="real_time", help="the time to compare")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="the smallest slowdown flagged (default 0.10, "
+                             "i.e. 10%%)")
+    parser.add_argument("--alpha", type=float, default=0.01,
+                        help="the significance level (default 0.01)")
+    args = parser.parse_args()
+
+    baseline_context, baseline = load_run(args.baseline, args.metric)
+    contender_context, contender = load_run(args.contender, args.metric)
+
+    compare_context(baseline_context, contender_context)
+
+    names = [n for n in baseline if n in contender]
+    width = max([len(n) for n in names] + [len("Benchmark")])
+
+    print(f"{'Benchmark':<{width}}  {'Baseline':>12}  {'Contender':>12}  "
+          f"{'Change':>8}  {'p-value':>8}  Verdict")
+
+    slower = []
+    for name in names:
+        a, b = baseline[name], contender[name]
+        before, after = median(a), median(b)
+        change = (after - before) / before if before > 0 else 0.0
+
+        if len(a) < MIN_SAMPLES or len(b) < MIN_SAMPLES:
+            p = None
+            verdict = "too few repetitions"
+        else:
+            p = mann_whitney_p(a, b)
+            significant = p < args.alpha
+            if significant and change > args.threshold:
+                verdict = "SLOWER"
+                slower.append(name)
+            elif significant and change < -args.threshold:
+                verdict = "faster"
+            else:
+                verdict = "same"
+
+        p_text = f"{p:8.4f}" if p is not None else f"{'-':>8}"
+        print(f"{name:<{width}}  {format_time(before):>12}  "
+              f"{format_time(after):>12}  {change:+8.1%}  {p_text}  "
+              f"{verdict}")
+
+    for name in sorted(set(baseline) - set(contender)):
+        print(f"{name:<{width}}  missing from the contender")
+    for name in sorted(set(contender) - set(baseline)):
+        print(f"{name:<{width}}  not in the baseline")
+
+    if slower:
+        print(f"\n{len(slower)} benchmark(s) got significantly slower "
+              f"(more than {args.threshold:.0%}, p < {args.alpha})")
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/packed_draft_order.h"
+
+namespace
+{
+    struct win
+    {
+        std::size_t round_index;
+        int winner;
+    };
+
+    // Two rounds of winners per lottery, from any ranking
+    std::vector<win> wins()
+    {
+        std::mt19937 gen{ 2023 };
+        std::uniform_int_distribution ranking{ 1, 16 };
+
+        std::vector<win> ret;
+        for (std::size_t i = 0; i < 1024; ++i)
+        {
+            ret.push_back({ i % 2, ranking(gen) });
+        }
+        return ret;
+    }
+}
+
+static void BM_move_up_rotate(benchmark::State& state)
+{
+    const auto input = wins();
+
+    for (auto _ : state)
+    {
+        std::array<int, 16> draft_order{};
+
+        for (auto const& w : input)
+        {
+            if (w.round_index == 0)
+            {
+                std::iota(draft_order.begin(), draft_order.end(), 1);
+            }
+
+            benchmark::DoNotOptimize(nhl::lottery::detail::move_up(
+                draft_order, w.round_index, w.winner, 10));
+        }
+
+        benchmark::DoNotOptimize(draft_order);
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+        static_cast<std::int64_t>(input.size()));
+}
+BENCHMARK(BM_move_up_rotate);
+
+static void BM_move_up_packed(benchmark::State& state)
+{
+    const auto input = wins();
+
+    for (auto _ : state)
+    {
+        nhl::lottery::packed_draft_order draft_order;
+
+        for (auto const& w : input)
+        {
+            if (w.round_index == 0)
+            {
+                draft_order = {};
+            }
+
+            benchmark::DoNotOptimize(draft_order.move_up(w.round_index,
+                w.winner, 10));
+        }
+
+        benchmark::DoNotOptimize(draft_order);
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+        static_cast<std::int64_t>(input.size()));
+}
+BENCHMARK(BM_move_up_packed);
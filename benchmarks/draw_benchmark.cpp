@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include "nhl/lottery/combination_table.h"
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/machine.h"
+#include "nhl/lottery/rules.h"
+
+template <nhl::lottery::lottery_rules Rules>
+static void BM_run_draw(benchmark::State& state)
+{
+    std::mt19937_64 gen{ 2023 };
+    nhl::lottery::machine machine;
+    nhl::lottery::basic_combination_table<Rules> table;
+    table.populate(gen);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(nhl::lottery::run_draw(table, machine,
+            Rules::rounds, gen));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_run_draw, nhl::lottery::standard_rules);
+BENCHMARK_TEMPLATE(BM_run_draw, nhl::lottery::three_draw_rules);
+
+template <nhl::lottery::lottery_rules Rules>
+static void BM_sample_draw(benchmark::State& state)
+{
+    std::mt19937_64 gen{ 2023 };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(nhl::lottery::sample_draw<Rules>(
+            Rules::rounds, gen));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_sample_draw, nhl::lottery::standard_rules);
+BENCHMARK_TEMPLATE(BM_sample_draw, nhl::lottery::three_draw_rules);
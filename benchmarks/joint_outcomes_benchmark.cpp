@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include "nhl/thread_pool.h"
+#include "nhl/lottery/joint_outcomes.h"
+
+namespace
+{
+    nhl::lottery::joint_outcomes three_draw_outcomes()
+    {
+        using namespace nhl::lottery;
+
+        nhl::thread_pool pool{ 1 };
+
+        auto format = format_of<standard_rules>();
+        format.rounds = 3;
+
+        return { count_outcomes(format, 200'000, 2023, pool), team_count,
+            format.rounds };
+    }
+}
+
+static void BM_joint_probability(benchmark::State& state)
+{
+    using namespace nhl::lottery;
+
+    const auto joint = three_draw_outcomes();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(joint.probability({ pick_between(1, 1, 2),
+            pick_at(2, 3) }));
+    }
+
+    state.counters["outcomes"] = static_cast<double>(joint.size());
+}
+BENCHMARK(BM_joint_probability);
+
+static void BM_conditional_pick_odds(benchmark::State& state)
+{
+    using namespace nhl::lottery;
+
+    const auto joint = three_draw_outcomes();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(joint.conditional_pick_odds(3,
+            { won_round(1, round_number{ 1 }) }));
+    }
+}
+BENCHMARK(BM_conditional_pick_odds);
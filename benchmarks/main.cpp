@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include "nhl/parallel.h"
+#include "nhl/lottery/instrumentation.h"
+
+#ifndef NHL_VERSION
+#define NHL_VERSION "unknown"
+#endif
+
+#ifndef NHL_GIT_COMMIT
+#define NHL_GIT_COMMIT "unknown"
+#endif
+
+namespace
+{
+    // The results always go to a JSON file too (benchmark_results.json
+    // unless --benchmark_out is given), for compare.py
+    std::vector<char*> with_json_output(int argc, char** argv)
+    {
+        static std::string out{ "--benchmark_out=benchmark_results.json" };
+        static std::string format{ "--benchmark_out_format=json" };
+
+        std::vector<char*> ret(argv, argv + argc);
+
+        const auto given = [&](std::string_view flag)
+        {
+            return std::ranges::any_of(ret, [flag](std::string_view arg)
+                {
+                    return arg.starts_with(flag);
+                });
+        };
+
+        if (!given("--benchmark_out="))
+        {
+            ret.push_back(out.data());
+
+            if (!given("--benchmark_out_format="))
+            {
+                ret.push_back(format.data());
+            }
+        }
+
+        return ret;
+    }
+
+    std::string_view compiler()
+    {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " BENCHMARK_STRINGIFY(_MSC_FULL_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+    std::string_view operating_system()
+    {
+#if defined(_WIN32)
+        return "windows";
+#elif defined(__APPLE__)
+        return "macos";
+#elif defined(__linux__)
+        return "linux";
+#else
+        return "unknown";
+#endif
+    }
+
+    // Goes with the machine's own context (host, CPUs, caches, load) so a
+    // baseline says what it was measured with
+    void add_context()
+    {
+        benchmark::AddCustomContext("nhl_version", NHL_VERSION);
+        benchmark::AddCustomContext("nhl_git_commit", NHL_GIT_COMMIT);
+        benchmark::AddCustomContext("compiler", std::string{ compiler() });
+        benchmark::AddCustomContext("cplusplus",
+            std::to_string(__cplusplus));
+        benchmark::AddCustomContext("operating_system",
+            std::string{ operating_system() });
+#ifdef NDEBUG
+        benchmark::AddCustomContext("nhl_build_type", "release");
+#else
+        benchmark::AddCustomContext("nhl_build_type", "debug");
+#endif
+        benchmark::AddCustomContext("nhl_instrumentation",
+            nhl::lottery::instrumentation::enabled ? "on" : "off");
+        benchmark::AddCustomContext("hardware_threads",
+            std::to_string(std::thread::hardware_concurrency()));
+        benchmark::AddCustomContext("simulation_block_size",
+            std::to_string(nhl::simulation_block_size));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    auto args = with_json_output(argc, argv);
+    auto count = static_cast<int>(args.size());
+
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+    {
+        return 1;
+    }
+
+    add_context();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+}
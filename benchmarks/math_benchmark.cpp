@@ -1,28 +1,32 @@
 #include <benchmark/benchmark.h>
 
-#include <array>
+#include <cstddef>
+#include <cstdint>
 #include "nhl/math/cmath.h"
 
+// Every combination of S of N elements, from a few of them up to the 1001
+// lottery combinations (14, 4) and beyond
+template <std::size_t N, std::size_t S>
 static void BM_for_each_combination(benchmark::State& state)
 {
-  std::array set = { 1, 2, 3, 4 };
-  // Perform setup here
-  for (auto _ : state)
-  {
-      int i{ 1 };
-      math::for_each_combination<3,1>([&set,&i](auto const& combo)
-      {
-          //std::cout << std::setw(3) << i << ": ";
+    constexpr auto combinations = math::combination_count<N, S>();
 
-          for (auto const& x : combo)
-          {
-              //std::cout << set[x] << " ";
-          }
-          //std::cout << "\n";
-          ++i;
-      });
-  }
-}
-// Register the function as a benchmark
-BENCHMARK(BM_for_each_combination);
+    for (auto _ : state)
+    {
+        std::size_t sum{ 0 };
+        math::for_each_combination<N, S>([&sum](auto const& combo)
+            {
+                sum += combo[S - 1];
+            });
+        benchmark::DoNotOptimize(sum);
+    }
 
+    state.SetItemsProcessed(state.iterations() *
+        static_cast<std::int64_t>(combinations));
+}
+BENCHMARK_TEMPLATE(BM_for_each_combination, 3, 1);
+BENCHMARK_TEMPLATE(BM_for_each_combination, 4, 2);
+BENCHMARK_TEMPLATE(BM_for_each_combination, 8, 4);
+BENCHMARK_TEMPLATE(BM_for_each_combination, 14, 4);
+BENCHMARK_TEMPLATE(BM_for_each_combination, 16, 8);
+BENCHMARK_TEMPLATE(BM_for_each_combination, 20, 10);
@@ -0,0 +1,8 @@
+# Run by benchmark_compare before the benchmarks, so a missing baseline fails
+# straight away instead of after the whole run
+if (NOT EXISTS "${NHL_BENCHMARK_BASELINE}")
+    message(FATAL_ERROR "There's no benchmark baseline at "
+        "${NHL_BENCHMARK_BASELINE}. Build benchmark_baseline on the "
+        "reference machine, with a release build of Google Benchmark, or "
+        "point NHL_BENCHMARK_BASELINE at one.")
+endif()
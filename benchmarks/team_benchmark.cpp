@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include "nhl/team.h"
+
+namespace
+{
+    // The previous to_team_id: a string compare per team
+    constexpr std::optional<nhl::team_id> to_team_id_linear(
+        std::string_view abbreviation) noexcept
+    {
+        for (std::size_t i = 0; i < nhl::text_literals::team_ids.size(); ++i)
+        {
+            if (nhl::text_literals::team_ids[i] == abbreviation)
+            {
+                return static_cast<nhl::team_id>(i);
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // Every team a few times over, in a scrambled order, like a game log
+    std::vector<std::string_view> abbreviations()
+    {
+        std::vector<std::string_view> ret;
+        for (std::size_t i = 0; i < 1024; ++i)
+        {
+            ret.push_back(nhl::text_literals::team_ids[(i * 7) %
+                nhl::text_literals::team_ids.size()]);
+        }
+        return ret;
+    }
+}
+
+static void BM_to_team_id_linear(benchmark::State& state)
+{
+    const auto input = abbreviations();
+
+    for (auto _ : state)
+    {
+        for (auto const& a : input)
+        {
+            benchmark::DoNotOptimize(to_team_id_linear(a));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+        static_cast<std::int64_t>(input.size()));
+}
+BENCHMARK(BM_to_team_id_linear);
+
+static void BM_to_team_id_perfect_hash(benchmark::State& state)
+{
+    const auto input = abbreviations();
+
+    for (auto _ : state)
+    {
+        for (auto const& a : input)
+        {
+            benchmark::DoNotOptimize(nhl::to_team_id(a));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+        static_cast<std::int64_t>(input.size()));
+}
+BENCHMARK(BM_to_team_id_perfect_hash);
+
+static void BM_lookup(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        for (auto const& t : nhl::teams)
+        {
+            benchmark::DoNotOptimize(nhl::lookup(t.id));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() *
+        static_cast<std::int64_t>(nhl::teams.size()));
+}
+BENCHMARK(BM_lookup);
@@ -1,12 +1,30 @@
 #include <string>
 #include <string_view>
+#include <memory>
 #include <optional>
 #include <thread>
 #include <chrono>
-#include <unordered_set>
+#include <random>
+#include <ranges>
+#include <vector>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <mutex>
 #include <cxxopts.hpp>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#include <nhl/clinch.h>
+#include <nhl/io/loader.h>
 #include <nhl/print.h>
+#include <nhl/progress.h>
+#include <nhl/lottery/backtest.h>
 #include <nhl/lottery/odds.h>
+#include <nhl/lottery/odds_server.h>
 #include <nhl/lottery/lottery.h>
 #include <nhl/lottery/machine.h>
 #include <nhl/lottery/combination.h>
@@ -16,7 +34,22 @@
 #include <nhl/lottery/teams.h>
 #include <nhl/lottery/print.h>
 #include <nhl/lottery/combination_table.h>
+#include <nhl/lottery/draw.h>
+#include <nhl/lottery/export.h>
+#include <nhl/lottery/instrumentation.h>
+#include <nhl/lottery/rules.h>
+#include <nhl/lottery/scenario.h>
+#include <nhl/lottery/season_lottery.h>
+#include <nhl/lottery/sensitivity.h>
+#include <nhl/lottery/shard.h>
+#include <nhl/lottery/stats_cache.h>
+#include <nhl/random.h>
+#include <nhl/schedule.h>
+#include <nhl/season.h>
+#include <nhl/standings.h>
 #include <nhl/team.h>
+#include <nhl/thread_pool.h>
+#include <nhl/what_if.h>
 
 inline constexpr std::string_view app_name{ "nhl_dls" };
 inline constexpr std::string_view app_version{ "1.0" };
@@ -25,6 +58,30 @@ struct app_options
 {
     std::optional<std::size_t> simulations;
     std::optional<std::size_t> rounds;
+    bool season{ false };
+    std::optional<std::size_t> draws;
+    std::optional<std::size_t> threads;
+    std::optional<std::uint64_t> seed;
+    std::optional<std::string> what_if;
+    bool clinch{ false };
+    std::optional<std::string> standings_file;
+    std::optional<std::string> games_file;
+    std::optional<std::string> format;
+    std::optional<std::string> backtest_file;
+    std::optional<std::string> scenarios_file;
+    bool exact{ false };
+    bool joint{ false };
+    bool sensitivity{ false };
+    bool sampled{ false };
+    std::optional<nhl::lottery::export_format> export_format;
+    std::optional<std::string> output_file;
+    std::optional<std::size_t> progress_interval;
+    bool serve{ false };
+    std::optional<std::string> socket_path;
+    std::optional<std::string> cache_dir;
+    std::optional<std::size_t> shard_index;
+    std::optional<std::size_t> shard_count;
+    std::optional<std::vector<std::string>> merge_files;
 
     static constexpr std::size_t min_simulations() { return 1; }
 
@@ -44,10 +101,756 @@ struct app_options
             std::cmp_less_equal(rounds, max_rounds());
     }
 
+    static constexpr std::size_t min_draws() { return 1; }
+
+    template <std::integral T>
+    static constexpr bool is_valid_draws(T draws)
+    {
+        return std::cmp_less_equal(min_draws(), draws);
+    }
+
     static constexpr std::size_t default_simulations{ 1 };
     static constexpr std::size_t default_rounds{ 2 };
+    static constexpr std::size_t default_draws{ 1 };
+    static constexpr std::size_t default_batch_draws{ 100'000 };
+
+    // the number of draft orders printed with --joint
+    static constexpr std::size_t joint_rows{ 25 };
+
+    // the combinations moved each way with --sensitivity
+    static constexpr std::size_t sensitivity_step{ 5 };
+
+    // the results kept by --serve
+    static constexpr std::size_t server_cache_entries{ 1024 };
+};
+
+// Prints each step of a draw, pausing between steps so it can be followed
+struct progress_printer : nhl::lottery::draw_observer
+{
+    bool print_individual_drawn_balls{ true };
+
+    void attempt_started(nhl::lottery::round_number round, std::size_t rounds)
+    {
+        temp::println("Running the machine for round {} of {}", round, rounds);
+    }
+
+    void drawing_ball(nhl::lottery::round_number, std::size_t b)
+    {
+        if (print_individual_drawn_balls)
+        {
+            temp::print("    drawing ball {} ", b + 1);
+
+            for (int k = 0; k < 10; ++k)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(150));
+                temp::print("-");
+            }
+            temp::print("> ");
+        }
+    }
+
+    void ball_drawn(nhl::lottery::round_number, std::size_t,
+        nhl::lottery::ball ball)
+    {
+        if (print_individual_drawn_balls)
+        {
+            temp::println("{}", ball);
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+    }
+
+    void combination_drawn(nhl::lottery::round_number,
+        nhl::lottery::combination const& combo, std::optional<int> winner)
+    {
+        if (winner)
+        {
+            temp::println("The combination {} belongs to team {}.", combo,
+                *winner);
+        }
+    }
+
+    void redraw(nhl::lottery::round_number,
+        nhl::lottery::redraw_reason reason,
+        nhl::lottery::combination const& combo)
+    {
+        using enum nhl::lottery::redraw_reason;
+
+        switch (reason)
+        {
+        case unassigned_combination:
+            temp::println("The combination {} requires a redraw.", combo);
+            break;
+        case previous_winner:
+            temp::println("The team is a previous winner. Redraw required");
+            break;
+        case locked_in:
+            temp::println("The team is locked in from a previous round. "
+                "Redraw required");
+            break;
+        }
+    }
+
+    void attempt_finished(nhl::lottery::round_number)
+    {
+        temp::println("");
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+    }
 };
 
+// A reporter for --progress, if it was given. Reset it once the simulations
+// are done so it doesn't print over the results.
+std::unique_ptr<nhl::progress_reporter> start_progress_reporter(
+    app_options const& options, nhl::progress_counters const& progress,
+    std::size_t estimates = 1)
+{
+    if (!options.progress_interval)
+    {
+        return nullptr;
+    }
+
+    return std::make_unique<nhl::progress_reporter>(progress,
+        std::chrono::seconds(*options.progress_interval), estimates);
+}
+
+struct season_data
+{
+    nhl::team_records records;
+    std::vector<nhl::game> games;
+};
+
+// The standings snapshot and its remaining games, unless files were given. A
+// games file provides the remaining games (the games without a score), and
+// the standings too if no standings file was given.
+season_data load_season_data(app_options const& options)
+{
+    season_data ret
+    {
+        nhl::index_by_team(nhl::standings),
+        { nhl::remaining_games.begin(), nhl::remaining_games.end() }
+    };
+
+    try
+    {
+        std::optional<nhl::io::game_log> log;
+
+        if (options.games_file)
+        {
+            log = nhl::io::load_games(*options.games_file);
+            ret.games = std::move(log->remaining);
+        }
+
+        if (options.standings_file)
+        {
+            ret.records = nhl::index_by_team(
+                nhl::io::load_standings(*options.standings_file));
+        }
+        else if (log)
+        {
+            ret.records = nhl::standings_after(log->results);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::cout << "File error: " << e.what() << "\n";
+        std::exit(1);
+    }
+
+    return ret;
+}
+
+// Calls f with the lottery rules of the given name. Only formats with a
+// ranking for every non-playoff team can follow a simulated season.
+template <typename F>
+decltype(auto) with_season_rules(std::string_view name, F&& f)
+{
+    using namespace nhl::lottery;
+
+    if (name == standard_rules::name)
+    {
+        return f(standard_rules{});
+    }
+    else if (name == three_draw_rules::name)
+    {
+        return f(three_draw_rules{});
+    }
+
+    throw std::invalid_argument(fmt::format("Unknown lottery format '{}'",
+        name));
+}
+
+// Simulates the rest of the season from the standings snapshot and runs the
+// lottery on each simulated set of non-playoff teams
+int run_season_lottery(app_options const& options)
+{
+    const auto data = load_season_data(options);
+    const nhl::season_model model{ data.records, data.games };
+
+    nhl::thread_pool pool
+    {
+        options.threads.value_or(nhl::thread_pool::default_thread_count())
+    };
+
+    const nhl::lottery::season_lottery_options season_options
+    {
+        .seasons = *options.simulations,
+        .draws_per_season = options.draws.value_or(app_options::default_draws),
+        .rounds = *options.rounds,
+        .seed = options.seed.value_or(nhl::random_seed())
+    };
+
+    temp::println("Running simulation(s) on {} thread(s) (seed {})...",
+        pool.size(), season_options.seed);
+    temp::println("");
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    const auto stats = with_season_rules(
+        options.format.value_or(std::string{ nhl::lottery::standard_rules::name }),
+        [&]<typename Rules>(Rules)
+        {
+            return nhl::lottery::simulate_season_lottery<Rules>(model,
+                season_options, pool);
+        });
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end - start;
+    temp::println("The simulation(s) took {} seconds to complete", diff.count());
+    temp::println("");
+
+    nhl::lottery::print_draft_pick_stats(stats);
+
+    return 0;
+}
+
+// Parses "WINNER>LOSER[,WINNER>LOSER...]" into conditions on the first
+// remaining game between each pair of teams
+std::vector<nhl::game_condition> parse_what_if(nhl::season_model const& model,
+    std::string_view text)
+{
+    std::vector<nhl::game_condition> ret;
+
+    for (auto const part : text | std::views::split(','))
+    {
+        const std::string_view result{ part.begin(), part.end() };
+        const auto separator = result.find('>');
+
+        const auto winner = nhl::to_team_id(result.substr(0, separator));
+        const auto loser = (separator != std::string_view::npos) ?
+            nhl::to_team_id(result.substr(separator + 1)) : std::nullopt;
+
+        if (!winner || !loser)
+        {
+            throw std::invalid_argument(fmt::format(
+                "Invalid game result '{}'", result));
+        }
+
+        const auto games = model.games();
+        const auto pos = std::ranges::find_if(games, [&](auto const& g)
+            {
+                return (g.home == *winner && g.visitor == *loser) ||
+                    (g.home == *loser && g.visitor == *winner);
+            });
+
+        if (pos == games.end())
+        {
+            throw std::invalid_argument(fmt::format(
+                "No remaining game between {} and {}", to_string(*winner),
+                to_string(*loser)));
+        }
+
+        ret.push_back(nhl::fix_winner(model,
+            static_cast<std::size_t>(pos - games.begin()), *winner));
+    }
+
+    return ret;
+}
+
+// Compares the playoff odds with and without the given results
+int run_what_if(app_options const& options)
+{
+    const auto data = load_season_data(options);
+    const nhl::season_model model{ data.records, data.games };
+
+    const auto conditions = parse_what_if(model, *options.what_if);
+
+    nhl::thread_pool pool
+    {
+        options.threads.value_or(nhl::thread_pool::default_thread_count())
+    };
+
+    const auto seed = options.seed.value_or(nhl::random_seed());
+
+    temp::println("Running simulation(s) on {} thread(s) (seed {})...",
+        pool.size(), seed);
+    temp::println("");
+
+    nhl::what_if_engine engine{ model, *options.simulations, seed, pool };
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    const auto base = engine.query({});
+    const auto what_if = engine.query(conditions);
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end - start;
+    temp::println("The queries took {} seconds to complete ({} of {} samples "
+        "matched{})", diff.count(), what_if.samples, engine.samples().size(),
+        what_if.resampled ? ", resampled" : "");
+    temp::println("");
+
+    temp::println("[ Playoff Odds - {} ]", *options.what_if);
+    temp::println("");
+    temp::println("{:^4} {:^6} {:^6} {:^7}", "Team", "Base", "What-if",
+        "Change");
+    temp::println("{:^4} {:^6} {:^6} {:^7}", "----", "------", "-------",
+        "-------");
+
+    for (std::size_t t = 0; t < nhl::team_count; ++t)
+    {
+        const auto change = what_if.playoff_odds[t] - base.playoff_odds[t];
+
+        if (std::abs(change) >= 0.0005)
+        {
+            temp::println("{:^4} {:^6.3f} {:^7.3f} {:^+7.3f}",
+                to_string(static_cast<nhl::team_id>(t)), base.playoff_odds[t],
+                what_if.playoff_odds[t], change);
+        }
+    }
+
+    return 0;
+}
+
+// Prints which teams have clinched a playoff spot or been eliminated
+int run_clinch(app_options const& options)
+{
+    const auto data = load_season_data(options);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    const nhl::clinch_calculator calc{ data.records, data.games };
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end - start;
+    temp::println("The computation took {} seconds to complete", diff.count());
+    temp::println("");
+
+    for (auto const& d : nhl::divisions::all)
+    {
+        auto teams = d.teams;
+        std::ranges::sort(teams, [&calc](nhl::team_id lhs, nhl::team_id rhs)
+            {
+                return nhl::ranks_ahead(
+                    calc.records()[static_cast<std::size_t>(lhs)],
+                    calc.records()[static_cast<std::size_t>(rhs)]);
+            });
+
+        temp::println("[ {} ]", to_string(d.id));
+        temp::println("");
+        temp::println("{:^4} {:^3} {:^3} {:^6} {:^5}", "Team", "PTS", "GP",
+            "Status", "Magic");
+        temp::println("{:^4} {:^3} {:^3} {:^6} {:^5}", "----", "---", "---",
+            "------", "-----");
+
+        for (auto const& t : teams)
+        {
+            auto const& record = calc.records()[static_cast<std::size_t>(t)];
+            auto const& result = calc.result(t);
+
+            temp::println("{:^4} {:^3} {:^3} {:^6} {:^5}", to_string(t),
+                nhl::points(record), record.games_played,
+                to_string(result.status),
+                result.magic_number ?
+                    std::to_string(*result.magic_number) : std::string{ "-" });
+        }
+
+        temp::println("");
+    }
+
+    return 0;
+}
+
+// Replays past lotteries with the rules in force each year and reports how
+// likely the actual results were
+int run_backtest(app_options const& options)
+{
+    std::vector<nhl::lottery::lottery_year> years;
+
+    try
+    {
+        years = nhl::lottery::load_lottery_history(*options.backtest_file);
+    }
+    catch (std::exception const& e)
+    {
+        std::cout << "File error: " << e.what() << "\n";
+        std::exit(1);
+    }
+
+    nhl::thread_pool pool
+    {
+        options.threads.value_or(nhl::thread_pool::default_thread_count())
+    };
+
+    const auto draws = options.simulations.value_or(
+        app_options::default_batch_draws);
+    const auto seed = options.seed.value_or(nhl::random_seed());
+
+    temp::println("Running {} draw(s) for each of {} year(s) on {} thread(s) "
+        "(seed {})...", draws, years.size(), pool.size(), seed);
+    temp::println("");
+
+    nhl::progress_counters progress{ draws * years.size(), pool.size() };
+    auto reporter = start_progress_reporter(options, progress,
+        years.size());
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    const auto results = nhl::lottery::run_backtest(years, draws, seed, pool,
+        &progress);
+    reporter.reset();
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end - start;
+    temp::println("The simulation(s) took {} seconds to complete", diff.count());
+    temp::println("");
+
+    for (std::size_t y = 0; y < years.size(); ++y)
+    {
+        auto const& year = years[y];
+        auto const& result = results[y];
+
+        temp::println("[ {} - {} draw(s), {} team(s) ]", year.year,
+            year.format.rounds, year.format.team_count());
+        temp::println("");
+        temp::println("{:^4} {:^4} {:^6} {:^8} {:^6}", "Rank", "Team",
+            "1st", "Expected", "Actual");
+        temp::println("{:^4} {:^4} {:^6} {:^8} {:^6}", "----", "----",
+            "------", "--------", "------");
+
+        for (std::size_t r = 0; r < year.teams.size(); ++r)
+        {
+            const auto ranking = static_cast<int>(r + 1);
+            const auto actual = std::ranges::find(year.draft_order, ranking) -
+                year.draft_order.begin() + 1;
+
+            temp::println("{:^4} {:^4} {:^6.3f} {:^8.2f} {:^6}", ranking,
+                to_string(year.teams[r]), result.pick_probability(ranking, 1),
+                result.expected_pick(ranking), actual);
+        }
+
+        temp::println("");
+        temp::println("Probability of the actual draft order: {:.5f}",
+            result.actual_probability());
+        temp::println("");
+    }
+
+    if constexpr (nhl::lottery::instrumentation::enabled)
+    {
+        temp::println("");
+        nhl::lottery::instrumentation::print_breakdown();
+    }
+
+    return 0;
+}
+
+// Draws every scenario in the file (or computes its exact odds) and prints
+// one block per scenario
+int run_scenarios(app_options const& options)
+{
+    std::vector<nhl::lottery::scenario> scenarios;
+
+    try
+    {
+        scenarios = nhl::lottery::load_scenarios(*options.scenarios_file);
+    }
+    catch (std::exception const& e)
+    {
+        std::cout << "File error: " << e.what() << "\n";
+        std::exit(1);
+    }
+
+    if (options.exact)
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        const auto odds = nhl::lottery::exact_scenario_odds(scenarios);
+
+        const auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> diff = end - start;
+        temp::println("The exact odds of {} scenario(s) took {} seconds to "
+            "compute", scenarios.size(), diff.count());
+        temp::println("");
+
+        for (std::size_t s = 0; s < scenarios.size(); ++s)
+        {
+            nhl::lottery::print_scenario_result(scenarios[s], odds[s]);
+        }
+
+        return 0;
+    }
+
+    nhl::thread_pool pool
+    {
+        options.threads.value_or(nhl::thread_pool::default_thread_count())
+    };
+
+    const auto draws = options.simulations.value_or(
+        app_options::default_batch_draws);
+    const auto seed = options.seed.value_or(nhl::random_seed());
+
+    temp::println("Running {} draw(s) for each of {} scenario(s) on {} "
+        "thread(s) (seed {})...", draws, scenarios.size(), pool.size(), seed);
+    temp::println("");
+
+    nhl::progress_counters progress{ draws * scenarios.size(),
+        pool.size() };
+    auto reporter = start_progress_reporter(options, progress,
+        scenarios.size());
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    const auto results = nhl::lottery::run_scenarios(scenarios, draws, seed,
+        pool, &progress);
+    reporter.reset();
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end - start;
+    temp::println("The simulation(s) took {} seconds to complete", diff.count());
+    temp::println("");
+
+    for (std::size_t s = 0; s < scenarios.size(); ++s)
+    {
+        nhl::lottery::print_scenario_result(scenarios[s], results[s]);
+    }
+
+    if constexpr (nhl::lottery::instrumentation::enabled)
+    {
+        temp::println("");
+        nhl::lottery::instrumentation::print_breakdown();
+    }
+
+    return 0;
+}
+
+// Measures how the standard format's odds respond to the combinations of
+// each ranking, with every perturbed format drawn from the same random
+// numbers
+int run_sensitivity(app_options const& options)
+{
+    nhl::thread_pool pool
+    {
+        options.threads.value_or(nhl::thread_pool::default_thread_count())
+    };
+
+    auto format = nhl::lottery::format_of<nhl::lottery::standard_rules>();
+    format.rounds = options.rounds.value_or(app_options::default_rounds);
+
+    const auto draws = options.simulations.value_or(
+        app_options::default_batch_draws);
+    const auto seed = options.seed.value_or(nhl::random_seed());
+
+    temp::println("Running {} draw(s) of {} format(s) on {} thread(s) "
+        "(seed {})...", draws, 2 * format.team_count() + 1, pool.size(),
+        seed);
+    temp::println("");
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    const auto sensitivity = nhl::lottery::run_odds_sensitivity(format,
+        draws, app_options::sensitivity_step, seed, pool);
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> diff = end - start;
+    temp::println("The simulation(s) took {} seconds to complete", diff.count());
+    temp::println("");
+
+    for (int ranking = 1;
+        ranking <= static_cast<int>(format.team_count()); ++ranking)
+    {
+        nhl::lottery::print_odds_sensitivity(sensitivity, ranking);
+    }
+
+    return 0;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// A thread per connection. Simulations are answered from the server's
+// thread, so each connection writes under its own lock, and it's closed once
+// the client has hung up and every query it sent has been answered.
+int serve_socket(nhl::lottery::odds_server& server, std::string const& path)
+{
+    struct connection
+    {
+        explicit connection(int fd) : fd{ fd } {}
+
+        connection(connection const&) = delete;
+        connection& operator=(connection const&) = delete;
+
+        ~connection()
+        {
+            ::close(fd);
+        }
+
+        // a client that has gone away just loses the response
+        void write(std::string_view response)
+        {
+#if defined(MSG_NOSIGNAL)
+            constexpr int flags{ MSG_NOSIGNAL };
+#else
+            constexpr int flags{ 0 };
+#endif
+            const std::string line = std::string{ response } + "\n";
+
+            const std::scoped_lock lock{ mutex };
+            for (std::size_t sent = 0; sent < line.size();)
+            {
+                const auto n = ::send(fd, line.data() + sent,
+                    line.size() - sent, flags);
+                if (n <= 0)
+                {
+                    return;
+                }
+                sent += static_cast<std::size_t>(n);
+            }
+        }
+
+        int fd;
+        std::mutex mutex;
+    };
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        std::cout << "Socket error: the path is too long\n";
+        return 1;
+    }
+    std::ranges::copy(path, address.sun_path);
+
+    // only a socket left by an earlier run is replaced
+    struct stat existing{};
+    if (::lstat(path.c_str(), &existing) == 0)
+    {
+        if (!S_ISSOCK(existing.st_mode))
+        {
+            std::cout << "Socket error: " << path << " exists and isn't a "
+                "socket\n";
+            return 1;
+        }
+        ::unlink(path.c_str());
+    }
+
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listener < 0 || ::bind(listener,
+        reinterpret_cast<sockaddr const*>(&address), sizeof(address)) != 0 ||
+        ::listen(listener, SOMAXCONN) != 0)
+    {
+        std::cout << "Socket error: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    temp::println("Listening on {}", path);
+
+    while (true)
+    {
+        const int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+
+            // out of descriptors or memory: wait for connections to close
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS ||
+                errno == ENOMEM)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds{ 100 });
+                continue;
+            }
+
+            std::cout << "Socket error: " << std::strerror(errno) << "\n";
+            ::close(listener);
+            return 1;
+        }
+
+        std::thread([&server, c = std::make_shared<connection>(fd)]()
+        {
+            std::string buffer;
+            std::array<char, 4096> chunk;
+
+            for (auto n = ::recv(c->fd, chunk.data(), chunk.size(), 0); n > 0;
+                n = ::recv(c->fd, chunk.data(), chunk.size(), 0))
+            {
+                buffer.append(chunk.data(), static_cast<std::size_t>(n));
+
+                for (auto pos = buffer.find('\n'); pos != std::string::npos;
+                    pos = buffer.find('\n'))
+                {
+                    const auto line = buffer.substr(0, pos);
+                    buffer.erase(0, pos + 1);
+
+                    if (!line.empty())
+                    {
+                        server.handle(line, [c](std::string_view response)
+                        {
+                            c->write(response);
+                        });
+                    }
+                }
+            }
+        }).detach();
+    }
+}
+#endif
+
+// Keeps the thread pool and the recent results between queries (see
+// nhl::lottery::odds_server for the protocol)
+int run_server(app_options const& options)
+{
+    nhl::thread_pool pool
+    {
+        options.threads.value_or(nhl::thread_pool::default_thread_count())
+    };
+
+    nhl::lottery::odds_server server{ pool,
+        app_options::server_cache_entries };
+
+    if (options.socket_path)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        return serve_socket(server, *options.socket_path);
+#else
+        std::cout << "Unix sockets aren't supported on this platform\n";
+        return 1;
+#endif
+    }
+
+    std::mutex output;
+    const auto respond = [&output](std::string_view response)
+    {
+        const std::scoped_lock lock{ output };
+        std::cout << response << std::endl;
+    };
+
+    for (std::string line; std::getline(std::cin, line);)
+    {
+        if (line == "quit")
+        {
+            break;
+        }
+
+        if (!line.empty())
+        {
+            server.handle(line, respond);
+        }
+    }
+
+    server.wait();
+    return 0;
+}
+
 int main(int argc, char* argv[])
 {
     app_options options;
@@ -62,6 +865,64 @@ int main(int argc, char* argv[])
                 cxxopts::value<std::size_t>())
             ("r,rounds", "The number of lottery rounds per simulation",
                 cxxopts::value<std::size_t>())
+            ("season", "Simulate the rest of the regular season before each "
+                "lottery (each simulation is one season)")
+            ("d,draws", "The number of lotteries per simulated season",
+                cxxopts::value<std::size_t>())
+            ("t,threads", "The number of worker threads",
+                cxxopts::value<std::size_t>())
+            ("seed", "The random seed", cxxopts::value<std::uint64_t>())
+            ("w,what-if", "Compare the playoff odds with the given results "
+                "fixed (i.e. TOR>BOS,NYR>TBL)", cxxopts::value<std::string>())
+            ("c,clinch", "Print the teams that have clinched a playoff spot "
+                "or been eliminated, with their magic numbers")
+            ("standings", "Load the standings from a CSV or JSON file",
+                cxxopts::value<std::string>())
+            ("games", "Load the games from a CSV or JSON file (games without "
+                "a score are the remaining games)",
+                cxxopts::value<std::string>())
+            ("f,format", "The lottery format to use with --season (standard "
+                "or three-draw)", cxxopts::value<std::string>())
+            ("backtest", "Replay the past lotteries in a CSV or JSON file "
+                "(one record per team per year); --simulations sets the "
+                "draws per year (default 100000)",
+                cxxopts::value<std::string>())
+            ("scenarios", "Draw every lottery ordering in a CSV or JSON file "
+                "(one record per team per scenario); --simulations sets the "
+                "draws per scenario (default 100000)",
+                cxxopts::value<std::string>())
+            ("exact", "With --scenarios, compute the exact odds instead of "
+                "running draws")
+            ("joint", "Count every complete draft order and print the most "
+                "frequent ones")
+            ("sensitivity", "Print how each pick probability changes with "
+                "the combinations of each ranking; --simulations sets the "
+                "draws (default 100000)")
+            ("sampled", "Draw each round's winner straight from the rankings "
+                "that can win it, with the redraws counted but never drawn")
+            ("export", "Write the lottery stats as csv, json or binary "
+                "instead of printing the tables",
+                cxxopts::value<std::string>())
+            ("o,output", "The file for --export (default stdout)",
+                cxxopts::value<std::string>())
+            ("progress", "Print the progress every N seconds while "
+                "simulating", cxxopts::value<std::size_t>())
+            ("serve", "Answer odds queries, one per line, from stdin until "
+                "it ends or a line is 'quit'")
+            ("socket", "With --serve, answer the queries of every "
+                "connection to a Unix socket at the given path instead",
+                cxxopts::value<std::string>())
+            ("cache", "With --seed, reuse the lottery stats saved in the "
+                "given directory by an earlier run with the same options, or "
+                "save them there", cxxopts::value<std::string>())
+            ("shard-index", "With --shard-count, the part of the simulations "
+                "to run (0 to the count - 1)", cxxopts::value<std::size_t>())
+            ("shard-count", "Split the simulations into this many parts and "
+                "run only one of them, writing its stats to --output for "
+                "--merge (needs --seed)", cxxopts::value<std::size_t>())
+            ("merge", "Add up the shard files written by --shard-count "
+                "(i.e. a.nhld,b.nhld) and print or --export the stats",
+                cxxopts::value<std::vector<std::string>>())
             ("v,version", "Print the version number and exit")
             ("h,help", "Print the usage information and exit")
         ;
@@ -104,6 +965,159 @@ int main(int argc, char* argv[])
                 throw std::out_of_range("Invalid value for rounds");
             }
         }
+
+        options.season = result.count("season") > 0;
+
+        if (result.count("format"))
+        {
+            options.format = result["format"].as<std::string>();
+
+            // the format's number of draws, unless told otherwise
+            const auto rounds = with_season_rules(*options.format,
+                []<typename Rules>(Rules) { return Rules::rounds; });
+
+            if (!options.rounds)
+            {
+                options.rounds = rounds;
+            }
+        }
+
+        if (result.count("draws"))
+        {
+            if (auto d = result["draws"].as<std::size_t>();
+                app_options::is_valid_draws(d))
+            {
+                options.draws = d;
+            }
+            else
+            {
+                throw std::out_of_range("Invalid value for draws");
+            }
+        }
+
+        if (result.count("threads"))
+        {
+            options.threads = result["threads"].as<std::size_t>();
+        }
+
+        if (result.count("seed"))
+        {
+            options.seed = result["seed"].as<std::uint64_t>();
+        }
+
+        if (result.count("what-if"))
+        {
+            options.what_if = result["what-if"].as<std::string>();
+        }
+
+        options.clinch = result.count("clinch") > 0;
+
+        if (result.count("standings"))
+        {
+            options.standings_file = result["standings"].as<std::string>();
+        }
+
+        if (result.count("games"))
+        {
+            options.games_file = result["games"].as<std::string>();
+        }
+
+        if (result.count("backtest"))
+        {
+            options.backtest_file = result["backtest"].as<std::string>();
+        }
+
+        if (result.count("scenarios"))
+        {
+            options.scenarios_file = result["scenarios"].as<std::string>();
+        }
+
+        options.exact = result.count("exact") > 0;
+        options.joint = result.count("joint") > 0;
+        options.sensitivity = result.count("sensitivity") > 0;
+        options.sampled = result.count("sampled") > 0;
+
+        if (result.count("export"))
+        {
+            options.export_format = nhl::lottery::parse_export_format(
+                result["export"].as<std::string>());
+
+            if (!options.export_format)
+            {
+                throw std::out_of_range("Invalid value for export");
+            }
+        }
+
+        if (result.count("output"))
+        {
+            options.output_file = result["output"].as<std::string>();
+        }
+
+        options.serve = result.count("serve") > 0;
+
+        if (result.count("socket"))
+        {
+            options.socket_path = result["socket"].as<std::string>();
+        }
+
+        if (result.count("cache"))
+        {
+            options.cache_dir = result["cache"].as<std::string>();
+        }
+
+        if (result.count("shard-index"))
+        {
+            options.shard_index = result["shard-index"].as<std::size_t>();
+        }
+
+        if (result.count("shard-count"))
+        {
+            options.shard_count = result["shard-count"].as<std::size_t>();
+
+            if (*options.shard_count < 1 ||
+                options.shard_index.value_or(0) >= *options.shard_count)
+            {
+                throw std::out_of_range("Invalid value for shard-index");
+            }
+
+            // every shard has to draw from the same streams, and only the
+            // stats file can be merged
+            if (!options.seed || !options.output_file ||
+                options.export_format || options.joint)
+            {
+                throw std::invalid_argument("--shard-count needs --seed and "
+                    "--output, without --export or --joint");
+            }
+        }
+        else if (options.shard_index)
+        {
+            throw std::invalid_argument("--shard-index needs --shard-count");
+        }
+
+        if (result.count("merge"))
+        {
+            options.merge_files =
+                result["merge"].as<std::vector<std::string>>();
+
+            // shard files don't keep the draft orders
+            if (options.joint)
+            {
+                throw std::invalid_argument("--merge can't be used with "
+                    "--joint");
+            }
+        }
+
+        if (result.count("progress"))
+        {
+            if (auto p = result["progress"].as<std::size_t>(); p > 0)
+            {
+                options.progress_interval = p;
+            }
+            else
+            {
+                throw std::out_of_range("Invalid value for progress");
+            }
+        }
     }
     catch (std::exception const& e)
     {
@@ -112,6 +1126,39 @@ int main(int argc, char* argv[])
         std::exit(1);
     }
 
+    if (options.serve)
+    {
+        return run_server(options);
+    }
+
+    if (options.clinch)
+    {
+        return run_clinch(options);
+    }
+
+    if (options.backtest_file)
+    {
+        return run_backtest(options);
+    }
+
+    if (options.scenarios_file)
+    {
+        return run_scenarios(options);
+    }
+
+    if (options.sensitivity)
+    {
+        return run_sensitivity(options);
+    }
+
+    // the merged shards have their own simulations and rounds
+    if (options.merge_files)
+    {
+        options.simulations = options.simulations.value_or(
+            app_options::default_simulations);
+        options.rounds = options.rounds.value_or(app_options::default_rounds);
+    }
+
     // if at least one cli arg was used, set the defaults so it can run without
     // user interaction
     if (options.simulations && !options.rounds)
@@ -192,6 +1239,16 @@ int main(int argc, char* argv[])
         }
     }
 
+    if (options.what_if)
+    {
+        return run_what_if(options);
+    }
+
+    if (options.season)
+    {
+        return run_season_lottery(options);
+    }
+
     // Change the following variables
     const bool print_progress{ false };
     const bool print_individual_drawn_balls{ true };
@@ -202,6 +1259,11 @@ int main(int argc, char* argv[])
         .rounds = static_cast<std::size_t>(*options.rounds)
     };
 
+    if (options.joint)
+    {
+        stats.draft_orders.emplace();
+    }
+
     stats.lottery_teams = nhl::lottery::lottery_teams
     {
         // 2023 final standings
@@ -226,173 +1288,214 @@ int main(int argc, char* argv[])
         }
     };
 
-    temp::println("Running simulation(s)...");
-    temp::println("");
+    // the tables and progress would be mixed into an export to stdout
+    const bool print_tables{ !options.export_format || options.output_file };
 
-    const auto start = std::chrono::high_resolution_clock::now();
+    const auto seed = options.seed.value_or(nhl::random_seed());
+    const auto method = options.sampled ?
+        nhl::lottery::draw_method::sampled : nhl::lottery::draw_method::draw;
+    const nhl::lottery::shard shard{ options.shard_index.value_or(0),
+        options.shard_count.value_or(1) };
 
-    for (std::size_t sim = 0; sim < stats.simulations; ++sim)
+    const nhl::lottery::stats_key key{
+        nhl::lottery::format_for(*stats.lottery_teams, stats.rounds),
+        stats.lottery_teams, stats.simulations, seed, to_string(method) };
+
+    if (print_tables && !options.merge_files)
     {
-        if (print_progress)
-        {
-            temp::println("[ NHL Lottery Draft - Simulation {} of {} ]",
-                sim + 1, stats.simulations);
-            temp::println("");
-        }
+        temp::println("Running simulation(s)...");
+        temp::println("");
+    }
 
-        nhl::lottery::machine machine;
-        nhl::lottery::combination_table combinations;
-        combinations.populate();
+    nhl::thread_pool pool
+    {
+        options.threads.value_or(nhl::thread_pool::default_thread_count())
+    };
 
-        auto draft_order = nhl::lottery::rankings;
+    // the reporter would also be mixed into an export to stdout
+    nhl::progress_counters progress{ shard.simulations(stats.simulations),
+        pool.size() };
+    auto reporter = (print_tables && !options.merge_files) ?
+        start_progress_reporter(options, progress) : nullptr;
 
-        std::unordered_set<int> winners;
+    const auto start = std::chrono::high_resolution_clock::now();
 
-        for (nhl::lottery::round_number round{ 1 }; round <=
-            nhl::lottery::round_number{ static_cast<int>(stats.rounds) };)
+    // the blocks are drawn with their own random streams (see shard), so
+    // the same seed always draws the same lotteries
+    const auto simulate = [&]()
+    {
+        if (!print_progress)
         {
-            if (print_progress)
-            {
-                temp::println("Running the machine for round {} of {}",
-                    round, stats.rounds);
-            }
-        
-            machine.load_balls(std::span{ nhl::lottery::balls });
-
-            std::array<nhl::lottery::ball,
-                nhl::lottery::balls_to_draw> drawn_balls;
-
-            for (std::size_t b = 0; b < nhl::lottery::balls_to_draw; ++b)
-            {
-                if (print_progress && print_individual_drawn_balls)
-                {
-                    temp::print("    drawing ball {} ", b + 1);
-
-                    for (int k = 0; k < 10; ++k)
-                    {
-                        std::this_thread::sleep_for(
-                            std::chrono::milliseconds(150));
-                        temp::print("-");
-                    }
-                    temp::print("> ");
-                }
+            return nhl::lottery::simulate_stats(stats, seed, method, pool,
+                shard, &progress);
+        }
 
-                const auto ball = machine.draw_ball();
-                drawn_balls[b] = ball;
+        // one draw at a time, in order, on this thread
+        auto ret = stats;
+        ret.simulations = 0;
 
-                if (print_progress && print_individual_drawn_balls)
-                {
-                    temp::println("{}", ball);
-                    std::this_thread::sleep_for(std::chrono::seconds(1));
-                }
-            }
+        nhl::lottery::machine machine;
+        nhl::lottery::combination_table combinations;
 
-            nhl::lottery::combination combo{ drawn_balls };
+        const auto [first, last] = shard.blocks(stats.simulations);
+        for (auto block = first; block < last; ++block)
+        {
+            auto gen = nhl::make_random_engine(seed, block);
+            const auto range = nhl::block_at(stats.simulations, block);
 
-            if (const auto winner = combinations.lookup(to_value(combo)))
+            for (auto sim = range.first; sim < range.last; ++sim)
             {
-                if (print_progress)
-                {
-                    temp::println("The combination {} belongs to team {}.",
-                        combo, *winner);
-                }
-
-                auto remaining_draft_order = draft_order | std::views::drop(
-                    static_cast<int>(round) - 1);
+                temp::println("[ NHL Lottery Draft - Simulation {} of {} ]",
+                    sim + 1, stats.simulations);
+                temp::println("");
 
-                if (winners.contains(*winner))
+                if (method == nhl::lottery::draw_method::sampled)
                 {
-                    stats.redraws[round]++;
+                    const auto result = nhl::lottery::sample_draw<
+                        nhl::lottery::standard_rules>(stats.rounds, gen);
 
-                    if (print_progress)
-                    {
-                        temp::println("{} is a previous winner. Redraw required",
-                            *winner);
-                    }
+                    nhl::lottery::record(ret, result);
+                    nhl::lottery::print_draft_order(result.draft_order);
+                    continue;
                 }
-                else if (auto pos = std::ranges::find(remaining_draft_order,
-                    winner); pos != std::ranges::end(remaining_draft_order))
-                {
-                    const auto top_ranking = static_cast<int>(round);
 
-                    const auto adjusted_ranking =
-                        (winner <= nhl::lottery::max_ranking_jump) ?
-                        top_ranking :
-                        std::max(*winner - nhl::lottery::max_ranking_jump,
-                            top_ranking);
+                combinations.populate(gen);
 
-                    const auto places_from_top = adjusted_ranking - top_ranking;
+                const auto result = nhl::lottery::run_draw(combinations,
+                    machine, stats.rounds, gen, progress_printer{
+                        .print_individual_drawn_balls =
+                            print_individual_drawn_balls });
 
-                    // Reference:
-                    // https://stackoverflow.com/questions/26176001/c-easiest-most-efficient-way-to-move-a-single-element-to-a-new-position-within
-
-                    std::ranges::rotate(
-                        remaining_draft_order.begin() + places_from_top,
-                        pos,
-                        pos + 1
-                    );
+                nhl::lottery::record(ret, result);
+                nhl::lottery::print_draft_order(result.draft_order);
+            }
 
-                    winners.insert(*winner);
-                    stats.round_winner_stats[round][*winner]++;
+            ret.simulations += range.size();
+            progress.add(0, range.size());
+        }
 
-                    ++round;
-                }
-                else
-                {
-                    stats.redraws[round]++;
+        return ret;
+    };
 
-                    if (print_progress)
-                    {
-                        temp::println("{} is locked in from a previous round. "
-                            "Redraw required", *winner);
-                    }
-                }
+    // only a seeded run can be reused, and the cache doesn't keep the
+    // draft orders counted by --joint or the shard of a run
+    bool cached{ false };
 
-                if (print_progress)
-                {
-                    temp::println("");
-                }
-            }
-            else
+    if (options.merge_files)
+    {
+        try
+        {
+            std::vector<nhl::lottery::shard_file> shards;
+            for (auto const& path : *options.merge_files)
             {
-                stats.redraws[round]++;
-
-                if (print_progress)
-                {
-                    temp::println("The combination {} requires a redraw.",
-                        combo);
-                }
+                shards.push_back(nhl::lottery::load_shard_file(path));
             }
 
-            if (print_progress)
+            stats = nhl::lottery::merge_shards(shards);
+
+            if (print_tables)
             {
+                temp::println("Merged {} shard(s)", shards.size());
                 temp::println("");
-                std::this_thread::sleep_for(std::chrono::seconds(2));
             }
         }
-
-        for (int ranking = 1; auto team : draft_order)
+        catch (std::exception const& e)
         {
-            stats.draft_order_stats[ranking][team]++;
-            ++ranking;
+            std::cout << "Merge error: " << e.what() << "\n";
+            std::exit(1);
         }
+    }
+    else if (options.cache_dir && options.seed && !options.joint &&
+        shard.count == 1)
+    {
+        try
+        {
+            const nhl::lottery::stats_cache cache{ *options.cache_dir };
+
+            auto [result, hit] = cache.load_or_compute(key,
+                stats.lottery_teams, simulate);
 
-        if (std::ranges::is_sorted(draft_order))
+            stats = std::move(result);
+            cached = hit;
+        }
+        catch (std::exception const& e)
         {
-            stats.original_draft_order_retained++;
+            std::cout << "Cache error: " << e.what() << "\n";
+            std::exit(1);
         }
+    }
+    else
+    {
+        stats = simulate();
+    }
 
-        if (print_progress)
+    if (options.shard_count)
+    {
+        try
+        {
+            nhl::lottery::write_shard_file(*options.output_file, key, shard,
+                stats);
+        }
+        catch (std::exception const& e)
         {
-            nhl::lottery::print_draft_order(draft_order);
+            std::cout << "File error: " << e.what() << "\n";
+            std::exit(1);
         }
     }
 
+    reporter.reset();
+
     const auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> diff = end - start;
-    temp::println("The simulation(s) took {} seconds to complete", diff.count());
+
+    if (options.export_format)
+    {
+        try
+        {
+            nhl::lottery::export_stats(stats, *options.export_format,
+                options.output_file.value_or(""));
+        }
+        catch (std::exception const& e)
+        {
+            std::cout << "File error: " << e.what() << "\n";
+            std::exit(1);
+        }
+    }
+
+    if (!print_tables)
+    {
+        return 0;
+    }
+
+    if (cached)
+    {
+        temp::println("Loaded the simulation(s) from the cache in {} seconds",
+            diff.count());
+    }
+    else if (options.merge_files)
+    {
+        temp::println("The merge took {} seconds to complete", diff.count());
+    }
+    else
+    {
+        temp::println("The simulation(s) took {} seconds to complete",
+            diff.count());
+    }
     temp::println("");
 
     nhl::lottery::print_round_winner_stats(stats);
     nhl::lottery::print_draft_order_lottery_stats(stats);
+
+    if (options.joint)
+    {
+        temp::println("");
+        nhl::lottery::print_draft_order_frequencies(stats,
+            app_options::joint_rows);
+    }
+
+    if constexpr (nhl::lottery::instrumentation::enabled)
+    {
+        temp::println("");
+        nhl::lottery::instrumentation::print_breakdown();
+    }
 }
@@ -0,0 +1,618 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include "nhl/conference.h"
+#include "nhl/division.h"
+#include "nhl/game.h"
+#include "nhl/league.h"
+#include "nhl/math/max_flow.h"
+#include "nhl/season.h"
+#include "nhl/standings.h"
+#include "nhl/text_literals.h"
+
+namespace nhl
+{
+    enum class playoff_status
+    {
+        undecided,
+        clinched,
+        eliminated
+    };
+
+    struct playoff_status_values
+    {
+        static constexpr bool ok(playoff_status status) noexcept
+        {
+            return status >= (min)() && status <= (max)();
+        }
+
+        static constexpr playoff_status (min)() noexcept
+        {
+            return playoff_status::undecided;
+        }
+
+        static constexpr playoff_status (max)() noexcept
+        {
+            return playoff_status::eliminated;
+        }
+    };
+
+    inline constexpr std::string_view to_string(playoff_status status)
+    {
+        constexpr std::array<std::string_view, 3> names{ "-", "x", "e" };
+
+        return playoff_status_values::ok(status) ?
+            names[static_cast<std::size_t>(status)] : text_literals::unknown;
+    }
+
+    struct clinch_result
+    {
+        playoff_status status{ playoff_status::undecided };
+
+        // The number of points the team needs from its remaining games to
+        // clinch, regardless of the other results. 0 once clinched, and empty
+        // when the team can't clinch on its own (or is eliminated).
+        std::optional<int> magic_number;
+    };
+
+    namespace detail
+    {
+        // Calls f with each combination of k items until f returns true
+        template <typename T, typename F>
+        bool any_combination(std::span<T const> items, std::size_t k, F f)
+        {
+            if (k > items.size())
+            {
+                return false;
+            }
+
+            std::vector<bool> mask(items.size(), false);
+            std::fill_n(mask.begin(), k, true);
+
+            std::vector<T> combo;
+            combo.reserve(k);
+
+            do
+            {
+                combo.clear();
+                for (std::size_t i = 0; i < items.size(); ++i)
+                {
+                    if (mask[i])
+                    {
+                        combo.push_back(items[i]);
+                    }
+                }
+
+                if (f(std::span<T const>{ combo }))
+                {
+                    return true;
+                }
+
+            } while (std::prev_permutation(mask.begin(), mask.end()));
+
+            return false;
+        }
+    }
+
+    // Decides which teams have clinched a playoff spot or been eliminated,
+    // without enumerating the outcomes of the remaining games.
+    //
+    // A team misses the playoffs when at least 3 teams in its division finish
+    // ahead of it, and enough of the remaining teams in the conference finish
+    // ahead of it to take both wild cards. Each way that can happen is a
+    // small set of teams that must finish ahead, and whether the remaining
+    // games can be played out that way is a max-flow problem: each game
+    // supplies points, and each team can only take the points of its own
+    // games.
+    //
+    // Ties on points count against the team when clinching and in its favour
+    // when eliminating, so both results hold whatever the tie-breakers.
+    class clinch_calculator
+    {
+    public:
+        clinch_calculator(team_records const& records,
+            std::span<game const> games) :
+            records_{ records },
+            games_{ games.begin(), games.end() },
+            played_(games_.size(), false)
+        {
+            for (auto const& g : games_)
+            {
+                if (!team_id_values::ok(g.visitor) ||
+                    !team_id_values::ok(g.home))
+                {
+                    throw std::out_of_range("Invalid team id");
+                }
+
+                if (g.visitor == g.home)
+                {
+                    throw std::invalid_argument(
+                        "A team can't play against itself");
+                }
+
+                ++remaining_[index(g.visitor)][index(g.home)];
+                ++remaining_[index(g.home)][index(g.visitor)];
+                ++games_left_[index(g.visitor)];
+                ++games_left_[index(g.home)];
+            }
+
+            for (std::size_t t = 0; t < team_count; ++t)
+            {
+                results_[t] = compute(static_cast<team_id>(t));
+            }
+        }
+
+        team_records const& records() const noexcept
+        {
+            return records_;
+        }
+
+        std::span<game const> games() const noexcept
+        {
+            return games_;
+        }
+
+        bool played(std::size_t game_index) const
+        {
+            return played_.at(game_index);
+        }
+
+        std::array<clinch_result, team_count> const& results() const noexcept
+        {
+            return results_;
+        }
+
+        clinch_result const& result(team_id id) const
+        {
+            return results_.at(index(id));
+        }
+
+        // Adds the result of one of the remaining games. Clinching and
+        // elimination can't be undone, so only the undecided teams of the
+        // conferences involved are recomputed.
+        void add_result(std::size_t game_index, game_outcome outcome)
+        {
+            if (game_index >= games_.size())
+            {
+                throw std::out_of_range("Invalid game index");
+            }
+
+            if (!game_outcome_values::ok(outcome))
+            {
+                throw std::out_of_range("Invalid game outcome");
+            }
+
+            if (played_[game_index])
+            {
+                throw std::invalid_argument("The game has already been played");
+            }
+
+            auto const& g = games_[game_index];
+
+            played_[game_index] = true;
+            apply(records_, g, outcome);
+
+            --remaining_[index(g.visitor)][index(g.home)];
+            --remaining_[index(g.home)][index(g.visitor)];
+            --games_left_[index(g.visitor)];
+            --games_left_[index(g.home)];
+
+            const std::array affected{ conference_of(g.visitor),
+                conference_of(g.home) };
+
+            for (std::size_t t = 0; t < team_count; ++t)
+            {
+                const auto id = static_cast<team_id>(t);
+
+                if (results_[t].status == playoff_status::undecided &&
+                    std::ranges::find(affected, conference_of(id)) !=
+                    affected.end())
+                {
+                    results_[t] = compute(id);
+                }
+            }
+        }
+
+    private:
+        static constexpr std::size_t index(team_id id) noexcept
+        {
+            return static_cast<std::size_t>(id);
+        }
+
+        int points_of(team_id id) const noexcept
+        {
+            return points(records_[index(id)]);
+        }
+
+        int remaining(team_id lhs, team_id rhs) const noexcept
+        {
+            return remaining_[index(lhs)][index(rhs)];
+        }
+
+        // The other teams in the team's conference, split into the team's
+        // division and the other division
+        struct rivals
+        {
+            std::vector<team_id> division;
+            std::vector<team_id> other_division;
+        };
+
+        static rivals rivals_of(team_id id)
+        {
+            rivals ret;
+
+            const auto own = division_of(id);
+            for (auto const& c : conferences::all)
+            {
+                if (c.id != conference_of(id))
+                {
+                    continue;
+                }
+
+                for (auto const& d : c.divisions)
+                {
+                    for (auto const& t : lookup(d).teams)
+                    {
+                        if (t == id)
+                        {
+                            continue;
+                        }
+
+                        (d == own ? ret.division : ret.other_division)
+                            .push_back(t);
+                    }
+                }
+            }
+
+            return ret;
+        }
+
+        clinch_result compute(team_id id) const
+        {
+            if (!can_miss_playoffs(id, 0))
+            {
+                return { playoff_status::clinched, 0 };
+            }
+
+            if (!can_make_playoffs(id))
+            {
+                return { playoff_status::eliminated, std::nullopt };
+            }
+
+            // more points can only make it harder to finish behind
+            auto hi = 2 * games_left_[index(id)];
+            if (can_miss_playoffs(id, hi))
+            {
+                return { playoff_status::undecided, std::nullopt };
+            }
+
+            int lo{ 0 };
+            while (hi - lo > 1)
+            {
+                const auto mid = lo + (hi - lo) / 2;
+                (can_miss_playoffs(id, mid) ? lo : hi) = mid;
+            }
+
+            return { playoff_status::undecided, hi };
+        }
+
+        // True if the team can finish in a playoff spot. The team wins all of
+        // its remaining games in regulation, and the question is whether the
+        // teams allowed to pass it (per division) can be chosen so that
+        // everyone else stays at or below its points.
+        bool can_make_playoffs(team_id id) const
+        {
+            const auto max_points = points_of(id) +
+                2 * games_left_[index(id)];
+
+            const auto teams = rivals_of(id);
+
+            std::array<bool, team_count> in_conference{};
+            for (auto const* group : { &teams.division, &teams.other_division })
+            {
+                for (auto const& t : *group)
+                {
+                    in_conference[index(t)] = true;
+                }
+            }
+
+            // teams already ahead, and teams that could get ahead
+            struct split
+            {
+                std::size_t ahead{ 0 };
+                std::vector<team_id> candidates;
+            };
+
+            const auto split_group = [&](std::vector<team_id> const& group)
+            {
+                split ret;
+                for (auto const& t : group)
+                {
+                    if (points_of(t) > max_points)
+                    {
+                        ++ret.ahead;
+                        continue;
+                    }
+
+                    int conference_games{ 0 };
+                    for (std::size_t u = 0; u < team_count; ++u)
+                    {
+                        if (in_conference[u])
+                        {
+                            conference_games += remaining_[index(t)][u];
+                        }
+                    }
+
+                    // a team that can't pass even by winning every game
+                    // against the conference can simply win them all
+                    if (points_of(t) + 2 * conference_games > max_points)
+                    {
+                        ret.candidates.push_back(t);
+                    }
+                }
+                return ret;
+            };
+
+            const auto division = split_group(teams.division);
+            const auto other = split_group(teams.other_division);
+
+            const auto check = [&](std::size_t division_limit,
+                std::size_t other_limit)
+            {
+                if (division.ahead > division_limit || other.ahead > other_limit)
+                {
+                    return false;
+                }
+
+                const auto division_passing = (std::min)(
+                    division_limit - division.ahead,
+                    division.candidates.size());
+                const auto other_passing = (std::min)(
+                    other_limit - other.ahead, other.candidates.size());
+
+                return detail::any_combination<team_id>(division.candidates,
+                    division_passing, [&](std::span<team_id const> d)
+                    {
+                        return detail::any_combination<team_id>(
+                            other.candidates, other_passing,
+                            [&](std::span<team_id const> o)
+                            {
+                                std::vector<team_id> held;
+                                for (auto const* group :
+                                    { &division.candidates, &other.candidates })
+                                {
+                                    for (auto const& t : *group)
+                                    {
+                                        if (std::ranges::find(d, t) == d.end() &&
+                                            std::ranges::find(o, t) == o.end())
+                                        {
+                                            held.push_back(t);
+                                        }
+                                    }
+                                }
+
+                                return can_hold_below(held, max_points);
+                            });
+                    });
+            };
+
+            // a top 3 spot in the division
+            if (check(division_playoff_spots - 1, team_count))
+            {
+                return true;
+            }
+
+            // a wild card: the teams passing it from outside its division's
+            // top 3 must leave at least one wild card
+            for (std::size_t extra = 0; extra < wild_card_spots; ++extra)
+            {
+                if (check(division_playoff_spots + extra,
+                    division_playoff_spots + wild_card_spots - 1 - extra))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // True if the games between the teams can be played so that none of
+        // them finishes with more than max_points. Games against anyone else
+        // are lost in regulation.
+        bool can_hold_below(std::span<team_id const> teams, int max_points) const
+        {
+            constexpr std::size_t source{ 0 };
+            constexpr std::size_t sink{ 1 };
+            constexpr std::size_t first_team{ 2 };
+
+            math::max_flow flow{ first_team + teams.size() };
+            math::max_flow::capacity_type games{ 0 };
+
+            for (std::size_t i = 0; i < teams.size(); ++i)
+            {
+                for (std::size_t j = i + 1; j < teams.size(); ++j)
+                {
+                    if (const auto n = remaining(teams[i], teams[j]); n > 0)
+                    {
+                        const auto node = flow.add_node();
+                        flow.add_edge(source, node, n);
+                        flow.add_edge(node, first_team + i, n);
+                        flow.add_edge(node, first_team + j, n);
+                        games += n;
+                    }
+                }
+
+                // regulation wins
+                flow.add_edge(first_team + i, sink,
+                    (max_points - points_of(teams[i])) / 2);
+            }
+
+            return flow.compute(source, sink) == games;
+        }
+
+        // True if the team can miss the playoffs after earning the given
+        // number of points from its remaining games. The team earns them as
+        // cheaply as possible for its opponents: overtime losses first, then
+        // overtime wins.
+        bool can_miss_playoffs(team_id id, int earned) const
+        {
+            const auto target = points_of(id) + earned;
+            const auto overtime_wins = (std::max)(0,
+                earned - games_left_[index(id)]);
+
+            const auto teams = rivals_of(id);
+
+            struct split
+            {
+                std::size_t ahead{ 0 };
+                std::vector<team_id> candidates;
+            };
+
+            const auto split_group = [&](std::vector<team_id> const& group)
+            {
+                split ret;
+                for (auto const& t : group)
+                {
+                    if (points_of(t) >= target)
+                    {
+                        ++ret.ahead;
+                    }
+                    else if (points_of(t) + 2 * games_left_[index(t)] >=
+                        target)
+                    {
+                        ret.candidates.push_back(t);
+                    }
+                }
+                return ret;
+            };
+
+            const auto division = split_group(teams.division);
+            const auto other = split_group(teams.other_division);
+
+            // Missing out means at least 3 division teams ahead, plus enough
+            // teams outside the top 3 of each division to take both wild
+            // cards
+            for (std::size_t extra = 0; extra <= wild_card_spots; ++extra)
+            {
+                const auto division_needed = division_playoff_spots + extra;
+                const auto other_needed = (extra == wild_card_spots) ? 0 :
+                    division_playoff_spots + wild_card_spots - extra;
+
+                const auto division_passing = division_needed -
+                    (std::min)(division_needed, division.ahead);
+                const auto other_passing = other_needed -
+                    (std::min)(other_needed, other.ahead);
+
+                const auto found = detail::any_combination<team_id>(
+                    division.candidates, division_passing,
+                    [&](std::span<team_id const> d)
+                    {
+                        return detail::any_combination<team_id>(
+                            other.candidates, other_passing,
+                            [&](std::span<team_id const> o)
+                            {
+                                std::vector<team_id> passing{ d.begin(),
+                                    d.end() };
+                                passing.insert(passing.end(), o.begin(),
+                                    o.end());
+
+                                return can_all_reach(id, passing, target,
+                                    overtime_wins);
+                            });
+                    });
+
+                if (found)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // True if every one of the teams can finish with at least target
+        // points, while the given team wins overtime_wins of its games (in
+        // overtime). The teams win every game against anyone else in
+        // regulation; games among them (or against the given team) are
+        // decided in overtime so both teams get a point, and the flow decides
+        // who gets the extra point.
+        bool can_all_reach(team_id id, std::span<team_id const> teams,
+            int target, int overtime_wins) const
+        {
+            constexpr std::size_t source{ 0 };
+            constexpr std::size_t sink{ 1 };
+            constexpr std::size_t team_node{ 2 };
+            constexpr std::size_t first_team{ 3 };
+
+            math::max_flow flow{ first_team + teams.size() };
+
+            int games_against_others{ games_left_[index(id)] };
+            for (auto const& t : teams)
+            {
+                games_against_others -= remaining(id, t);
+            }
+
+            // the overtime wins that can't come from games against anyone
+            // else
+            const auto team_demand = (std::max)(0,
+                overtime_wins - games_against_others);
+            math::max_flow::capacity_type demand{ team_demand };
+            flow.add_edge(team_node, sink, team_demand);
+
+            for (std::size_t i = 0; i < teams.size(); ++i)
+            {
+                const auto t = teams[i];
+
+                int shared_games{ remaining(t, id) };
+                for (auto const& u : teams)
+                {
+                    shared_games += remaining(t, u);
+                }
+
+                const auto base = points_of(t) + shared_games +
+                    2 * (games_left_[index(t)] - shared_games);
+
+                for (std::size_t j = i + 1; j < teams.size(); ++j)
+                {
+                    if (const auto n = remaining(t, teams[j]); n > 0)
+                    {
+                        const auto node = flow.add_node();
+                        flow.add_edge(source, node, n);
+                        flow.add_edge(node, first_team + i, n);
+                        flow.add_edge(node, first_team + j, n);
+                    }
+                }
+
+                if (const auto n = remaining(t, id); n > 0)
+                {
+                    const auto node = flow.add_node();
+                    flow.add_edge(source, node, n);
+                    flow.add_edge(node, first_team + i, n);
+                    flow.add_edge(node, team_node, n);
+                }
+
+                const auto needed = (std::max)(0, target - base);
+                flow.add_edge(first_team + i, sink, needed);
+                demand += needed;
+            }
+
+            return flow.compute(source, sink) == demand;
+        }
+
+        team_records records_;
+        std::vector<game> games_;
+        std::vector<bool> played_;
+
+        // [team id][team id] -> games left between the teams
+        std::array<std::array<int, team_count>, team_count> remaining_{};
+        std::array<int, team_count> games_left_{};
+
+        std::array<clinch_result, team_count> results_{};
+    };
+}
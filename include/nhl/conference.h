@@ -56,5 +56,27 @@ namespace nhl
             conference_id::west,
             { division_id::central, division_id::pacific }
         };
+
+        inline constexpr std::array all{ eastern, western };
+        static_assert(all.size() == 2);
+    }
+
+    constexpr conference_id conference_of(division_id id)
+    {
+        for (auto const& c : conferences::all)
+        {
+            if (std::ranges::find(c.divisions, id) !=
+                std::ranges::end(c.divisions))
+            {
+                return c.id;
+            }
+        }
+
+        throw std::out_of_range("Invalid division id");
+    }
+
+    constexpr conference_id conference_of(team_id id)
+    {
+        return conference_of(division_of(id));
     }
 }
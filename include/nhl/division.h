@@ -2,6 +2,8 @@
 
 #include <string_view>
 #include <array>
+#include <algorithm>
+#include <stdexcept>
 #include "nhl/text_literals.h"
 #include "team.h"
 
@@ -48,46 +50,14 @@ namespace nhl
 
     namespace divisions
     {
-        #if 0
-        inline constexpr std::array all =
+        inline constexpr division atlantic
         {
-            division
+            division_id::atlantic,
             {
-                division_id::atlantic,
-                {
-                    team_id::bos, team_id::buf, team_id::det, team_id::fla,
-                    team_id::mtl, team_id::ott, team_id::tbl, team_id::tor
-                }
-            },
-
-            division
-            {
-                division_id::central,
-                {
-                    team_id::ari, team_id::chi, team_id::col, team_id::dal,
-                    team_id::min, team_id::nsh, team_id::stl, team_id::wpg
-                }
-            },
-
-            division
-            {
-                division_id::metropolitan,
-                {
-                    team_id::car, team_id::cbj, team_id::phi, team_id::pit,
-                    team_id::njd, team_id::nyi, team_id::nyr, team_id::wsh
-                }
-            },
-
-            division
-            {
-                division_id::pacific,
-                {
-                    team_id::ana, team_id::cgy, team_id::edm, team_id::lak,
-                    team_id::sea, team_id::sjs, team_id::van, team_id::vgk
-                }
+                team_id::bos, team_id::buf, team_id::det, team_id::fla,
+                team_id::mtl, team_id::ott, team_id::tbl, team_id::tor
             }
         };
-        #endif
 
         inline constexpr division central
         {
@@ -115,5 +85,35 @@ namespace nhl
                 team_id::sea, team_id::sjs, team_id::van, team_id::vgk
             }
         };
+
+        inline constexpr std::array all{ atlantic, central, metropolitan,
+            pacific };
+        static_assert(all.size() == 4);
+#if __cpp_lib_ranges
+        static_assert(std::ranges::is_sorted(all, {}, &division::id));
+#endif
+    }
+
+    constexpr division const& lookup(division_id id)
+    {
+        if (!division_id_values::ok(id))
+        {
+            throw std::out_of_range("Invalid division id");
+        }
+
+        return divisions::all[static_cast<std::size_t>(id)];
+    }
+
+    constexpr division_id division_of(team_id id)
+    {
+        for (auto const& d : divisions::all)
+        {
+            if (std::ranges::find(d.teams, id) != std::ranges::end(d.teams))
+            {
+                return d.id;
+            }
+        }
+
+        throw std::out_of_range("Invalid team id");
     }
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include "team.h"
+#include "team_record.h"
 
 namespace nhl
 {
@@ -9,4 +11,99 @@ namespace nhl
         team_id visitor;
         team_id home;
     };
+
+    enum class game_outcome : std::uint8_t
+    {
+        home_regulation,
+        home_overtime,
+        home_shootout,
+        visitor_regulation,
+        visitor_overtime,
+        visitor_shootout
+    };
+
+    struct game_outcome_values
+    {
+        static constexpr bool ok(game_outcome outcome) noexcept
+        {
+            return outcome >= (min)() && outcome <= (max)();
+        }
+
+        static constexpr game_outcome (min)() noexcept
+        {
+            return game_outcome::home_regulation;
+        }
+
+        static constexpr game_outcome (max)() noexcept
+        {
+            return game_outcome::visitor_shootout;
+        }
+    };
+
+    inline constexpr std::size_t game_outcome_count{ 6 };
+
+    constexpr bool home_win(game_outcome outcome) noexcept
+    {
+        return outcome <= game_outcome::home_shootout;
+    }
+
+    constexpr bool regulation(game_outcome outcome) noexcept
+    {
+        return outcome == game_outcome::home_regulation ||
+            outcome == game_outcome::visitor_regulation;
+    }
+
+    constexpr bool shootout(game_outcome outcome) noexcept
+    {
+        return outcome == game_outcome::home_shootout ||
+            outcome == game_outcome::visitor_shootout;
+    }
+
+    constexpr team_id winner(game const& g, game_outcome outcome) noexcept
+    {
+        return home_win(outcome) ? g.home : g.visitor;
+    }
+
+    constexpr team_id loser(game const& g, game_outcome outcome) noexcept
+    {
+        return home_win(outcome) ? g.visitor : g.home;
+    }
+
+    // A game that has been played
+    struct game_result
+    {
+        nhl::game game;
+        int visitor_goals{ 0 };
+        int home_goals{ 0 };
+        game_outcome outcome{ game_outcome::home_regulation };
+    };
+
+    // Updates the records of both participants. Goals aren't tracked by an
+    // outcome, so goals_for/goals_against are left untouched.
+    constexpr void apply(game_outcome outcome, team_record& winner,
+        team_record& loser) noexcept
+    {
+        ++winner.games_played;
+        ++loser.games_played;
+
+        ++winner.wins;
+
+        if (regulation(outcome))
+        {
+            ++winner.regulation_wins;
+            ++winner.regulation_or_overtime_wins;
+            ++loser.losses;
+        }
+        else if (shootout(outcome))
+        {
+            ++winner.shootout_wins;
+            ++loser.shootout_losses;
+            ++loser.overtime_losses;
+        }
+        else
+        {
+            ++winner.regulation_or_overtime_wins;
+            ++loser.overtime_losses;
+        }
+    }
 }
@@ -0,0 +1,470 @@
+#pragma once
+
+#include <charconv>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <fmt/format.h>
+#include "nhl/game.h"
+#include "nhl/io/mapped_file.h"
+#include "nhl/team.h"
+#include "nhl/team_record.h"
+
+namespace nhl::io
+{
+    // One CSV row or JSON object. The keys and values are views into the
+    // input text, so nothing is copied until a value is converted.
+    class record
+    {
+    public:
+        record(std::span<std::string_view const> keys,
+            std::span<std::string_view const> values, std::size_t line) :
+            keys_{ keys },
+            values_{ values },
+            line_{ line }
+        {
+        }
+
+        std::size_t line() const noexcept
+        {
+            return line_;
+        }
+
+        // Empty values are treated the same as missing ones
+        std::optional<std::string_view> get(std::string_view key) const
+        {
+            const auto n = (std::min)(keys_.size(), values_.size());
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (keys_[i] == key)
+                {
+                    return values_[i].empty() ?
+                        std::nullopt : std::optional{ values_[i] };
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        std::string_view required(std::string_view key) const
+        {
+            if (const auto value = get(key))
+            {
+                return *value;
+            }
+
+            throw error(fmt::format("Missing value for '{}'", key));
+        }
+
+        std::optional<int> get_int(std::string_view key) const
+        {
+            const auto value = get(key);
+            if (!value)
+            {
+                return std::nullopt;
+            }
+
+            int ret{ 0 };
+            const auto last = value->data() + value->size();
+            if (auto [p, ec] = std::from_chars(value->data(), last, ret);
+                ec != std::errc{} || p != last)
+            {
+                throw error(fmt::format("Invalid number '{}' for '{}'",
+                    *value, key));
+            }
+
+            return ret;
+        }
+
+        team_id get_team(std::string_view key) const
+        {
+            const auto value = required(key);
+            if (const auto id = to_team_id(value))
+            {
+                return *id;
+            }
+
+            throw error(fmt::format("Unknown team '{}'", value));
+        }
+
+        std::invalid_argument error(std::string_view message) const
+        {
+            return std::invalid_argument(fmt::format("Line {}: {}", line_,
+                message));
+        }
+
+    private:
+        std::span<std::string_view const> keys_;
+        std::span<std::string_view const> values_;
+        std::size_t line_;
+    };
+
+    namespace detail
+    {
+        constexpr bool is_space(char c) noexcept
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        constexpr std::string_view trim(std::string_view s) noexcept
+        {
+            while (!s.empty() && is_space(s.front()))
+            {
+                s.remove_prefix(1);
+            }
+            while (!s.empty() && is_space(s.back()))
+            {
+                s.remove_suffix(1);
+            }
+            return s;
+        }
+
+        constexpr std::string_view unquote(std::string_view s) noexcept
+        {
+            if (s.size() >= 2 && s.front() == '"' && s.back() == '"')
+            {
+                s = s.substr(1, s.size() - 2);
+            }
+            return s;
+        }
+
+        // Splits a CSV line on commas. Quoted fields may not contain commas.
+        inline void split_csv_line(std::string_view line,
+            std::vector<std::string_view>& fields)
+        {
+            fields.clear();
+
+            while (true)
+            {
+                const auto pos = line.find(',');
+                fields.push_back(unquote(trim(line.substr(0, pos))));
+
+                if (pos == std::string_view::npos)
+                {
+                    break;
+                }
+                line.remove_prefix(pos + 1);
+            }
+        }
+
+        // The first non-blank line names the columns. Blank lines and lines
+        // starting with '#' are skipped.
+        template <typename F>
+        void for_each_csv_record(std::string_view text, F f)
+        {
+            std::vector<std::string_view> keys;
+            std::vector<std::string_view> values;
+
+            std::size_t line_number{ 0 };
+
+            while (!text.empty())
+            {
+                const auto end = text.find('\n');
+                const auto line = trim(text.substr(0, end));
+                text.remove_prefix(end == std::string_view::npos ?
+                    text.size() : end + 1);
+                ++line_number;
+
+                if (line.empty() || line.front() == '#')
+                {
+                    continue;
+                }
+
+                if (keys.empty())
+                {
+                    split_csv_line(line, keys);
+                    continue;
+                }
+
+                split_csv_line(line, values);
+                f(record{ keys, values, line_number });
+            }
+        }
+
+        // A parser for an array of flat objects, where every value is a
+        // string, a number, a boolean or null. That is all the loaders
+        // need, and it lets every key and value be a view into the input.
+        class json_reader
+        {
+        public:
+            explicit json_reader(std::string_view text) :
+                text_{ text }
+            {
+            }
+
+            template <typename F>
+            void for_each_record(F f)
+            {
+                std::vector<std::string_view> keys;
+                std::vector<std::string_view> values;
+
+                expect('[');
+                if (try_consume(']'))
+                {
+                    return;
+                }
+
+                do
+                {
+                    keys.clear();
+                    values.clear();
+
+                    expect('{');
+                    const auto line = line_;
+
+                    if (!try_consume('}'))
+                    {
+                        do
+                        {
+                            keys.push_back(parse_string());
+                            expect(':');
+                            values.push_back(parse_value());
+                        } while (try_consume(','));
+
+                        expect('}');
+                    }
+
+                    f(record{ keys, values, line });
+
+                } while (try_consume(','));
+
+                expect(']');
+
+                skip_space();
+                if (pos_ != text_.size())
+                {
+                    throw error("Unexpected text after the array");
+                }
+            }
+
+        private:
+            void skip_space() noexcept
+            {
+                while (pos_ < text_.size() && is_space(text_[pos_]))
+                {
+                    if (text_[pos_] == '\n')
+                    {
+                        ++line_;
+                    }
+                    ++pos_;
+                }
+            }
+
+            bool try_consume(char c) noexcept
+            {
+                skip_space();
+                if (pos_ < text_.size() && text_[pos_] == c)
+                {
+                    ++pos_;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(char c)
+            {
+                if (!try_consume(c))
+                {
+                    throw error(fmt::format("Expected '{}'", c));
+                }
+            }
+
+            std::string_view parse_string()
+            {
+                expect('"');
+
+                const auto first = pos_;
+                while (pos_ < text_.size() && text_[pos_] != '"')
+                {
+                    if (text_[pos_] == '\\')
+                    {
+                        throw error("Escaped characters aren't supported");
+                    }
+                    ++pos_;
+                }
+
+                if (pos_ == text_.size())
+                {
+                    throw error("Unterminated string");
+                }
+
+                return text_.substr(first, pos_++ - first);
+            }
+
+            // null is returned as an empty value
+            std::string_view parse_value()
+            {
+                skip_space();
+                if (pos_ < text_.size() && text_[pos_] == '"')
+                {
+                    return parse_string();
+                }
+
+                const auto first = pos_;
+                while (pos_ < text_.size() && text_[pos_] != ',' &&
+                    text_[pos_] != '}' && !is_space(text_[pos_]))
+                {
+                    if (text_[pos_] == '{' || text_[pos_] == '[')
+                    {
+                        throw error("Nested values aren't supported");
+                    }
+                    ++pos_;
+                }
+
+                const auto value = text_.substr(first, pos_ - first);
+                if (value.empty())
+                {
+                    throw error("Expected a value");
+                }
+
+                return (value == "null") ? std::string_view{} : value;
+            }
+
+            std::invalid_argument error(std::string_view message) const
+            {
+                return std::invalid_argument(fmt::format("Line {}: {}", line_,
+                    message));
+            }
+
+            std::string_view text_;
+            std::size_t pos_{ 0 };
+            std::size_t line_{ 1 };
+        };
+    }
+
+    // Calls f with each record. JSON is detected by the text starting with
+    // '[', anything else is read as CSV.
+    template <typename F>
+    void for_each_record(std::string_view text, F f)
+    {
+        if (const auto t = detail::trim(text); !t.empty() && t.front() == '[')
+        {
+            detail::json_reader{ text }.for_each_record(f);
+        }
+        else
+        {
+            detail::for_each_csv_record(text, f);
+        }
+    }
+
+    // Keys: team, gp, w, l, otl, rw, row, sow, sol, gf, ga
+    // Only team is required, the rest default to 0.
+    inline std::vector<team_record> parse_standings(std::string_view text)
+    {
+        std::vector<team_record> ret;
+
+        for_each_record(text, [&ret](record const& r)
+            {
+                team_record t{ r.get_team("team") };
+                t.games_played = r.get_int("gp").value_or(0);
+                t.wins = r.get_int("w").value_or(0);
+                t.losses = r.get_int("l").value_or(0);
+                t.overtime_losses = r.get_int("otl").value_or(0);
+                t.regulation_wins = r.get_int("rw").value_or(0);
+                t.regulation_or_overtime_wins = r.get_int("row").value_or(0);
+                t.shootout_wins = r.get_int("sow").value_or(0);
+                t.shootout_losses = r.get_int("sol").value_or(0);
+                t.goals_for = r.get_int("gf").value_or(0);
+                t.goals_against = r.get_int("ga").value_or(0);
+
+                if (std::ranges::find(ret, t.id, &team_record::id) !=
+                    ret.end())
+                {
+                    throw r.error(fmt::format("Duplicate team '{}'",
+                        to_string(t.id)));
+                }
+
+                ret.push_back(t);
+            });
+
+        return ret;
+    }
+
+    struct game_log
+    {
+        std::vector<game_result> results;
+
+        // games without a score
+        std::vector<game> remaining;
+    };
+
+    // Keys: visitor, home, visitor_goals, home_goals, decision
+    // The decision is REG (the default), OT or SO. Other keys (e.g. date) are
+    // ignored.
+    inline game_log parse_games(std::string_view text)
+    {
+        game_log ret;
+
+        for_each_record(text, [&ret](record const& r)
+            {
+                const game g{ r.get_team("visitor"), r.get_team("home") };
+
+                if (g.visitor == g.home)
+                {
+                    throw r.error("A team can't play against itself");
+                }
+
+                const auto visitor_goals = r.get_int("visitor_goals");
+                const auto home_goals = r.get_int("home_goals");
+
+                if (!visitor_goals && !home_goals)
+                {
+                    ret.remaining.push_back(g);
+                    return;
+                }
+
+                if (!visitor_goals || !home_goals ||
+                    *visitor_goals == *home_goals)
+                {
+                    throw r.error("Invalid score");
+                }
+
+                const auto decision = r.get("decision").value_or("REG");
+                const auto home_won = *home_goals > *visitor_goals;
+
+                game_outcome outcome;
+                if (decision == "REG")
+                {
+                    outcome = home_won ? game_outcome::home_regulation :
+                        game_outcome::visitor_regulation;
+                }
+                else if (decision == "OT")
+                {
+                    outcome = home_won ? game_outcome::home_overtime :
+                        game_outcome::visitor_overtime;
+                }
+                else if (decision == "SO")
+                {
+                    outcome = home_won ? game_outcome::home_shootout :
+                        game_outcome::visitor_shootout;
+                }
+                else
+                {
+                    throw r.error(fmt::format("Invalid decision '{}'",
+                        decision));
+                }
+
+                ret.results.push_back({ g, *visitor_goals, *home_goals,
+                    outcome });
+            });
+
+        return ret;
+    }
+
+    inline std::vector<team_record> load_standings(
+        std::filesystem::path const& path)
+    {
+        const mapped_file file{ path };
+        return parse_standings(file.view());
+    }
+
+    inline game_log load_games(std::filesystem::path const& path)
+    {
+        const mapped_file file{ path };
+        return parse_games(file.view());
+    }
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cerrno>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nhl::io
+{
+    // A read-only view of a whole file, mapped into memory
+    class mapped_file
+    {
+    public:
+        mapped_file() = default;
+
+        explicit mapped_file(std::filesystem::path const& path)
+        {
+#if defined(_WIN32)
+            file_ = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE)
+            {
+                throw_last_error(path);
+            }
+
+            LARGE_INTEGER size;
+            if (!::GetFileSizeEx(file_, &size))
+            {
+                const auto error = last_error();
+                close();
+                throw std::system_error(error, path.string());
+            }
+
+            size_ = static_cast<std::size_t>(size.QuadPart);
+            if (size_ == 0)
+            {
+                return;
+            }
+
+            mapping_ = ::CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0,
+                0, nullptr);
+            if (mapping_ == nullptr)
+            {
+                const auto error = last_error();
+                close();
+                throw std::system_error(error, path.string());
+            }
+
+            data_ = static_cast<char const*>(::MapViewOfFile(mapping_,
+                FILE_MAP_READ, 0, 0, 0));
+            if (data_ == nullptr)
+            {
+                const auto error = last_error();
+                close();
+                throw std::system_error(error, path.string());
+            }
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw_last_error(path);
+            }
+
+            struct ::stat info;
+            if (::fstat(fd, &info) != 0)
+            {
+                const auto error = last_error();
+                ::close(fd);
+                throw std::system_error(error, path.string());
+            }
+
+            size_ = static_cast<std::size_t>(info.st_size);
+
+            // mapping 0 bytes is an error, and there's nothing to read anyway
+            if (size_ > 0)
+            {
+                void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd,
+                    0);
+                if (p == MAP_FAILED)
+                {
+                    const auto error = last_error();
+                    ::close(fd);
+                    throw std::system_error(error, path.string());
+                }
+
+                // the file is read front to back
+                ::madvise(p, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<char const*>(p);
+            }
+
+            // the mapping stays valid after the descriptor is closed
+            ::close(fd);
+#endif
+        }
+
+        mapped_file(mapped_file const&) = delete;
+        mapped_file& operator=(mapped_file const&) = delete;
+
+        mapped_file(mapped_file&& other) noexcept
+        {
+            swap(other);
+        }
+
+        mapped_file& operator=(mapped_file&& other) noexcept
+        {
+            if (this != &other)
+            {
+                close();
+                swap(other);
+            }
+            return *this;
+        }
+
+        ~mapped_file()
+        {
+            close();
+        }
+
+        // Only valid for the lifetime of the mapped_file
+        std::string_view view() const noexcept
+        {
+            return { data_, data_ ? size_ : 0 };
+        }
+
+        std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+    private:
+        static std::error_code last_error() noexcept
+        {
+#if defined(_WIN32)
+            return { static_cast<int>(::GetLastError()),
+                std::system_category() };
+#else
+            return { errno, std::system_category() };
+#endif
+        }
+
+        [[noreturn]] static void throw_last_error(
+            std::filesystem::path const& path)
+        {
+            throw std::system_error(last_error(), path.string());
+        }
+
+        void swap(mapped_file& other) noexcept
+        {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+#if defined(_WIN32)
+            std::swap(file_, other.file_);
+            std::swap(mapping_, other.mapping_);
+#endif
+        }
+
+        void close() noexcept
+        {
+#if defined(_WIN32)
+            if (data_ != nullptr)
+            {
+                ::UnmapViewOfFile(data_);
+            }
+            if (mapping_ != nullptr)
+            {
+                ::CloseHandle(mapping_);
+            }
+            if (file_ != INVALID_HANDLE_VALUE)
+            {
+                ::CloseHandle(file_);
+            }
+            file_ = INVALID_HANDLE_VALUE;
+            mapping_ = nullptr;
+#else
+            if (data_ != nullptr)
+            {
+                ::munmap(const_cast<char*>(data_), size_);
+            }
+#endif
+            data_ = nullptr;
+            size_ = 0;
+        }
+
+        char const* data_{ nullptr };
+        std::size_t size_{ 0 };
+
+#if defined(_WIN32)
+        HANDLE file_{ INVALID_HANDLE_VALUE };
+        HANDLE mapping_{ nullptr };
+#endif
+    };
+}
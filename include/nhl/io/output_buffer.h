@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cerrno>
+#include <charconv>
+#include <concepts>
+#include <cstdio>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include <algorithm>
+
+namespace nhl::io
+{
+    // A byte buffer for writing a whole file at once. It's sized up front
+    // from an upper bound on the output, numbers are formatted straight into
+    // it with to_chars, and nothing else is allocated while writing.
+    class output_buffer
+    {
+    public:
+        explicit output_buffer(std::size_t capacity) :
+            data_(capacity)
+        {
+        }
+
+        std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        std::size_t capacity() const noexcept
+        {
+            return data_.size();
+        }
+
+        std::string_view view() const noexcept
+        {
+            return { data_.data(), size_ };
+        }
+
+        void clear() noexcept
+        {
+            size_ = 0;
+        }
+
+        void append(std::string_view text)
+        {
+            text.copy(reserve(text.size()), text.size());
+            size_ += text.size();
+        }
+
+        void append(char c)
+        {
+            *reserve(1) = c;
+            ++size_;
+        }
+
+        template <std::integral T>
+        void append_number(T value)
+        {
+            constexpr std::size_t max_digits{ 24 };
+            const auto first = reserve(max_digits);
+            size_ = static_cast<std::size_t>(
+                std::to_chars(first, first + max_digits, value).ptr -
+                data_.data());
+        }
+
+        // Fixed point with the given number of decimals
+        void append_number(double value, int precision)
+        {
+            constexpr std::size_t max_chars{ 64 };
+            const auto first = reserve(max_chars);
+            const auto [ptr, ec] = std::to_chars(first, first + max_chars,
+                value, std::chars_format::fixed, precision);
+
+            if (ec != std::errc{})
+            {
+                throw std::system_error(std::make_error_code(ec));
+            }
+
+            size_ = static_cast<std::size_t>(ptr - data_.data());
+        }
+
+        // The bytes of the value, little-endian
+        template <std::unsigned_integral T>
+        void append_le(T value)
+        {
+            const auto first = reserve(sizeof(T));
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+            {
+                first[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+            }
+            size_ += sizeof(T);
+        }
+
+        void write_to(std::FILE* file) const
+        {
+            if (std::fwrite(data_.data(), 1, size_, file) != size_ ||
+                std::fflush(file) != 0)
+            {
+                throw std::system_error(errno, std::generic_category(),
+                    "Write failed");
+            }
+        }
+
+        void write_to(std::filesystem::path const& path) const
+        {
+            std::FILE* file = std::fopen(path.string().c_str(), "wb");
+            if (file == nullptr)
+            {
+                throw std::system_error(errno, std::generic_category(),
+                    path.string());
+            }
+
+            try
+            {
+                write_to(file);
+            }
+            catch (...)
+            {
+                std::fclose(file);
+                throw;
+            }
+
+            std::fclose(file);
+        }
+
+    private:
+        // Room for n more bytes. The capacity is meant to be enough already;
+        // this only grows the buffer if the estimate was wrong.
+        char* reserve(std::size_t n)
+        {
+            if (size_ + n > data_.size())
+            {
+                data_.resize((std::max)(data_.size() * 2, size_ + n));
+            }
+
+            return data_.data() + size_;
+        }
+
+        std::vector<char> data_;
+        std::size_t size_{ 0 };
+    };
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <fmt/format.h>
+#include "nhl/progress.h"
+#include "nhl/team.h"
+#include "nhl/thread_pool.h"
+#include "nhl/io/loader.h"
+#include "nhl/io/mapped_file.h"
+#include "nhl/lottery/batch.h"
+#include "nhl/lottery/combination_table.h"
+#include "nhl/lottery/rules.h"
+
+namespace nhl::lottery
+{
+    // One past lottery: the format in force that year, the lottery-eligible
+    // teams in ranking order and the draft order that actually came out of it
+    struct lottery_year
+    {
+        int year{ 0 };
+        lottery_format format;
+
+        // index 0 is ranking 1
+        std::vector<team_id> teams;
+
+        // index 0 is pick 1, each entry is a ranking
+        std::vector<int> draft_order;
+    };
+
+    // Keys: year, ranking, team, combinations, pick, rounds, max_jump
+    // One record per team per year. rounds and max_jump only need to be given
+    // once per year; max_jump defaults to no limit. The years are returned in
+    // order.
+    inline std::vector<lottery_year> parse_lottery_history(
+        std::string_view text)
+    {
+        struct year_rows
+        {
+            std::optional<int> rounds;
+            std::optional<int> max_jump;
+
+            // ranking, team, combinations, pick
+            struct row
+            {
+                int ranking;
+                team_id team;
+                int combinations;
+                int pick;
+            };
+            std::vector<row> rows;
+        };
+
+        std::map<int, year_rows> years;
+
+        io::for_each_record(text, [&years](io::record const& r)
+            {
+                const auto year = r.get_int("year");
+                if (!year)
+                {
+                    throw r.error("Missing value for 'year'");
+                }
+
+                auto& y = years[*year];
+
+                const auto set_once = [&r](std::optional<int>& value,
+                    std::string_view key)
+                {
+                    if (const auto v = r.get_int(key))
+                    {
+                        if (value && *value != *v)
+                        {
+                            throw r.error(fmt::format(
+                                "Conflicting values for '{}'", key));
+                        }
+                        value = v;
+                    }
+                };
+
+                set_once(y.rounds, "rounds");
+                set_once(y.max_jump, "max_jump");
+
+                const auto required_int = [&r](std::string_view key)
+                {
+                    if (const auto v = r.get_int(key); v && *v >= 0)
+                    {
+                        return *v;
+                    }
+                    throw r.error(fmt::format("Invalid value for '{}'", key));
+                };
+
+                y.rows.push_back({ required_int("ranking"), r.get_team("team"),
+                    required_int("combinations"), required_int("pick") });
+            });
+
+        std::vector<lottery_year> ret;
+        ret.reserve(years.size());
+
+        for (auto& [year, y] : years)
+        {
+            const auto error = [year](std::string_view message)
+            {
+                return std::invalid_argument(fmt::format("Year {}: {}", year,
+                    message));
+            };
+
+            if (!y.rounds || *y.rounds < 1)
+            {
+                throw error("Missing value for 'rounds'");
+            }
+
+            std::ranges::sort(y.rows, {}, &year_rows::row::ranking);
+
+            const auto n = y.rows.size();
+
+            lottery_year ly{ .year = year };
+            ly.format.rounds = static_cast<std::size_t>(*y.rounds);
+            ly.format.max_ranking_jump = y.max_jump.value_or(
+                static_cast<int>(n));
+            ly.draft_order.assign(n, 0);
+
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                auto const& row = y.rows[i];
+
+                if (row.ranking != static_cast<int>(i + 1))
+                {
+                    throw error("The rankings must be 1 to the number of "
+                        "teams");
+                }
+
+                if (row.pick < 1 || row.pick > static_cast<int>(n) ||
+                    ly.draft_order[static_cast<std::size_t>(row.pick - 1)] !=
+                    0)
+                {
+                    throw error(fmt::format("Invalid pick {}", row.pick));
+                }
+
+                ly.format.combinations_per_ranking.push_back(
+                    static_cast<std::size_t>(row.combinations));
+                ly.teams.push_back(row.team);
+                ly.draft_order[static_cast<std::size_t>(row.pick - 1)] =
+                    row.ranking;
+            }
+
+            try
+            {
+                ly.format.validate();
+            }
+            catch (std::out_of_range const& e)
+            {
+                throw error(e.what());
+            }
+
+            ret.push_back(std::move(ly));
+        }
+
+        return ret;
+    }
+
+    inline std::vector<lottery_year> load_lottery_history(
+        std::filesystem::path const& path)
+    {
+        const io::mapped_file file{ path };
+        return parse_lottery_history(file.view());
+    }
+
+    struct backtest_result : pick_counts
+    {
+        int year{ 0 };
+
+        // draws that produced the draft order that actually happened
+        std::size_t actual_draft_orders{ 0 };
+
+        // How likely the actual draft order was under that year's rules
+        double actual_probability() const
+        {
+            return static_cast<double>(actual_draft_orders) /
+                static_cast<double>(draws);
+        }
+
+        backtest_result& operator+=(backtest_result const& rhs) noexcept
+        {
+            pick_counts::operator+=(rhs);
+            actual_draft_orders += rhs.actual_draft_orders;
+            return *this;
+        }
+    };
+
+    // Replays every year's lottery draws_per_year times with the rules in
+    // force that year, with all the years in one job (see run_batch)
+    inline std::vector<backtest_result> run_backtest(
+        std::span<lottery_year const> years, std::size_t draws_per_year,
+        std::uint64_t seed, thread_pool& pool,
+        progress_counters* progress = nullptr)
+    {
+        // the ranking distributions are built once per year
+        std::vector<format_combination_table> tables;
+        tables.reserve(years.size());
+
+        std::vector<backtest_result> empty_results;
+        empty_results.reserve(years.size());
+
+        for (auto const& y : years)
+        {
+            tables.emplace_back(y.format);
+            empty_results.push_back({ pick_counts{ y.format.team_count() },
+                y.year });
+        }
+
+        return run_batch(std::span{ std::as_const(tables) }, draws_per_year,
+            seed, pool, empty_results,
+            [&years](backtest_result& result, std::size_t y,
+                format_draw_result const& draw)
+            {
+                result.record(draw.draft_order());
+
+                if (std::ranges::equal(draw.draft_order(),
+                    years[y].draft_order))
+                {
+                    ++result.actual_draft_orders;
+                }
+            }, progress);
+    }
+}
@@ -50,7 +50,7 @@ namespace nhl::lottery
         underlying_type value_{ 1 };
     };
 
-    std::ostream& operator<<(std::ostream& os, ball const& b)
+    inline std::ostream& operator<<(std::ostream& os, ball const& b)
     {
         os << static_cast<int>(b);
         return os;
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "nhl/parallel.h"
+#include "nhl/progress.h"
+#include "nhl/random.h"
+#include "nhl/thread_pool.h"
+#include "nhl/lottery/combination_table.h"
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/histogram.h"
+#include "nhl/lottery/machine.h"
+
+namespace nhl::lottery
+{
+    // How often each ranking ended up with each pick
+    struct pick_counts
+    {
+        std::size_t team_count{ 0 };
+        std::size_t draws{ 0 };
+
+        // [(ranking - 1) * team_count + (pick - 1)]
+        std::vector<std::size_t> picks;
+
+        pick_counts() = default;
+
+        explicit pick_counts(std::size_t teams) :
+            team_count{ teams },
+            picks(teams * teams)
+        {
+        }
+
+        std::size_t count(int ranking, int pick) const noexcept
+        {
+            return picks[static_cast<std::size_t>(ranking - 1) * team_count +
+                static_cast<std::size_t>(pick - 1)];
+        }
+
+        double pick_probability(int ranking, int pick) const
+        {
+            return static_cast<double>(count(ranking, pick)) /
+                static_cast<double>(draws);
+        }
+
+        // The probability of a pick in [first_pick, last_pick]
+        double pick_probability(int ranking, int first_pick,
+            int last_pick) const
+        {
+            std::size_t ret{ 0 };
+            for (int p = first_pick; p <= last_pick; ++p)
+            {
+                ret += count(ranking, p);
+            }
+            return static_cast<double>(ret) / static_cast<double>(draws);
+        }
+
+        double expected_pick(int ranking) const
+        {
+            double ret{ 0.0 };
+            for (std::size_t p = 1; p <= team_count; ++p)
+            {
+                ret += static_cast<double>(p) *
+                    pick_probability(ranking, static_cast<int>(p));
+            }
+            return ret;
+        }
+
+        void record(std::span<int const> draft_order) noexcept
+        {
+            for (std::size_t pick = 0; pick < draft_order.size(); ++pick)
+            {
+                picks[static_cast<std::size_t>(draft_order[pick] - 1) *
+                    team_count + pick]++;
+            }
+            ++draws;
+        }
+
+        pick_counts& operator+=(pick_counts const& rhs) noexcept
+        {
+            draws += rhs.draws;
+            for (std::size_t i = 0; i < picks.size(); ++i)
+            {
+                picks[i] += rhs.picks[i];
+            }
+            return *this;
+        }
+    };
+
+    // Runs draws_per_table draws of every table in one job and calls
+    // record(results[t], t, draw) after each draw of table t (a
+    // format_draw_result), where results starts as a copy of empty_results.
+    //
+    // The blocks of every table are numbered one after the other and shared
+    // out over the pool, so a table with few draws doesn't leave threads idle
+    // and the results only depend on the seed and the order of the tables.
+    // Each worker keeps one machine and one scratch table for the whole job;
+    // the tables passed in are never shuffled. If progress is given, each
+    // worker adds its draws to its own counter after every block.
+    template <typename Result, typename Record>
+    std::vector<Result> run_batch(
+        std::span<format_combination_table const> tables,
+        std::size_t draws_per_table, std::uint64_t seed, thread_pool& pool,
+        std::vector<Result> const& empty_results, Record record,
+        progress_counters* progress = nullptr)
+    {
+        if (tables.empty())
+        {
+            return {};
+        }
+
+        const auto blocks_per_table = block_count(draws_per_table);
+
+        struct worker_state
+        {
+            std::vector<Result> results;
+            format_combination_table table;
+            nhl::lottery::machine machine;
+            std::size_t progress_counter{ 0 };
+        };
+
+        const auto make_state = [&]()
+        {
+            return worker_state{ empty_results, tables.front(), {},
+                progress ? progress->claim() : 0 };
+        };
+
+        const auto run_block = [&](worker_state& state, std::size_t block)
+        {
+            const auto t = block / blocks_per_table;
+            const auto range = block_at(draws_per_table,
+                block % blocks_per_table);
+
+            auto gen = make_random_engine(seed, block);
+
+            // reuses the scratch table's storage
+            state.table = tables[t];
+            state.table.populate(gen);
+
+            auto& result = state.results[t];
+
+            for (std::size_t d = range.first; d < range.last; ++d)
+            {
+                record(result, t, run_draw(state.table, state.machine,
+                    gen));
+            }
+
+            if (progress)
+            {
+                progress->add(state.progress_counter, range.size());
+            }
+        };
+
+        auto states = run_blocks(pool, 0, blocks_per_table * tables.size(),
+            make_state, run_block);
+
+        auto ret = empty_results;
+        for (auto const& state : states)
+        {
+            for (std::size_t t = 0; t < ret.size(); ++t)
+            {
+                ret[t] += state.results[t];
+            }
+        }
+
+        return ret;
+    }
+
+    // Draws the format draws times and counts each draft order (see
+    // run_batch). Each worker fills its own histogram and they're merged at
+    // the end.
+    inline draft_order_histogram count_draft_orders(
+        lottery_format const& format, std::size_t draws, std::uint64_t seed,
+        thread_pool& pool)
+    {
+        if (format.team_count() > packed_draft_order::max_size)
+        {
+            throw std::out_of_range("Too many teams to count draft orders");
+        }
+
+        const format_combination_table tables[]{ format_combination_table{
+            format } };
+
+        auto ret = run_batch(std::span{ tables }, draws, seed, pool,
+            std::vector<draft_order_histogram>(1),
+            [](draft_order_histogram& result, std::size_t,
+                format_draw_result const& draw)
+            {
+                result.add(packed_draft_order{ draw.draft_order() });
+            });
+
+        return std::move(ret.front());
+    }
+}
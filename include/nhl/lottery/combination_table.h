@@ -1,97 +1,198 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <optional>
-#include <ranges>
-#include <unordered_map>
+#include <random>
+#include <utility>
+#include <vector>
+#include <algorithm>
 #include "nhl/print.h"
+#include "nhl/lottery/instrumentation.h"
 #include "nhl/lottery/lottery.h"
 #include "nhl/lottery/ranking_combinations.h"
 #include "nhl/lottery/combination_value.h"
+#include "nhl/lottery/rules.h"
 
 namespace nhl::lottery
 {
-    class combination_table
+    namespace detail
+    {
+        // combination_index of each combination, in lexicographic order
+        inline constexpr auto lexicographic_combination_indices = []()
+        {
+            std::array<std::uint16_t, combination_count> ret{};
+            std::size_t i{ 0 };
+            nhl::lottery::for_each_combination_value([&](auto const& combo)
+                {
+                    ret[i++] = static_cast<std::uint16_t>(
+                        combination_index(combo));
+                });
+            return ret;
+        }();
+    }
+
+    // The ranking that each combination belongs to, stored in a flat array
+    // indexed by combination_index. 0 marks a combination that is redrawn.
+    template <lottery_rules Rules = standard_rules>
+    class basic_combination_table
     {
     public:
-        using combinations_type =
-            std::unordered_map<combination_value, int>;
+        using rules_type = Rules;
+        using rankings_type = std::array<std::uint8_t, combination_count>;
 
         void populate()
         {
-            combinations_.clear();
+            static std::random_device rd;
+            static std::mt19937 gen{ rd() };
 
-            const auto dist = ranking_combination_distribution();
+            populate(gen);
+        }
 
-            std::size_t dist_index{ 0 };
-            nhl::lottery::for_each_combination_value(
-                [&](auto const& combo)
-            {
-                if (dist_index < dist.size())
-                {
-                    combinations_[combo] = dist[dist_index++];
-                }
-                // left overs are considered redraws. If there's a need for
-                // something more advanced, pass a predicate into the function
-                // that returns whether a combo is a redraw
-                // 
-                // else
-                // {
-                //     combinations_[combo] = 0;
-                // }
-            });
+        template <std::uniform_random_bit_generator URBG>
+        void populate(URBG& gen)
+        {
+            instrumentation::count(instrumentation::counter::table_populates);
+            const instrumentation::stage_timer timer{
+                instrumentation::stage::populate };
+
+            auto dist = ranking_distribution<Rules>();
+            std::shuffle(dist.begin(), dist.end(), gen);
+            fill(dist);
         }
 
-        combinations_type const& combinations() const
+        rankings_type const& rankings() const noexcept
         {
-            return combinations_;
+            return rankings_;
         }
 
         std::optional<int> lookup(combination_value const& combo) const
         {
-            if (auto pos = combinations_.find(combo);
-                pos != combinations_.end())
+            instrumentation::count(instrumentation::counter::lookups);
+            const instrumentation::stage_timer timer{
+                instrumentation::stage::lookup };
+
+            if (const auto ranking = rankings_[combination_index(combo)];
+                ranking != 0)
             {
-                return pos->second;
+                return ranking;
             }
 
             return std::nullopt;
         }
 
     private:
-        combinations_type combinations_;
+        void fill(std::array<int, combinations_used_by<Rules>> const& dist)
+        {
+            // Combinations are assigned in lexicographic order; the left
+            // overs are redraws
+            rankings_.fill(0);
+
+            for (std::size_t i = 0; i < dist.size(); ++i)
+            {
+                rankings_[detail::lexicographic_combination_indices[i]] =
+                    static_cast<std::uint8_t>(dist[i]);
+            }
+        }
+
+        rankings_type rankings_{};
     };
 
-    inline void print_combination_table(combination_table const& table)
+    using combination_table = basic_combination_table<standard_rules>;
+
+    // A combination table for a lottery_format, laid out the same way as
+    // basic_combination_table. The ranking distribution is built once, when
+    // the table is constructed.
+    class format_combination_table
     {
-        temp::println("Combination Table");
-        temp::println("-----------------");
+    public:
+        using rankings_type = std::array<std::uint8_t, combination_count>;
 
-        // sort the combinations with the help of a vector + reference_wrapper
+        explicit format_combination_table(lottery_format format) :
+            format_{ std::move(format) }
+        {
+            format_.validate();
 
-        using kv_type = std::add_const_t<
-            typename combination_table::combinations_type::value_type>;
+            for (std::size_t r = 0; r < format_.team_count(); ++r)
+            {
+                distribution_.insert(distribution_.end(),
+                    format_.combinations_per_ranking[r],
+                    static_cast<std::uint8_t>(r + 1));
+            }
 
-        std::vector<std::reference_wrapper<kv_type>> sorted_combinations
-            ( table.combinations().begin(), table.combinations().end() );
+            fill(distribution_);
+        }
+
+        lottery_format const& format() const noexcept
+        {
+            return format_;
+        }
 
-        std::sort(sorted_combinations.begin(), sorted_combinations.end(),
-            [](auto const& lhs, auto const& rhs)
+        template <std::uniform_random_bit_generator URBG>
+        void populate(URBG& gen)
+        {
+            instrumentation::count(instrumentation::counter::table_populates);
+            const instrumentation::stage_timer timer{
+                instrumentation::stage::populate };
+
+            shuffled_ = distribution_;
+            std::shuffle(shuffled_.begin(), shuffled_.end(), gen);
+            fill(shuffled_);
+        }
+
+        rankings_type const& rankings() const noexcept
+        {
+            return rankings_;
+        }
+
+        std::optional<int> lookup(combination_value const& combo) const
+        {
+            instrumentation::count(instrumentation::counter::lookups);
+            const instrumentation::stage_timer timer{
+                instrumentation::stage::lookup };
+
+            if (const auto ranking = rankings_[combination_index(combo)];
+                ranking != 0)
             {
-                return lhs.get().first < rhs.get().first;
-            });
+                return ranking;
+            }
 
-        // std::ranges::sort(sorted_combinations,
-        //     [](auto const& lhs, auto const& rhs)
-        //     {
-        //         return lhs.get().first < rhs.get().first;
-        //     });
+            return std::nullopt;
+        }
 
-        for (auto const& combo : sorted_combinations)
+    private:
+        void fill(std::vector<std::uint8_t> const& dist)
         {
-            std::cout << combo.get().first << " => " << combo.get().second <<
-                "\n";
+            rankings_.fill(0);
+
+            for (std::size_t i = 0; i < dist.size(); ++i)
+            {
+                rankings_[detail::lexicographic_combination_indices[i]] =
+                    dist[i];
+            }
         }
 
+        lottery_format format_;
+        std::vector<std::uint8_t> distribution_;
+        std::vector<std::uint8_t> shuffled_;
+        rankings_type rankings_{};
+    };
+
+    template <lottery_rules Rules>
+    void print_combination_table(basic_combination_table<Rules> const& table)
+    {
+        temp::println("Combination Table");
+        temp::println("-----------------");
+
+        // lexicographic order
+        nhl::lottery::for_each_combination_value([&](auto const& combo)
+            {
+                if (const auto ranking = table.lookup(combo))
+                {
+                    std::cout << combo << " => " << *ranking << "\n";
+                }
+            });
+
         temp::println("");
     }
 }
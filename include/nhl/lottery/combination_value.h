@@ -74,8 +74,37 @@ namespace nhl::lottery
         underlying_type value_{ 0b0001'0010'0011'0100 }; // 1 2 3 4
     };
 
+    // The colexicographic rank of a combination (0 to combination_count - 1),
+    // i.e. C(one - 1, 1) + C(two - 1, 2) + C(three - 1, 3) + C(four - 1, 4)
+    // for sorted balls. Lets a table of every combination be a flat array.
+    constexpr std::size_t combination_index(combination_value const& cv)
+        noexcept
+    {
+        const auto binomial = [](std::size_t n, std::size_t k)
+        {
+            if (n < k)
+            {
+                return std::size_t{ 0 };
+            }
+
+            std::size_t ret{ 1 };
+            for (std::size_t i = 1; i <= k; ++i)
+            {
+                ret = ret * (n - k + i) / i;
+            }
+            return ret;
+        };
+
+        return binomial(cv.one() - 1, 1) + binomial(cv.two() - 1, 2) +
+            binomial(cv.three() - 1, 3) + binomial(cv.four() - 1, 4);
+    }
+    static_assert(combination_index(combination_value{ 1, 2, 3, 4 }) == 0);
+    static_assert(combination_index(combination_value{ 1, 2, 3, 5 }) == 1);
+    static_assert(combination_index(combination_value{ 11, 12, 13, 14 }) ==
+        combination_count - 1);
+
     template <typename F>
-    F for_each_combination_value(F f)
+    constexpr F for_each_combination_value(F f)
     {
         math::for_each_combination<nhl::lottery::ball_count,
             nhl::lottery::combination_size>(
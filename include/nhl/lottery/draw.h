@@ -0,0 +1,475 @@
+#pragma once
+
+#include <array>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <algorithm>
+#include "nhl/lottery/lottery.h"
+#include "nhl/lottery/ball.h"
+#include "nhl/lottery/combination.h"
+#include "nhl/lottery/combination_table.h"
+#include "nhl/lottery/instrumentation.h"
+#include "nhl/lottery/machine.h"
+#include "nhl/lottery/packed_draft_order.h"
+#include "nhl/lottery/ranking.h"
+#include "nhl/lottery/round.h"
+#include "nhl/lottery/rules.h"
+#include "nhl/lottery/stats.h"
+
+namespace nhl::lottery
+{
+    template <lottery_rules Rules>
+    using basic_draft_order_type = std::array<int, Rules::team_count>;
+
+    using draft_order_type = basic_draft_order_type<standard_rules>;
+
+    enum class redraw_reason
+    {
+        unassigned_combination, // the combination reserved for redraws
+        previous_winner,        // the ranking won a previous round
+        locked_in               // the ranking's pick was locked in by a
+                                // previous round
+    };
+
+    // Receives each step of a draw. Derive from this type and hide the
+    // functions of interest; calls are resolved at compile time, so the
+    // default (empty) functions cost nothing.
+    struct draw_observer
+    {
+        void attempt_started(round_number, std::size_t) {}
+        void drawing_ball(round_number, std::size_t) {}
+        void ball_drawn(round_number, std::size_t, ball) {}
+        void combination_drawn(round_number, combination const&,
+            std::optional<int>) {}
+        void redraw(round_number, redraw_reason, combination const&) {}
+        void winner_drawn(round_number, int) {}
+        void attempt_finished(round_number) {}
+    };
+
+    template <lottery_rules Rules>
+    struct basic_draw_result
+    {
+        basic_draft_order_type<Rules> draft_order{ rankings_for<Rules> };
+        std::size_t rounds{ 0 };
+
+        // index 0 is round 1
+        std::array<int, max_lottery_rounds> winners{};
+        std::array<std::size_t, max_lottery_rounds> redraws{};
+    };
+
+    using draw_result = basic_draw_result<standard_rules>;
+
+    namespace detail
+    {
+        // Moves the winner of a round up the draft order: to the top of the
+        // picks still open (round_index onwards), or as far as max_jump
+        // allows. Returns false if the winner's pick is already locked in.
+        constexpr bool move_up(std::span<int> draft_order,
+            std::size_t round_index, int winner, int max_jump)
+        {
+            auto remaining_draft_order = draft_order |
+                std::views::drop(round_index);
+
+            const auto pos = std::ranges::find(remaining_draft_order, winner);
+            if (pos == std::ranges::end(remaining_draft_order))
+            {
+                return false;
+            }
+
+            const auto top_ranking = static_cast<int>(round_index + 1);
+
+            const auto adjusted_ranking = (winner <= max_jump) ?
+                top_ranking : std::max(winner - max_jump, top_ranking);
+
+            const auto places_from_top = adjusted_ranking - top_ranking;
+
+            // Reference:
+            // https://stackoverflow.com/questions/26176001/c-easiest-most-efficient-way-to-move-a-single-element-to-a-new-position-within
+
+            std::ranges::rotate(
+                remaining_draft_order.begin() + places_from_top,
+                pos,
+                pos + 1
+            );
+
+            return true;
+        }
+
+        constexpr bool move_up(packed_draft_order& draft_order,
+            std::size_t round_index, int winner, int max_jump) noexcept
+        {
+            return draft_order.move_up(round_index, winner, max_jump);
+        }
+
+        // The rounds of one draw, shared by every format. draft_order is a
+        // span<int> or a packed_draft_order and starts as the rankings in
+        // order; winners and redraws are indexed by round.
+        template <typename Table, typename DraftOrder,
+            std::uniform_random_bit_generator URBG, typename Observer>
+        void draw_rounds(Table const& table, machine& machine,
+            DraftOrder& draft_order, std::size_t rounds, int max_jump,
+            URBG& gen, Observer& observer, std::span<int> winners,
+            std::span<std::size_t> redraws)
+        {
+            for (round_number round{ 1 }; round <=
+                round_number{ static_cast<int>(rounds) };)
+            {
+                const auto round_index = static_cast<std::size_t>(
+                    static_cast<int>(round) - 1);
+
+                observer.attempt_started(round, rounds);
+                instrumentation::count(instrumentation::counter::attempts);
+
+                machine.load_balls(std::span{ balls });
+
+                std::array<ball, balls_to_draw> drawn_balls;
+
+                for (std::size_t b = 0; b < balls_to_draw; ++b)
+                {
+                    observer.drawing_ball(round, b);
+                    drawn_balls[b] = machine.draw_ball(gen);
+                    observer.ball_drawn(round, b, drawn_balls[b]);
+                }
+
+                const combination combo{ drawn_balls };
+                const auto winner = table.lookup(to_value(combo));
+
+                observer.combination_drawn(round, combo, winner);
+
+                if (!winner)
+                {
+                    ++redraws[round_index];
+                    instrumentation::count(
+                        instrumentation::counter::redraws_unassigned);
+                    observer.redraw(round,
+                        redraw_reason::unassigned_combination, combo);
+                }
+                else if (std::ranges::find(winners.begin(),
+                    winners.begin() + round_index, *winner) !=
+                    winners.begin() + round_index)
+                {
+                    ++redraws[round_index];
+                    instrumentation::count(
+                        instrumentation::counter::redraws_previous_winner);
+                    observer.redraw(round, redraw_reason::previous_winner,
+                        combo);
+                }
+                else
+                {
+                    const auto moved = [&]()
+                    {
+                        const instrumentation::stage_timer timer{
+                            instrumentation::stage::placement };
+
+                        return move_up(draft_order, round_index, *winner,
+                            max_jump);
+                    }();
+
+                    if (moved)
+                    {
+                        instrumentation::count(
+                            instrumentation::counter::moves);
+                        winners[round_index] = *winner;
+                        observer.winner_drawn(round, *winner);
+
+                        observer.attempt_finished(round);
+                        ++round;
+                        continue;
+                    }
+
+                    ++redraws[round_index];
+                    instrumentation::count(
+                        instrumentation::counter::redraws_locked_in);
+                    observer.redraw(round, redraw_reason::locked_in,
+                        combo);
+                }
+
+                observer.attempt_finished(round);
+            }
+        }
+
+        // The rounds of one draw without the machine or a table. The winner
+        // of a round is drawn straight from the rankings that could still
+        // win it (not a previous winner, and not locked in), in proportion to
+        // their combinations; every other combination, the redraw one
+        // included, is a miss with the same chance, so the number of redraws
+        // before the winner is geometric in the chance of a hit.
+        template <typename DraftOrder, std::uniform_random_bit_generator URBG>
+        void sample_rounds(std::span<std::size_t const> combinations,
+            DraftOrder& draft_order, std::size_t rounds, int max_jump,
+            URBG& gen, std::span<int> winners,
+            std::span<std::size_t> redraws)
+        {
+            const auto team_count = combinations.size();
+
+            for (std::size_t round_index = 0; round_index < rounds;
+                ++round_index)
+            {
+                const auto previous_winners = winners.first(round_index);
+
+                // 0 for the rankings that can't win the round
+                const auto weight = [&](int ranking) -> std::size_t
+                {
+                    return (std::ranges::find(previous_winners, ranking) !=
+                        previous_winners.end()) ? 0 :
+                        combinations[static_cast<std::size_t>(ranking - 1)];
+                };
+
+                // the picks before round_index are locked in
+                std::size_t hits{ 0 };
+                for (std::size_t i = round_index; i < team_count; ++i)
+                {
+                    hits += weight(draft_order[i]);
+                }
+
+                if (hits == 0)
+                {
+                    throw std::runtime_error("No ranking can win the round");
+                }
+
+                // The first draw is a hit most of the time, and then it
+                // picks the winner too. Otherwise the misses after it are
+                // geometric (hits < combination_count, since a combination
+                // is always left over for redraws).
+                std::uniform_int_distribution<std::size_t> first_draw{ 0,
+                    combination_count - 1 };
+                auto hit = first_draw(gen);
+
+                if (hit >= hits)
+                {
+                    std::geometric_distribution<std::size_t> misses{
+                        static_cast<double>(hits) /
+                        static_cast<double>(combination_count) };
+                    redraws[round_index] = 1 + misses(gen);
+
+                    std::uniform_int_distribution<std::size_t> hit_dist{ 0,
+                        hits - 1 };
+                    hit = hit_dist(gen);
+                }
+
+                int winner{ 0 };
+                for (std::size_t i = round_index; i < team_count; ++i)
+                {
+                    const auto w = weight(draft_order[i]);
+                    if (hit < w)
+                    {
+                        winner = draft_order[i];
+                        break;
+                    }
+                    hit -= w;
+                }
+
+                instrumentation::count(instrumentation::counter::attempts,
+                    redraws[round_index] + 1);
+                instrumentation::count(instrumentation::counter::moves);
+
+                move_up(draft_order, round_index, winner, max_jump);
+                winners[round_index] = winner;
+            }
+        }
+    }
+
+    // Runs every round of one lottery: the machine draws balls until a
+    // combination belonging to an eligible ranking comes up, then that ranking
+    // moves up the draft order (limited by the rules' max_ranking_jump). The
+    // rules come from the table, so each format gets its own instantiation.
+    template <lottery_rules Rules, std::uniform_random_bit_generator URBG,
+        typename Observer = draw_observer>
+    basic_draw_result<Rules> run_draw(
+        basic_combination_table<Rules> const& table, machine& machine,
+        std::size_t rounds, URBG& gen, Observer&& observer = {})
+    {
+        if (rounds > max_lottery_rounds || rounds >= Rules::team_count)
+        {
+            throw std::out_of_range("Invalid number of lottery rounds");
+        }
+
+        instrumentation::count(instrumentation::counter::lotteries);
+
+        basic_draw_result<Rules> ret{ .rounds = rounds };
+
+        // the moves are shifts and masks on one word when the order fits
+        if constexpr (Rules::team_count <= packed_draft_order::max_size)
+        {
+            packed_draft_order draft_order;
+
+            detail::draw_rounds(table, machine, draft_order, rounds,
+                Rules::max_ranking_jump, gen, observer,
+                std::span{ ret.winners }, std::span{ ret.redraws });
+
+            ret.draft_order = draft_order.to_array<Rules::team_count>();
+        }
+        else
+        {
+            std::span draft_order{ ret.draft_order };
+
+            detail::draw_rounds(table, machine, draft_order, rounds,
+                Rules::max_ranking_jump, gen, observer,
+                std::span{ ret.winners }, std::span{ ret.redraws });
+        }
+
+        return ret;
+    }
+
+    // The result of a draw in a lottery_format; only the first team_count
+    // entries of the draft order are used
+    struct format_draw_result
+    {
+        std::array<int, max_team_count> draft_order_storage{};
+        std::size_t team_count{ 0 };
+        std::size_t rounds{ 0 };
+
+        // index 0 is round 1
+        std::array<int, max_lottery_rounds> winners{};
+        std::array<std::size_t, max_lottery_rounds> redraws{};
+
+        std::span<int const> draft_order() const noexcept
+        {
+            return { draft_order_storage.data(), team_count };
+        }
+    };
+
+    // run_draw for a format only known at run time
+    template <std::uniform_random_bit_generator URBG,
+        typename Observer = draw_observer>
+    format_draw_result run_draw(format_combination_table const& table,
+        machine& machine, URBG& gen, Observer&& observer = {})
+    {
+        auto const& format = table.format();
+
+        instrumentation::count(instrumentation::counter::lotteries);
+
+        format_draw_result ret{ .team_count = format.team_count(),
+            .rounds = format.rounds };
+
+        std::span draft_order{ ret.draft_order_storage.data(),
+            ret.team_count };
+
+        if (ret.team_count <= packed_draft_order::max_size)
+        {
+            packed_draft_order packed;
+
+            detail::draw_rounds(table, machine, packed, format.rounds,
+                format.max_ranking_jump, gen, observer,
+                std::span{ ret.winners }, std::span{ ret.redraws });
+
+            for (std::size_t i = 0; i < draft_order.size(); ++i)
+            {
+                draft_order[i] = packed[i];
+            }
+        }
+        else
+        {
+            std::iota(draft_order.begin(), draft_order.end(), 1);
+
+            detail::draw_rounds(table, machine, draft_order, format.rounds,
+                format.max_ranking_jump, gen, observer,
+                std::span{ ret.winners }, std::span{ ret.redraws });
+        }
+
+        return ret;
+    }
+
+    // A draw with the same distribution as run_draw, winners and redraws
+    // included, sampled without ever drawing a ball or redrawing (see
+    // detail::sample_rounds). There are no balls, so there's no observer.
+    template <lottery_rules Rules, std::uniform_random_bit_generator URBG>
+    basic_draw_result<Rules> sample_draw(std::size_t rounds, URBG& gen)
+    {
+        if (rounds > max_lottery_rounds || rounds >= Rules::team_count)
+        {
+            throw std::out_of_range("Invalid number of lottery rounds");
+        }
+
+        instrumentation::count(instrumentation::counter::lotteries);
+
+        basic_draw_result<Rules> ret{ .rounds = rounds };
+
+        if constexpr (Rules::team_count <= packed_draft_order::max_size)
+        {
+            packed_draft_order draft_order;
+
+            detail::sample_rounds(
+                std::span{ Rules::combinations_per_ranking }, draft_order,
+                rounds, Rules::max_ranking_jump, gen,
+                std::span{ ret.winners }, std::span{ ret.redraws });
+
+            ret.draft_order = draft_order.to_array<Rules::team_count>();
+        }
+        else
+        {
+            std::span draft_order{ ret.draft_order };
+
+            detail::sample_rounds(
+                std::span{ Rules::combinations_per_ranking }, draft_order,
+                rounds, Rules::max_ranking_jump, gen,
+                std::span{ ret.winners }, std::span{ ret.redraws });
+        }
+
+        return ret;
+    }
+
+    // sample_draw for a format only known at run time, which must be valid
+    // (see lottery_format::validate)
+    template <std::uniform_random_bit_generator URBG>
+    format_draw_result sample_draw(lottery_format const& format, URBG& gen)
+    {
+        instrumentation::count(instrumentation::counter::lotteries);
+
+        format_draw_result ret{ .team_count = format.team_count(),
+            .rounds = format.rounds };
+
+        std::span draft_order{ ret.draft_order_storage.data(),
+            ret.team_count };
+        std::iota(draft_order.begin(), draft_order.end(), 1);
+
+        detail::sample_rounds(std::span{ format.combinations_per_ranking },
+            draft_order, format.rounds, format.max_ranking_jump, gen,
+            std::span{ ret.winners }, std::span{ ret.redraws });
+
+        return ret;
+    }
+
+    template <lottery_rules Rules>
+    void record(lottery_stats& stats, basic_draw_result<Rules> const& result)
+    {
+        const instrumentation::stage_timer timer{
+            instrumentation::stage::record };
+
+        for (std::size_t i = 0; i < result.rounds; ++i)
+        {
+            const round_number round{ static_cast<int>(i + 1) };
+
+            stats.round_winner_stats[round][result.winners[i]]++;
+
+            if (result.redraws[i] > 0)
+            {
+                stats.redraws[round] += result.redraws[i];
+            }
+        }
+
+        for (int ranking = 1; auto team : result.draft_order)
+        {
+            stats.draft_order_stats[ranking][team]++;
+            ++ranking;
+        }
+
+        if (std::ranges::is_sorted(result.draft_order))
+        {
+            stats.original_draft_order_retained++;
+        }
+
+        if constexpr (Rules::team_count <= packed_draft_order::max_size)
+        {
+            if (stats.draft_orders)
+            {
+                stats.draft_orders->add(packed_draft_order{
+                    result.draft_order });
+            }
+        }
+    }
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/lottery.h"
+#include "nhl/lottery/rules.h"
+
+namespace nhl::lottery
+{
+    // The exact probability of each ranking ending up with each pick, with
+    // the same interface as pick_counts
+    struct pick_odds
+    {
+        std::size_t team_count{ 0 };
+
+        // [(ranking - 1) * team_count + (pick - 1)]
+        std::vector<double> probabilities;
+
+        double pick_probability(int ranking, int pick) const
+        {
+            return probabilities[static_cast<std::size_t>(ranking - 1) *
+                team_count + static_cast<std::size_t>(pick - 1)];
+        }
+
+        // The probability of a pick in [first_pick, last_pick]
+        double pick_probability(int ranking, int first_pick,
+            int last_pick) const
+        {
+            double ret{ 0.0 };
+            for (int p = first_pick; p <= last_pick; ++p)
+            {
+                ret += pick_probability(ranking, p);
+            }
+            return ret;
+        }
+
+        double expected_pick(int ranking) const
+        {
+            double ret{ 0.0 };
+            for (std::size_t p = 1; p <= team_count; ++p)
+            {
+                ret += static_cast<double>(p) *
+                    pick_probability(ranking, static_cast<int>(p));
+            }
+            return ret;
+        }
+    };
+
+    namespace detail
+    {
+        using exact_draft_order = std::array<int, max_team_count>;
+
+        // Follows every sequence of winners. Redraws only rescale the odds,
+        // so each round is won by one of the eligible rankings (not a
+        // previous winner and not locked in) in proportion to its
+        // combinations. visit(draft_order, winners, probability) is called
+        // once per sequence, with the winners indexed by round.
+        template <typename Visit>
+        constexpr void add_exact_draws(
+            std::span<std::size_t const> combinations, std::size_t rounds,
+            int max_jump, exact_draft_order const& draft_order,
+            std::size_t round_index, exact_draft_order const& winners,
+            double probability, Visit& visit)
+        {
+            const auto n = combinations.size();
+
+            if (round_index == rounds)
+            {
+                visit(std::span{ draft_order.data(), n },
+                    std::span{ winners.data(), rounds }, probability);
+                return;
+            }
+
+            const auto eligible = [&](int ranking)
+            {
+                return std::ranges::find(winners.begin(), winners.begin() +
+                    static_cast<std::ptrdiff_t>(round_index), ranking) ==
+                    winners.begin() + static_cast<std::ptrdiff_t>(round_index);
+            };
+
+            std::size_t total{ 0 };
+            for (std::size_t pick = round_index; pick < n; ++pick)
+            {
+                if (eligible(draft_order[pick]))
+                {
+                    total += combinations[
+                        static_cast<std::size_t>(draft_order[pick] - 1)];
+                }
+            }
+
+            if (total == 0)
+            {
+                throw std::invalid_argument("No ranking can win round " +
+                    std::to_string(round_index + 1));
+            }
+
+            for (std::size_t pick = round_index; pick < n; ++pick)
+            {
+                const auto winner = draft_order[pick];
+                const auto c = combinations[
+                    static_cast<std::size_t>(winner - 1)];
+
+                if (!eligible(winner) || c == 0)
+                {
+                    continue;
+                }
+
+                auto next = draft_order;
+                move_up(std::span{ next.data(), n }, round_index, winner,
+                    max_jump);
+
+                auto next_winners = winners;
+                next_winners[round_index] = winner;
+
+                add_exact_draws(combinations, rounds, max_jump, next,
+                    round_index + 1, next_winners,
+                    probability * static_cast<double>(c) /
+                        static_cast<double>(total),
+                    visit);
+            }
+        }
+
+        template <typename Visit>
+        constexpr void for_each_exact_draw(
+            std::span<std::size_t const> combinations, std::size_t rounds,
+            int max_jump, Visit visit)
+        {
+            exact_draft_order draft_order{};
+            std::iota(draft_order.begin(), draft_order.begin() +
+                static_cast<std::ptrdiff_t>(combinations.size()), 1);
+
+            add_exact_draws(combinations, rounds, max_jump, draft_order, 0,
+                exact_draft_order{}, 1.0, visit);
+        }
+    }
+
+    // The exact odds of the rules, worked out by the compiler. The pick
+    // table is indexed [ranking - 1][pick - 1] and the round winner table
+    // [round - 1][ranking - 1].
+    template <lottery_rules Rules>
+    inline constexpr auto exact_pick_table = []()
+    {
+        constexpr auto n = Rules::team_count;
+        std::array<std::array<double, n>, n> ret{};
+
+        detail::for_each_exact_draw(Rules::combinations_per_ranking,
+            Rules::rounds, Rules::max_ranking_jump,
+            [&ret](std::span<int const> draft_order, std::span<int const>,
+                double probability)
+            {
+                for (std::size_t pick = 0; pick < draft_order.size(); ++pick)
+                {
+                    ret[static_cast<std::size_t>(draft_order[pick] - 1)]
+                        [pick] += probability;
+                }
+            });
+
+        return ret;
+    }();
+
+    template <lottery_rules Rules>
+    inline constexpr auto exact_round_winner_table = []()
+    {
+        std::array<std::array<double, Rules::team_count>, Rules::rounds>
+            ret{};
+
+        detail::for_each_exact_draw(Rules::combinations_per_ranking,
+            Rules::rounds, Rules::max_ranking_jump,
+            [&ret](std::span<int const>, std::span<int const> winners,
+                double probability)
+            {
+                for (std::size_t round = 0; round < winners.size(); ++round)
+                {
+                    ret[round][static_cast<std::size_t>(winners[round] - 1)] +=
+                        probability;
+                }
+            });
+
+        return ret;
+    }();
+
+    inline constexpr auto const& standard_pick_table{
+        exact_pick_table<standard_rules> };
+    inline constexpr auto const& standard_round_winner_table{
+        exact_round_winner_table<standard_rules> };
+
+    // Enumerates every outcome of the draws instead of sampling them; with
+    // at most 3 draws that's a few thousand sequences of winners, so it's
+    // cheap enough to redo for every tie configuration in a sweep
+    inline pick_odds exact_pick_odds(lottery_format const& format)
+    {
+        format.validate();
+
+        const auto n = format.team_count();
+
+        pick_odds ret{ n, std::vector<double>(n * n) };
+
+        // the standard format is already worked out
+        if (format.rounds == standard_rules::rounds &&
+            format.max_ranking_jump == standard_rules::max_ranking_jump &&
+            std::ranges::equal(format.combinations_per_ranking,
+                standard_rules::combinations_per_ranking))
+        {
+            for (std::size_t r = 0; r < n; ++r)
+            {
+                std::ranges::copy(standard_pick_table[r],
+                    ret.probabilities.begin() +
+                        static_cast<std::ptrdiff_t>(r * n));
+            }
+            return ret;
+        }
+
+        detail::for_each_exact_draw(format.combinations_per_ranking,
+            format.rounds, format.max_ranking_jump,
+            [&ret, n](std::span<int const> draft_order,
+                std::span<int const>, double probability)
+            {
+                for (std::size_t pick = 0; pick < n; ++pick)
+                {
+                    ret.probabilities[static_cast<std::size_t>(
+                        draft_order[pick] - 1) * n + pick] += probability;
+                }
+            });
+
+        return ret;
+    }
+}
@@ -0,0 +1,489 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include "nhl/team.h"
+#include "nhl/io/output_buffer.h"
+#include "nhl/lottery/lottery.h"
+#include "nhl/lottery/round.h"
+#include "nhl/lottery/stats.h"
+
+namespace nhl::lottery
+{
+    enum class export_format
+    {
+        csv,
+        json,
+        binary
+    };
+
+    constexpr std::optional<export_format> parse_export_format(
+        std::string_view name) noexcept
+    {
+        if (name == "csv")
+        {
+            return export_format::csv;
+        }
+        else if (name == "json")
+        {
+            return export_format::json;
+        }
+        else if (name == "binary")
+        {
+            return export_format::binary;
+        }
+
+        return std::nullopt;
+    }
+
+    // Binary layout (little-endian), version 1:
+    //   "NHLS", u16 version, u8 team count, u8 rounds
+    //   u64 simulations, u64 original draft order retained
+    //   u8 team id per ranking (0xff when the teams aren't known)
+    //   per round: u64 redraws, u64 wins per ranking
+    //   u64 count per ranking per pick, ranking-major
+    inline constexpr std::string_view binary_export_magic{ "NHLS" };
+    inline constexpr std::uint16_t binary_export_version{ 1 };
+
+    namespace detail
+    {
+        // 20 digits for a count, 8 for a probability and the keys around
+        // them; every row or object is well under this
+        inline constexpr std::size_t max_export_row_size{ 128 };
+
+        inline std::size_t round_wins(lottery_stats const& stats,
+            round_number round, int ranking)
+        {
+            if (const auto r = stats.round_winner_stats.find(round);
+                r != stats.round_winner_stats.end())
+            {
+                if (const auto w = r->second.find(ranking);
+                    w != r->second.end())
+                {
+                    return w->second;
+                }
+            }
+            return 0;
+        }
+
+        inline std::size_t round_redraws(lottery_stats const& stats,
+            round_number round)
+        {
+            const auto pos = stats.redraws.find(round);
+            return (pos != stats.redraws.end()) ? pos->second : 0;
+        }
+
+        inline std::size_t pick_count(lottery_stats const& stats, int ranking,
+            int pick)
+        {
+            if (const auto p = stats.draft_order_stats.find(pick);
+                p != stats.draft_order_stats.end())
+            {
+                if (const auto c = p->second.find(ranking);
+                    c != p->second.end())
+                {
+                    return c->second;
+                }
+            }
+            return 0;
+        }
+
+        inline std::optional<std::string_view> export_team(
+            lottery_stats const& stats, int ranking)
+        {
+            if (stats.lottery_teams)
+            {
+                return to_string(stats.lottery_teams->team_at(ranking));
+            }
+            return std::nullopt;
+        }
+
+        inline double export_probability(lottery_stats const& stats,
+            std::size_t count)
+        {
+            return (stats.simulations == 0) ? 0.0 :
+                static_cast<double>(count) /
+                static_cast<double>(stats.simulations);
+        }
+
+        // kind,round,ranking,team,pick,count,probability
+        inline void write_stats_csv(lottery_stats const& stats,
+            io::output_buffer& out)
+        {
+            const auto n = static_cast<int>(rankings_count);
+
+            const auto row_end = [&](std::size_t count, bool probability)
+            {
+                out.append_number(count);
+                out.append(',');
+                if (probability)
+                {
+                    out.append_number(export_probability(stats, count), 6);
+                }
+                out.append('\n');
+            };
+
+            const auto ranking_team = [&](int ranking)
+            {
+                out.append_number(ranking);
+                out.append(',');
+                out.append(export_team(stats, ranking).value_or(""));
+                out.append(',');
+            };
+
+            out.append("kind,round,ranking,team,pick,count,probability\n");
+
+            out.append("simulations,,,,,");
+            row_end(stats.simulations, false);
+
+            out.append("retained,,,,,");
+            row_end(stats.original_draft_order_retained, true);
+
+            for (int r = 1; r <= static_cast<int>(stats.rounds); ++r)
+            {
+                const round_number round{ r };
+
+                for (int ranking = 1; ranking <= n; ++ranking)
+                {
+                    out.append("winner,");
+                    out.append_number(r);
+                    out.append(',');
+                    ranking_team(ranking);
+                    out.append(',');
+                    row_end(round_wins(stats, round, ranking), true);
+                }
+
+                out.append("redraws,");
+                out.append_number(r);
+                out.append(",,,,");
+                row_end(round_redraws(stats, round), false);
+            }
+
+            for (int ranking = 1; ranking <= n; ++ranking)
+            {
+                for (int pick = 1; pick <= n; ++pick)
+                {
+                    out.append("pick,,");
+                    ranking_team(ranking);
+                    out.append_number(pick);
+                    out.append(',');
+                    row_end(pick_count(stats, ranking, pick), true);
+                }
+            }
+        }
+
+        inline void write_stats_json(lottery_stats const& stats,
+            io::output_buffer& out)
+        {
+            const auto n = static_cast<int>(rankings_count);
+
+            const auto team = [&](int ranking)
+            {
+                out.append(",\"team\":");
+                if (const auto t = export_team(stats, ranking))
+                {
+                    out.append('"');
+                    out.append(*t);
+                    out.append('"');
+                }
+                else
+                {
+                    out.append("null");
+                }
+            };
+
+            out.append("{\"simulations\":");
+            out.append_number(stats.simulations);
+            out.append(",\"rounds\":");
+            out.append_number(stats.rounds);
+            out.append(",\"original_draft_order_retained\":");
+            out.append_number(stats.original_draft_order_retained);
+
+            out.append(",\"round_winners\":[");
+            for (int r = 1; r <= static_cast<int>(stats.rounds); ++r)
+            {
+                const round_number round{ r };
+
+                out.append((r > 1) ? ",{\"round\":" : "{\"round\":");
+                out.append_number(r);
+                out.append(",\"redraws\":");
+                out.append_number(round_redraws(stats, round));
+                out.append(",\"wins\":[");
+
+                for (int ranking = 1; ranking <= n; ++ranking)
+                {
+                    out.append((ranking > 1) ? ",{\"ranking\":" :
+                        "{\"ranking\":");
+                    out.append_number(ranking);
+                    team(ranking);
+                    out.append(",\"count\":");
+                    out.append_number(round_wins(stats, round, ranking));
+                    out.append('}');
+                }
+
+                out.append("]}");
+            }
+
+            // picks[p - 1] is the count of pick p
+            out.append("],\"draft_order\":[");
+            for (int ranking = 1; ranking <= n; ++ranking)
+            {
+                out.append((ranking > 1) ? ",{\"ranking\":" : "{\"ranking\":");
+                out.append_number(ranking);
+                team(ranking);
+                out.append(",\"picks\":[");
+
+                for (int pick = 1; pick <= n; ++pick)
+                {
+                    if (pick > 1)
+                    {
+                        out.append(',');
+                    }
+                    out.append_number(pick_count(stats, ranking, pick));
+                }
+
+                out.append("]}");
+            }
+
+            out.append("]}\n");
+        }
+
+        inline void write_stats_binary(lottery_stats const& stats,
+            io::output_buffer& out)
+        {
+            const auto n = static_cast<int>(rankings_count);
+
+            out.append(binary_export_magic);
+            out.append_le(binary_export_version);
+            out.append_le(static_cast<std::uint8_t>(n));
+            out.append_le(static_cast<std::uint8_t>(stats.rounds));
+            out.append_le(std::uint64_t{ stats.simulations });
+            out.append_le(std::uint64_t{
+                stats.original_draft_order_retained });
+
+            for (int ranking = 1; ranking <= n; ++ranking)
+            {
+                out.append_le(stats.lottery_teams ?
+                    static_cast<std::uint8_t>(
+                        stats.lottery_teams->team_at(ranking)) :
+                    std::uint8_t{ 0xff });
+            }
+
+            for (int r = 1; r <= static_cast<int>(stats.rounds); ++r)
+            {
+                const round_number round{ r };
+
+                out.append_le(std::uint64_t{ round_redraws(stats, round) });
+                for (int ranking = 1; ranking <= n; ++ranking)
+                {
+                    out.append_le(std::uint64_t{
+                        round_wins(stats, round, ranking) });
+                }
+            }
+
+            for (int ranking = 1; ranking <= n; ++ranking)
+            {
+                for (int pick = 1; pick <= n; ++pick)
+                {
+                    out.append_le(std::uint64_t{
+                        pick_count(stats, ranking, pick) });
+                }
+            }
+        }
+    }
+
+    namespace detail
+    {
+        // Reads the little-endian values of a binary export in order
+        class binary_stats_reader
+        {
+        public:
+            explicit binary_stats_reader(std::string_view bytes) noexcept :
+                bytes_{ bytes }
+            {
+            }
+
+            template <std::unsigned_integral T>
+            T read()
+            {
+                if (bytes_.size() < sizeof(T))
+                {
+                    throw std::runtime_error("Truncated stats");
+                }
+
+                T ret{ 0 };
+                for (std::size_t i = 0; i < sizeof(T); ++i)
+                {
+                    ret |= static_cast<T>(T{ static_cast<std::uint8_t>(
+                        bytes_[i]) } << (8 * i));
+                }
+
+                bytes_.remove_prefix(sizeof(T));
+                return ret;
+            }
+
+            std::string_view read_bytes(std::size_t n)
+            {
+                if (bytes_.size() < n)
+                {
+                    throw std::runtime_error("Truncated stats");
+                }
+
+                const auto ret = bytes_.substr(0, n);
+                bytes_.remove_prefix(n);
+                return ret;
+            }
+
+            bool empty() const noexcept
+            {
+                return bytes_.empty();
+            }
+
+        private:
+            std::string_view bytes_;
+        };
+    }
+
+    // The stats of a binary export (see write_stats). The teams come back
+    // without their tie groups, which the format doesn't keep, and only the
+    // counts that aren't 0 are added, as record adds them.
+    inline lottery_stats parse_binary_stats(std::string_view bytes)
+    {
+        detail::binary_stats_reader in{ bytes };
+
+        if (in.read_bytes(binary_export_magic.size()) != binary_export_magic)
+        {
+            throw std::runtime_error("Not a stats file");
+        }
+
+        if (in.read<std::uint16_t>() != binary_export_version)
+        {
+            throw std::runtime_error("Unsupported stats version");
+        }
+
+        const auto n = static_cast<int>(in.read<std::uint8_t>());
+        const auto rounds = in.read<std::uint8_t>();
+
+        if (n != static_cast<int>(rankings_count) || rounds < 1 ||
+            rounds > max_lottery_rounds)
+        {
+            throw std::runtime_error("Invalid stats header");
+        }
+
+        lottery_stats ret{ .simulations = in.read<std::uint64_t>(),
+            .rounds = rounds };
+        ret.original_draft_order_retained = in.read<std::uint64_t>();
+
+        lottery_teams::teams_type teams{};
+        bool known_teams{ true };
+
+        for (int ranking = 1; ranking <= n; ++ranking)
+        {
+            const auto id = in.read<std::uint8_t>();
+            known_teams = known_teams && id != 0xff;
+            teams[static_cast<std::size_t>(ranking - 1)] = { ranking,
+                static_cast<team_id>(id) };
+        }
+
+        if (known_teams)
+        {
+            ret.lottery_teams = lottery_teams{ teams };
+        }
+
+        for (int r = 1; r <= static_cast<int>(rounds); ++r)
+        {
+            const round_number round{ r };
+
+            if (const auto redraws = in.read<std::uint64_t>(); redraws > 0)
+            {
+                ret.redraws[round] = redraws;
+            }
+
+            for (int ranking = 1; ranking <= n; ++ranking)
+            {
+                if (const auto wins = in.read<std::uint64_t>(); wins > 0)
+                {
+                    ret.round_winner_stats[round][ranking] = wins;
+                }
+            }
+        }
+
+        for (int ranking = 1; ranking <= n; ++ranking)
+        {
+            for (int pick = 1; pick <= n; ++pick)
+            {
+                if (const auto count = in.read<std::uint64_t>(); count > 0)
+                {
+                    ret.draft_order_stats[pick][ranking] = count;
+                }
+            }
+        }
+
+        if (!in.empty())
+        {
+            throw std::runtime_error("Trailing bytes after the stats");
+        }
+
+        return ret;
+    }
+
+    // An upper bound on the size of the export. It depends on the number of
+    // rounds and teams, not on the number of simulations.
+    inline std::size_t export_size(lottery_stats const& stats,
+        export_format format) noexcept
+    {
+        const auto n = rankings_count;
+
+        if (format == export_format::binary)
+        {
+            return binary_export_magic.size() + 2 + 1 + 1 + 8 + 8 + n +
+                stats.rounds * (n + 1) * 8 + n * n * 8;
+        }
+
+        // a row (or object) per count, and a few more for the totals
+        const auto rows = 4 + stats.rounds * (n + 1) + n * n;
+        return rows * detail::max_export_row_size;
+    }
+
+    // Writes the stats to the end of out. The cost only depends on the size
+    // of the tables.
+    inline void write_stats(lottery_stats const& stats, export_format format,
+        io::output_buffer& out)
+    {
+        switch (format)
+        {
+        case export_format::csv:
+            detail::write_stats_csv(stats, out);
+            break;
+        case export_format::json:
+            detail::write_stats_json(stats, out);
+            break;
+        case export_format::binary:
+            detail::write_stats_binary(stats, out);
+            break;
+        }
+    }
+
+    // Writes the stats to a file, or to stdout when path is empty, through
+    // one buffer sized with export_size
+    inline void export_stats(lottery_stats const& stats, export_format format,
+        std::filesystem::path const& path = {})
+    {
+        io::output_buffer out{ export_size(stats, format) };
+        write_stats(stats, format, out);
+
+        if (path.empty())
+        {
+            out.write_to(stdout);
+        }
+        else
+        {
+            out.write_to(path);
+        }
+    }
+}
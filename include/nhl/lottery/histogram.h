@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include "nhl/lottery/packed_draft_order.h"
+
+namespace nhl::lottery
+{
+    // How often each distinct key came up, in one flat array: open addressing
+    // with linear probing, kept at most half full. A slot with a count of 0
+    // is empty, so every key value can be counted.
+    template <typename Key, typename Hash = std::hash<Key>>
+    class flat_histogram
+    {
+    public:
+        struct entry
+        {
+            Key key{};
+            std::size_t count{ 0 };
+        };
+
+        flat_histogram() :
+            entries_(std::size_t{ 1 } << initial_bits),
+            shift_{ 64 - initial_bits }
+        {
+        }
+
+        void add(Key const& key, std::size_t count = 1)
+        {
+            if (count == 0)
+            {
+                return;
+            }
+
+            if ((size_ + 1) * 2 > entries_.size())
+            {
+                grow();
+            }
+
+            auto& e = entries_[index_of(key)];
+            if (e.count == 0)
+            {
+                e.key = key;
+                ++size_;
+            }
+
+            e.count += count;
+            total_ += count;
+        }
+
+        std::size_t count(Key const& key) const noexcept
+        {
+            return entries_[index_of(key)].count;
+        }
+
+        // The number of distinct keys
+        std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        // The sum of the counts
+        std::size_t total() const noexcept
+        {
+            return total_;
+        }
+
+        // Calls f(key, count) for each distinct key, in no particular order
+        template <typename F>
+        void for_each(F&& f) const
+        {
+            for (auto const& e : entries_)
+            {
+                if (e.count > 0)
+                {
+                    f(e.key, e.count);
+                }
+            }
+        }
+
+        // The most frequent keys first; equal counts are ordered by key
+        std::vector<entry> sorted() const
+        {
+            std::vector<entry> ret;
+            ret.reserve(size_);
+
+            for_each([&ret](Key const& key, std::size_t count)
+                {
+                    ret.push_back({ key, count });
+                });
+
+            std::ranges::sort(ret, [](entry const& a, entry const& b)
+                {
+                    return (a.count != b.count) ? (a.count > b.count) :
+                        (a.key < b.key);
+                });
+
+            return ret;
+        }
+
+        flat_histogram& operator+=(flat_histogram const& rhs)
+        {
+            rhs.for_each([this](Key const& key, std::size_t count)
+                {
+                    add(key, count);
+                });
+            return *this;
+        }
+
+    private:
+        static constexpr int initial_bits{ 8 };
+
+        // Fibonacci hashing, so keys that only differ in their high bits
+        // (e.g. the late picks of a packed order) still spread out
+        std::size_t slot(Key const& key) const noexcept
+        {
+            const auto h = static_cast<std::uint64_t>(Hash{}(key));
+            return static_cast<std::size_t>(
+                (h * 0x9e37'79b9'7f4a'7c15ull) >> shift_);
+        }
+
+        // The key's slot, or the empty slot it would go in
+        std::size_t index_of(Key const& key) const noexcept
+        {
+            const auto mask = entries_.size() - 1;
+
+            for (auto i = slot(key);; i = (i + 1) & mask)
+            {
+                if (entries_[i].count == 0 || entries_[i].key == key)
+                {
+                    return i;
+                }
+            }
+        }
+
+        void grow()
+        {
+            auto old = std::exchange(entries_,
+                std::vector<entry>(entries_.size() * 2));
+            --shift_;
+
+            for (auto const& e : old)
+            {
+                if (e.count > 0)
+                {
+                    entries_[index_of(e.key)] = e;
+                }
+            }
+        }
+
+        std::vector<entry> entries_;
+        int shift_;
+        std::size_t size_{ 0 };
+        std::size_t total_{ 0 };
+    };
+
+    // Every distinct complete draft order and how often it came up
+    using draft_order_histogram = flat_histogram<packed_draft_order>;
+}
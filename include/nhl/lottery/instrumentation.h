@@ -0,0 +1,287 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "nhl/print.h"
+
+#if defined(NHL_ENABLE_INSTRUMENTATION)
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64)
+#include <intrin.h>
+#endif
+#endif
+
+// Counters and stage timers for the draw loop. Define
+// NHL_ENABLE_INSTRUMENTATION (the CMake option of the same name) to turn them
+// on; otherwise every call below is an empty inline function and the timers
+// are empty objects, so nothing is left in the build.
+namespace nhl::lottery::instrumentation
+{
+#if defined(NHL_ENABLE_INSTRUMENTATION)
+    inline constexpr bool enabled{ true };
+#else
+    inline constexpr bool enabled{ false };
+#endif
+
+    enum class counter
+    {
+        lotteries,          // run_draw calls
+        attempts,           // combinations drawn
+        balls_drawn,
+        lookups,
+        redraws_unassigned,
+        redraws_previous_winner,
+        redraws_locked_in,
+        moves,              // winners moved up the draft order
+        table_populates,
+        count_
+    };
+
+    inline constexpr std::array<std::string_view,
+        static_cast<std::size_t>(counter::count_)> counter_names
+    {
+        "lotteries", "attempts", "balls drawn", "lookups",
+        "redraws (unassigned)", "redraws (previous winner)",
+        "redraws (locked in)", "moves", "table populates"
+    };
+
+    enum class stage
+    {
+        populate,       // shuffling a combination table
+        rng,            // picking a ball
+        ball_removal,   // taking it out of the machine
+        lookup,         // combination -> ranking
+        placement,      // the eligibility checks and the move up
+        record,         // updating lottery_stats
+        count_
+    };
+
+    inline constexpr std::array<std::string_view,
+        static_cast<std::size_t>(stage::count_)> stage_names
+    {
+        "populate", "rng", "ball removal", "lookup", "placement", "record"
+    };
+
+    // One in this many scopes of each stage is timed
+    inline constexpr std::uint64_t sample_interval{ 64 };
+    static_assert((sample_interval & (sample_interval - 1)) == 0);
+
+    // The counts of one thread. Threads only write their own, so there's no
+    // synchronization on the hot path.
+    struct thread_counters
+    {
+        std::array<std::uint64_t, static_cast<std::size_t>(counter::count_)>
+            counters{};
+
+        // calls, timed calls and the ticks of the timed calls per stage
+        std::array<std::uint64_t, static_cast<std::size_t>(stage::count_)>
+            stage_calls{};
+        std::array<std::uint64_t, static_cast<std::size_t>(stage::count_)>
+            stage_samples{};
+        std::array<std::uint64_t, static_cast<std::size_t>(stage::count_)>
+            stage_ticks{};
+
+        thread_counters& operator+=(thread_counters const& rhs) noexcept
+        {
+            for (std::size_t i = 0; i < counters.size(); ++i)
+            {
+                counters[i] += rhs.counters[i];
+            }
+            for (std::size_t i = 0; i < stage_calls.size(); ++i)
+            {
+                stage_calls[i] += rhs.stage_calls[i];
+                stage_samples[i] += rhs.stage_samples[i];
+                stage_ticks[i] += rhs.stage_ticks[i];
+            }
+            return *this;
+        }
+    };
+
+    namespace detail
+    {
+        // Every thread's counters, kept alive after the thread exits so
+        // pool workers can be summed once the pool is gone
+        struct registry
+        {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<thread_counters>> threads;
+        };
+
+        inline registry& global_registry()
+        {
+            static registry ret;
+            return ret;
+        }
+
+        inline thread_counters& register_thread()
+        {
+            auto counters = std::make_shared<thread_counters>();
+
+            auto& r = global_registry();
+            const std::scoped_lock lock{ r.mutex };
+            r.threads.push_back(counters);
+
+            return *counters;
+        }
+
+        // A constant-initialized pointer, so the hot path doesn't pay for a
+        // thread_local guard
+        inline thread_counters& local()
+        {
+            thread_local thread_counters* counters{ nullptr };
+
+            if (counters == nullptr) [[unlikely]]
+            {
+                counters = &register_thread();
+            }
+
+            return *counters;
+        }
+
+#if defined(NHL_ENABLE_INSTRUMENTATION)
+        inline std::uint64_t read_ticks() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>(
+                std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+        }
+#endif
+    }
+
+    inline void count([[maybe_unused]] counter c,
+        [[maybe_unused]] std::uint64_t n = 1) noexcept
+    {
+        if constexpr (enabled)
+        {
+            detail::local().counters[static_cast<std::size_t>(c)] += n;
+        }
+    }
+
+#if defined(NHL_ENABLE_INSTRUMENTATION)
+    // Counts a call of the stage and times one in sample_interval of them
+    class stage_timer
+    {
+    public:
+        explicit stage_timer(stage s) noexcept :
+            counters_{ detail::local() },
+            stage_{ static_cast<std::size_t>(s) }
+        {
+            if ((counters_.stage_calls[stage_]++ & (sample_interval - 1)) ==
+                0)
+            {
+                start_ = detail::read_ticks();
+            }
+        }
+
+        stage_timer(stage_timer const&) = delete;
+        stage_timer& operator=(stage_timer const&) = delete;
+
+        ~stage_timer()
+        {
+            if (start_ != 0)
+            {
+                counters_.stage_ticks[stage_] += detail::read_ticks() - start_;
+                ++counters_.stage_samples[stage_];
+            }
+        }
+
+    private:
+        thread_counters& counters_;
+        std::size_t stage_;
+        std::uint64_t start_{ 0 };
+    };
+#else
+    class stage_timer
+    {
+    public:
+        explicit constexpr stage_timer(stage) noexcept {}
+    };
+#endif
+
+    // The sum over every thread. Only call it while no draws are running.
+    inline thread_counters totals()
+    {
+        thread_counters ret;
+
+        auto& r = detail::global_registry();
+        const std::scoped_lock lock{ r.mutex };
+        for (auto const& t : r.threads)
+        {
+            ret += *t;
+        }
+
+        return ret;
+    }
+
+    inline void reset()
+    {
+        auto& r = detail::global_registry();
+        const std::scoped_lock lock{ r.mutex };
+        for (auto const& t : r.threads)
+        {
+            *t = {};
+        }
+    }
+
+    // The counters, then each stage's estimated share of the timed ticks
+    // (the average of its samples times its calls)
+    inline void print_breakdown()
+    {
+        if constexpr (!enabled)
+        {
+            return;
+        }
+
+        const auto t = totals();
+
+        temp::println("[ Instrumentation ]");
+        temp::println("");
+
+        for (std::size_t i = 0; i < t.counters.size(); ++i)
+        {
+            temp::println("{:<26} {:>14}", counter_names[i], t.counters[i]);
+        }
+        temp::println("");
+
+        std::array<double, static_cast<std::size_t>(stage::count_)>
+            estimated{};
+        double total_ticks{ 0.0 };
+
+        for (std::size_t i = 0; i < estimated.size(); ++i)
+        {
+            if (t.stage_samples[i] > 0)
+            {
+                estimated[i] = static_cast<double>(t.stage_ticks[i]) /
+                    static_cast<double>(t.stage_samples[i]) *
+                    static_cast<double>(t.stage_calls[i]);
+                total_ticks += estimated[i];
+            }
+        }
+
+        temp::println("{:<14} {:>14} {:>12} {:>7}", "Stage", "Calls",
+            "Ticks/call", "Share");
+
+        for (std::size_t i = 0; i < estimated.size(); ++i)
+        {
+            const auto per_call = (t.stage_samples[i] > 0) ?
+                static_cast<double>(t.stage_ticks[i]) /
+                static_cast<double>(t.stage_samples[i]) : 0.0;
+            const auto share = (total_ticks > 0.0) ?
+                estimated[i] / total_ticks * 100.0 : 0.0;
+
+            temp::println("{:<14} {:>14} {:>12.1f} {:>6.1f}%", stage_names[i],
+                t.stage_calls[i], per_call, share);
+        }
+
+        temp::println("");
+    }
+}
@@ -0,0 +1,440 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "nhl/team.h"
+#include "nhl/thread_pool.h"
+#include "nhl/lottery/batch.h"
+#include "nhl/lottery/histogram.h"
+#include "nhl/lottery/lottery.h"
+#include "nhl/lottery/packed_draft_order.h"
+#include "nhl/lottery/round.h"
+#include "nhl/lottery/rules.h"
+#include "nhl/lottery/teams.h"
+
+namespace nhl::lottery
+{
+    // A complete draft order and the ranking that won each round. The winners
+    // are kept because the order alone doesn't always say who won what (e.g.
+    // the 13th then the 2nd and the 1st then the 13th both give 1, 2, 13, 3).
+    struct lottery_outcome
+    {
+        packed_draft_order draft_order;
+
+        // the winner of round r, minus 1, in bits [4 * (r - 1), 4 * r)
+        std::uint16_t winners{ 0 };
+
+        constexpr int winner(round_number round) const noexcept
+        {
+            const auto shift = 4 * (static_cast<int>(round) - 1);
+            return ((winners >> shift) & 0xf) + 1;
+        }
+
+        constexpr auto operator<=>(lottery_outcome const&) const = default;
+    };
+
+    static_assert(max_lottery_rounds * 4 <= 16, "The winners are 16 bits");
+}
+
+template <>
+struct std::hash<nhl::lottery::lottery_outcome>
+{
+    std::size_t operator()(nhl::lottery::lottery_outcome const& outcome) const
+        noexcept
+    {
+        return std::hash<std::uint64_t>{}(outcome.draft_order.word() ^
+            std::rotr(std::uint64_t{ outcome.winners }, 16));
+    }
+};
+
+namespace nhl::lottery
+{
+    using outcome_histogram = flat_histogram<lottery_outcome>;
+
+    // Draws the format draws times and counts each outcome, like
+    // count_draft_orders
+    inline outcome_histogram count_outcomes(lottery_format const& format,
+        std::size_t draws, std::uint64_t seed, thread_pool& pool)
+    {
+        if (format.team_count() > packed_draft_order::max_size)
+        {
+            throw std::out_of_range("Too many teams to count outcomes");
+        }
+
+        const format_combination_table tables[]{ format_combination_table{
+            format } };
+
+        auto ret = run_batch(std::span{ tables }, draws, seed, pool,
+            std::vector<outcome_histogram>(1),
+            [](outcome_histogram& result, std::size_t,
+                format_draw_result const& draw)
+            {
+                lottery_outcome outcome{ packed_draft_order{
+                    draw.draft_order() } };
+
+                for (std::size_t r = 0; r < draw.rounds; ++r)
+                {
+                    outcome.winners |= static_cast<std::uint16_t>(
+                        (draw.winners[r] - 1) << (4 * r));
+                }
+
+                result.add(outcome);
+            });
+
+        return std::move(ret.front());
+    }
+
+    // One condition on an outcome: the ranking's pick is in [first, last],
+    // or the ranking won round first
+    struct outcome_condition
+    {
+        enum class kind
+        {
+            pick,
+            won_round
+        };
+
+        kind type{ kind::pick };
+        int ranking{ 0 };
+        int first{ 0 };
+        int last{ 0 };
+    };
+
+    constexpr outcome_condition pick_between(int ranking, int first_pick,
+        int last_pick) noexcept
+    {
+        return { outcome_condition::kind::pick, ranking, first_pick,
+            last_pick };
+    }
+
+    constexpr outcome_condition pick_at(int ranking, int pick) noexcept
+    {
+        return pick_between(ranking, pick, pick);
+    }
+
+    constexpr outcome_condition won_round(int ranking,
+        round_number round) noexcept
+    {
+        const auto r = static_cast<int>(round);
+        return { outcome_condition::kind::won_round, ranking, r, r };
+    }
+
+    // Joint and conditional probabilities over counted outcomes. Each
+    // (ranking, pick or better) and (ranking, round won) gets a bitset over
+    // the distinct outcomes up front, so a query is an AND of a few bitsets
+    // and a sum of the counts of the outcomes left, no matter how many draws
+    // were counted.
+    class joint_outcomes
+    {
+    public:
+        using condition_list = std::span<outcome_condition const>;
+
+        joint_outcomes(outcome_histogram const& outcomes,
+            std::size_t team_count, std::size_t rounds,
+            std::optional<lottery_teams> teams = std::nullopt) :
+            team_count_{ team_count },
+            rounds_{ rounds },
+            teams_{ std::move(teams) }
+        {
+            if (team_count_ > packed_draft_order::max_size ||
+                rounds_ > max_lottery_rounds || rounds_ >= team_count_)
+            {
+                throw std::out_of_range("Invalid outcome format");
+            }
+
+            const auto sorted = outcomes.sorted();
+
+            words_ = (sorted.size() + 63) / 64;
+            counts_.reserve(sorted.size());
+            picks_.resize(sorted.size() * team_count_);
+            pick_or_better_.resize(team_count_ * team_count_ * words_);
+            won_round_.resize(team_count_ * rounds_ * words_);
+
+            for (std::size_t i = 0; i < sorted.size(); ++i)
+            {
+                auto const& [outcome, count] = sorted[i];
+
+                counts_.push_back(count);
+                total_ += count;
+
+                const auto word = i / 64;
+                const auto bit = std::uint64_t{ 1 } << (i % 64);
+
+                for (std::size_t p = 0; p < team_count_; ++p)
+                {
+                    const auto r = static_cast<std::size_t>(
+                        outcome.draft_order[p] - 1);
+
+                    picks_[i * team_count_ + r] =
+                        static_cast<std::uint8_t>(p + 1);
+
+                    for (auto q = p; q < team_count_; ++q)
+                    {
+                        pick_or_better_[(r * team_count_ + q) * words_ +
+                            word] |= bit;
+                    }
+                }
+
+                for (std::size_t round = 1; round <= rounds_; ++round)
+                {
+                    const auto r = static_cast<std::size_t>(outcome.winner(
+                        round_number{ static_cast<int>(round) }) - 1);
+
+                    won_round_[(r * rounds_ + round - 1) * words_ + word] |=
+                        bit;
+                }
+            }
+        }
+
+        // The number of distinct outcomes
+        std::size_t size() const noexcept
+        {
+            return counts_.size();
+        }
+
+        // The number of draws
+        std::size_t total() const noexcept
+        {
+            return total_;
+        }
+
+        // The team's ranking, for building conditions by team
+        int ranking_of(team_id team) const
+        {
+            if (!teams_)
+            {
+                throw std::invalid_argument("The teams aren't known");
+            }
+
+            if (const auto ranking = teams_->ranking_of(team))
+            {
+                return *ranking;
+            }
+
+            throw std::invalid_argument(std::string{ to_string(team) } +
+                " isn't in the lottery");
+        }
+
+        // The number of draws meeting every condition
+        std::size_t count(condition_list all) const
+        {
+            return sum(mask_of(all));
+        }
+
+        double probability(condition_list all) const
+        {
+            return static_cast<double>(count(all)) /
+                static_cast<double>(total_);
+        }
+
+        double probability(std::initializer_list<outcome_condition> all) const
+        {
+            return probability(condition_list{ all.begin(), all.size() });
+        }
+
+        // P(event | given), or nullopt if given never happened
+        std::optional<double> conditional(condition_list event,
+            condition_list given) const
+        {
+            auto mask = mask_of(given);
+
+            const auto given_count = sum(mask);
+            if (given_count == 0)
+            {
+                return std::nullopt;
+            }
+
+            for (auto const& c : event)
+            {
+                apply(c, mask);
+            }
+
+            return static_cast<double>(sum(mask)) /
+                static_cast<double>(given_count);
+        }
+
+        std::optional<double> conditional(
+            std::initializer_list<outcome_condition> event,
+            std::initializer_list<outcome_condition> given) const
+        {
+            return conditional(condition_list{ event.begin(), event.size() },
+                condition_list{ given.begin(), given.size() });
+        }
+
+        // The odds of each pick for the ranking given the conditions (index
+        // 0 is pick 1), or nullopt if given never happened
+        std::optional<std::vector<double>> conditional_pick_odds(int ranking,
+            condition_list given) const
+        {
+            check_ranking(ranking);
+
+            const auto mask = mask_of(given);
+
+            std::vector<std::size_t> counts(team_count_);
+            std::size_t given_count{ 0 };
+
+            for_each_outcome(mask, [&](std::size_t i)
+                {
+                    counts[picks_[i * team_count_ +
+                        static_cast<std::size_t>(ranking - 1)] - 1u] +=
+                        counts_[i];
+                    given_count += counts_[i];
+                });
+
+            if (given_count == 0)
+            {
+                return std::nullopt;
+            }
+
+            std::vector<double> ret;
+            ret.reserve(team_count_);
+            for (auto c : counts)
+            {
+                ret.push_back(static_cast<double>(c) /
+                    static_cast<double>(given_count));
+            }
+            return ret;
+        }
+
+        std::optional<std::vector<double>> conditional_pick_odds(int ranking,
+            std::initializer_list<outcome_condition> given) const
+        {
+            return conditional_pick_odds(ranking,
+                condition_list{ given.begin(), given.size() });
+        }
+
+    private:
+        using mask_type = std::vector<std::uint64_t>;
+
+        void check_ranking(int ranking) const
+        {
+            if (ranking < 1 || static_cast<std::size_t>(ranking) > team_count_)
+            {
+                throw std::out_of_range("Invalid ranking");
+            }
+        }
+
+        // The bits of the outcomes meeting every condition
+        mask_type mask_of(condition_list all) const
+        {
+            mask_type ret(words_, ~std::uint64_t{ 0 });
+            if (const auto tail = counts_.size() % 64; tail != 0)
+            {
+                ret.back() = (std::uint64_t{ 1 } << tail) - 1;
+            }
+
+            for (auto const& c : all)
+            {
+                apply(c, ret);
+            }
+
+            return ret;
+        }
+
+        void apply(outcome_condition const& c, mask_type& mask) const
+        {
+            check_ranking(c.ranking);
+            const auto r = static_cast<std::size_t>(c.ranking - 1);
+
+            if (c.type == outcome_condition::kind::won_round)
+            {
+                if (c.first < 1 || static_cast<std::size_t>(c.first) > rounds_)
+                {
+                    throw std::out_of_range("Invalid round");
+                }
+
+                const auto won = won_round_.data() +
+                    (r * rounds_ + static_cast<std::size_t>(c.first - 1)) *
+                    words_;
+
+                for (std::size_t w = 0; w < words_; ++w)
+                {
+                    mask[w] &= won[w];
+                }
+                return;
+            }
+
+            if (c.first < 1 || c.last < c.first ||
+                static_cast<std::size_t>(c.last) > team_count_)
+            {
+                throw std::out_of_range("Invalid pick range");
+            }
+
+            // [first, last] = (last or better) minus (first - 1 or better)
+            const auto at_or_before = [&](int pick)
+            {
+                return pick_or_better_.data() + (r * team_count_ +
+                    static_cast<std::size_t>(pick - 1)) * words_;
+            };
+
+            const auto last = at_or_before(c.last);
+
+            if (c.first == 1)
+            {
+                for (std::size_t w = 0; w < words_; ++w)
+                {
+                    mask[w] &= last[w];
+                }
+            }
+            else
+            {
+                const auto before = at_or_before(c.first - 1);
+                for (std::size_t w = 0; w < words_; ++w)
+                {
+                    mask[w] &= last[w] & ~before[w];
+                }
+            }
+        }
+
+        template <typename F>
+        static void for_each_outcome(mask_type const& mask, F&& f)
+        {
+            for (std::size_t w = 0; w < mask.size(); ++w)
+            {
+                for (auto bits = mask[w]; bits != 0; bits &= bits - 1)
+                {
+                    f(w * 64 + static_cast<std::size_t>(
+                        std::countr_zero(bits)));
+                }
+            }
+        }
+
+        std::size_t sum(mask_type const& mask) const
+        {
+            std::size_t ret{ 0 };
+            for_each_outcome(mask, [&](std::size_t i)
+                {
+                    ret += counts_[i];
+                });
+            return ret;
+        }
+
+        std::size_t team_count_;
+        std::size_t rounds_;
+        std::optional<lottery_teams> teams_;
+
+        std::size_t words_{ 0 };
+        std::size_t total_{ 0 };
+
+        // [outcome]
+        std::vector<std::size_t> counts_;
+
+        // [outcome * team_count + (ranking - 1)] -> pick
+        std::vector<std::uint8_t> picks_;
+
+        // [((ranking - 1) * team_count + (pick - 1)) * words + word], the
+        // outcomes where the ranking has the pick or a better one
+        std::vector<std::uint64_t> pick_or_better_;
+
+        // [((ranking - 1) * rounds + (round - 1)) * words + word]
+        std::vector<std::uint64_t> won_round_;
+    };
+}
@@ -6,9 +6,12 @@
 namespace nhl::lottery
 {
     inline constexpr std::size_t lottery_rounds{ 2 };
+    inline constexpr std::size_t max_lottery_rounds{ 3 };
+    static_assert(lottery_rounds <= max_lottery_rounds);
     inline constexpr std::size_t balls_to_draw{ 4 };
 
     inline constexpr std::size_t team_count{ 16 };
+    inline constexpr std::size_t max_team_count{ 32 };
     inline constexpr std::size_t rankings_count{ team_count };
     inline constexpr int max_ranking_jump{ 10 };
     static_assert(std::cmp_less(max_ranking_jump, rankings_count));
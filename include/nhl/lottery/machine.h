@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <random>
 #include "nhl/lottery/ball.h"
+#include "nhl/lottery/instrumentation.h"
 
 namespace nhl::lottery
 {
@@ -32,6 +33,12 @@ namespace nhl::lottery
             static std::random_device rd;
             static std::mt19937 gen{rd()};
 
+            return draw_ball(gen);
+        }
+
+        template <std::uniform_random_bit_generator URBG>
+        ball draw_ball(URBG& gen)
+        {
             const auto balls_remaining = balls_.size();
 
             if (balls_remaining == 0)
@@ -39,8 +46,13 @@ namespace nhl::lottery
                 throw std::runtime_error("There are no balls in the machine");
             }
 
+            instrumentation::count(instrumentation::counter::balls_drawn);
+
             const auto index = [&]() -> std::size_t
             {
+                const instrumentation::stage_timer timer{
+                    instrumentation::stage::rng };
+
                 if (balls_remaining > 1)
                 {
                     std::uniform_int_distribution<std::size_t> ball_dist{ 0,
@@ -52,6 +64,9 @@ namespace nhl::lottery
                 return 0;
             }();
 
+            const instrumentation::stage_timer timer{
+                instrumentation::stage::ball_removal };
+
             auto ret = balls_[index];
             std::erase(balls_, ret);
             return ret;
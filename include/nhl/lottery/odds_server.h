@@ -0,0 +1,643 @@
+#pragma once
+
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include "nhl/lru_cache.h"
+#include "nhl/random.h"
+#include "nhl/team.h"
+#include "nhl/thread_pool.h"
+#include "nhl/io/output_buffer.h"
+#include "nhl/lottery/batch.h"
+#include "nhl/lottery/exact_odds.h"
+#include "nhl/lottery/ranking_combinations.h"
+#include "nhl/lottery/scenario.h"
+#include "nhl/lottery/ties.h"
+
+namespace nhl::lottery
+{
+    enum class odds_query_kind
+    {
+        exact,      // exact_pick_odds
+        simulate,   // run_scenarios
+        stats       // the server's cache counters
+    };
+
+    inline constexpr std::size_t default_query_draws{ 100'000 };
+
+    // The simulations run one at a time and can't be stopped, so one query
+    // can't hold up the others for more than a few seconds
+    inline constexpr std::size_t max_query_draws{ 10'000'000 };
+
+    // One line of the server protocol (see parse_odds_query)
+    struct odds_query
+    {
+        std::string id;
+        odds_query_kind kind{ odds_query_kind::exact };
+        lottery::scenario scenario;
+        std::size_t draws{ default_query_draws };
+        std::optional<std::uint64_t> seed;
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        T parse_query_number(std::string_view text, std::string_view key)
+        {
+            T ret{};
+            const auto last = text.data() + text.size();
+            if (const auto [p, ec] = std::from_chars(text.data(), last, ret);
+                ec != std::errc{} || p != last)
+            {
+                throw std::invalid_argument(fmt::format("Invalid value for "
+                    "'{}'", key));
+            }
+            return ret;
+        }
+
+        // Calls f with each piece of text between the separators, empty
+        // pieces included
+        template <typename F>
+        void for_each_field(std::string_view text, char separator, F f)
+        {
+            while (true)
+            {
+                const auto pos = text.find(separator);
+                f(text.substr(0, pos));
+
+                if (pos == std::string_view::npos)
+                {
+                    return;
+                }
+                text.remove_prefix(pos + 1);
+            }
+        }
+
+        // Teams in ranking order separated by ',', with tied teams joined by
+        // '=' (i.e. "ANA,CBJ=CHI,SJS")
+        inline void parse_query_order(std::string_view text, scenario& s,
+            std::vector<tie_group>& ties)
+        {
+            for_each_field(text, ',', [&](std::string_view group)
+            {
+                const auto first = static_cast<int>(s.teams.size() + 1);
+
+                for_each_field(group, '=', [&](std::string_view abbreviation)
+                {
+                    const auto team = to_team_id(abbreviation);
+                    if (!team)
+                    {
+                        throw std::invalid_argument(fmt::format(
+                            "Invalid team '{}'", abbreviation));
+                    }
+
+                    if (std::ranges::find(s.teams, *team) != s.teams.end())
+                    {
+                        throw std::invalid_argument(fmt::format(
+                            "Duplicate team '{}'", abbreviation));
+                    }
+
+                    s.teams.push_back(*team);
+                });
+
+                const auto last = static_cast<int>(s.teams.size());
+                if (last > first)
+                {
+                    ties.push_back({ first, last });
+                }
+            });
+        }
+
+        inline void append_json_string(io::output_buffer& out,
+            std::string_view text)
+        {
+            out.append('"');
+            for (const char c : text)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    out.append('\\');
+                    out.append(c);
+                }
+                else if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out.append(fmt::format("\\u{:04x}", static_cast<int>(c)));
+                }
+                else
+                {
+                    out.append(c);
+                }
+            }
+            out.append('"');
+        }
+    }
+
+    // <id> exact <order> [rounds=N] [max_jump=N] [combinations=C,C,...]
+    // <id> simulate <order> [draws=N] [seed=N] [rounds=N] [max_jump=N]
+    //     [combinations=C,C,...]
+    // <id> stats
+    //
+    // The order is the teams in ranking order, separated by ',', with tied
+    // teams joined by '=' (their combinations are split, see
+    // split_tied_combinations). The combinations default to the standard
+    // combinations of each ranking, and the format to the standard format.
+    // A simulation has at most max_query_draws draws.
+    inline odds_query parse_odds_query(std::string_view line)
+    {
+        std::vector<std::string_view> tokens;
+        detail::for_each_field(line, ' ', [&tokens](std::string_view token)
+        {
+            while (!token.empty() && (token.back() == '\r' ||
+                token.back() == '\t'))
+            {
+                token.remove_suffix(1);
+            }
+
+            if (!token.empty())
+            {
+                tokens.push_back(token);
+            }
+        });
+
+        if (tokens.size() < 2)
+        {
+            throw std::invalid_argument("Expected '<id> <command> ...'");
+        }
+
+        odds_query ret{ std::string{ tokens[0] } };
+
+        if (tokens[1] == "stats")
+        {
+            ret.kind = odds_query_kind::stats;
+            return ret;
+        }
+        else if (tokens[1] == "simulate")
+        {
+            ret.kind = odds_query_kind::simulate;
+        }
+        else if (tokens[1] != "exact")
+        {
+            throw std::invalid_argument(fmt::format("Unknown command '{}'",
+                tokens[1]));
+        }
+
+        if (tokens.size() < 3)
+        {
+            throw std::invalid_argument("Missing the draft order");
+        }
+
+        auto& s = ret.scenario;
+        s.name = ret.id;
+
+        std::vector<tie_group> ties;
+        detail::parse_query_order(tokens[2], s, ties);
+
+        std::optional<std::vector<std::size_t>> combinations;
+
+        for (const auto token : std::span{ tokens }.subspan(3))
+        {
+            const auto equals = token.find('=');
+            const auto key = token.substr(0, equals);
+            const auto value = (equals != std::string_view::npos) ?
+                token.substr(equals + 1) : std::string_view{};
+
+            if (key == "rounds")
+            {
+                s.format.rounds = detail::parse_query_number<std::size_t>(
+                    value, key);
+            }
+            else if (key == "max_jump")
+            {
+                s.format.max_ranking_jump = detail::parse_query_number<int>(
+                    value, key);
+            }
+            else if (key == "combinations")
+            {
+                combinations.emplace();
+                detail::for_each_field(value, ',', [&](std::string_view c)
+                {
+                    combinations->push_back(
+                        detail::parse_query_number<std::size_t>(c, key));
+                });
+            }
+            else if (key == "draws" && ret.kind == odds_query_kind::simulate)
+            {
+                ret.draws = detail::parse_query_number<std::size_t>(value,
+                    key);
+            }
+            else if (key == "seed" && ret.kind == odds_query_kind::simulate)
+            {
+                ret.seed = detail::parse_query_number<std::uint64_t>(value,
+                    key);
+            }
+            else
+            {
+                throw std::invalid_argument(fmt::format("Unknown option "
+                    "'{}'", key));
+            }
+        }
+
+        if (combinations)
+        {
+            if (combinations->size() != s.teams.size())
+            {
+                throw std::invalid_argument("Expected one combination count "
+                    "per team");
+            }
+            s.format.combinations_per_ranking = std::move(*combinations);
+        }
+        else
+        {
+            if (s.teams.size() > rankings_count)
+            {
+                throw std::invalid_argument("Missing combinations");
+            }
+
+            for (std::size_t r = 1; r <= s.teams.size(); ++r)
+            {
+                s.format.combinations_per_ranking.push_back(
+                    combinations_for_ranking(static_cast<int>(r)));
+            }
+        }
+
+        if (ret.draws < 1 || ret.draws > max_query_draws)
+        {
+            throw std::invalid_argument("Invalid value for 'draws'");
+        }
+
+        split_tied_combinations(s.format.combinations_per_ranking, ties);
+        s.format.validate();
+
+        return ret;
+    }
+
+    // The key of the odds a query asks for. The odds only depend on the
+    // format (the teams are labels), so orderings of different teams share
+    // them. A simulation without a seed reuses any earlier estimate.
+    inline std::string odds_query_key(odds_query const& query)
+    {
+        auto const& format = query.scenario.format;
+
+        auto ret = fmt::format("{}:{}:{}:{}",
+            (query.kind == odds_query_kind::exact) ? "exact" : "simulate",
+            format.rounds, format.max_ranking_jump,
+            fmt::join(format.combinations_per_ranking, ","));
+
+        if (query.kind == odds_query_kind::simulate)
+        {
+            ret += fmt::format(":{}", query.draws);
+            if (query.seed)
+            {
+                ret += fmt::format(":{}", *query.seed);
+            }
+        }
+
+        return ret;
+    }
+
+    inline pick_odds to_pick_odds(pick_counts const& counts)
+    {
+        pick_odds ret{ counts.team_count,
+            std::vector<double>(counts.picks.size()) };
+
+        for (std::size_t i = 0; i < counts.picks.size(); ++i)
+        {
+            ret.probabilities[i] = static_cast<double>(counts.picks[i]) /
+                static_cast<double>(counts.draws);
+        }
+
+        return ret;
+    }
+
+    // Answers odds queries, one line each, for as long as it lives. It keeps
+    // the thread pool and the most recent results, so a repeated query is a
+    // cache lookup. Exact queries are answered before handle returns (a few
+    // microseconds for 2 draws); simulations are queued and run one at a
+    // time on the whole pool by a scheduler thread, which answers them as
+    // they finish. Responses are JSON, one line each.
+    class odds_server
+    {
+    public:
+        using respond_type = std::function<void(std::string_view)>;
+
+        struct statistics
+        {
+            std::size_t hits{ 0 };
+            std::size_t misses{ 0 };
+            std::size_t pending{ 0 };   // simulations queued or running
+            std::size_t entries{ 0 };
+        };
+
+        explicit odds_server(thread_pool& pool,
+            std::size_t cache_capacity = 1024) :
+            pool_{ pool },
+            cache_{ cache_capacity },
+            scheduler_{ [this](std::stop_token stop) { run(stop); } }
+        {
+        }
+
+        odds_server(odds_server const&) = delete;
+        odds_server& operator=(odds_server const&) = delete;
+
+        // The queued simulations still run and are answered
+        ~odds_server()
+        {
+            scheduler_.request_stop();
+        }
+
+        // respond gets the response, maybe from the scheduler thread, so it
+        // has to stay valid until it's called
+        void handle(std::string_view line, respond_type respond)
+        {
+            const auto start = clock::now();
+
+            try
+            {
+                auto query = parse_odds_query(line);
+
+                if (query.kind == odds_query_kind::stats)
+                {
+                    respond(stats_response(query.id, stats()));
+                    return;
+                }
+
+                auto key = odds_query_key(query);
+
+                if (auto odds = cached(key))
+                {
+                    respond(odds_response(query, *odds, true, start));
+                    return;
+                }
+
+                if (query.kind == odds_query_kind::exact)
+                {
+                    auto odds = std::make_shared<pick_odds const>(
+                        exact_pick_odds(query.scenario.format));
+                    store(key, odds);
+
+                    respond(odds_response(query, *odds, false, start));
+                    return;
+                }
+
+                {
+                    const std::scoped_lock lock{ mutex_ };
+                    jobs_.push_back({ std::move(query), std::move(key),
+                        std::move(respond), start });
+                    ++pending_;
+                }
+                jobs_changed_.notify_one();
+            }
+            catch (std::exception const& e)
+            {
+                // the id is answered even if the rest of the line is wrong
+                const auto first = line.find_first_not_of(' ');
+                const auto id = (first != std::string_view::npos) ?
+                    line.substr(first, line.find(' ', first) - first) :
+                    std::string_view{};
+
+                respond(error_response(id, e.what()));
+            }
+        }
+
+        // Blocks until every queued simulation has been answered
+        void wait()
+        {
+            std::unique_lock lock{ mutex_ };
+            idle_.wait(lock, [this]() { return pending_ == 0; });
+        }
+
+        statistics stats() const
+        {
+            const std::scoped_lock lock{ mutex_ };
+            return { hits_, misses_, pending_, cache_.size() };
+        }
+
+    private:
+        using clock = std::chrono::steady_clock;
+        using odds_ptr = std::shared_ptr<pick_odds const>;
+
+        struct job
+        {
+            odds_query query;
+            std::string key;
+            respond_type respond;
+            clock::time_point start;
+        };
+
+        odds_ptr cached(std::string const& key)
+        {
+            const std::scoped_lock lock{ mutex_ };
+
+            if (const auto odds = cache_.find(key))
+            {
+                ++hits_;
+                return *odds;
+            }
+
+            ++misses_;
+            return nullptr;
+        }
+
+        // The same lookup without counting it, for a query that was already
+        // counted when it was handled
+        odds_ptr find(std::string const& key)
+        {
+            const std::scoped_lock lock{ mutex_ };
+
+            const auto odds = cache_.find(key);
+            return odds ? *odds : nullptr;
+        }
+
+        void store(std::string const& key, odds_ptr odds)
+        {
+            const std::scoped_lock lock{ mutex_ };
+            cache_.insert(key, std::move(odds));
+        }
+
+        void run(std::stop_token stop)
+        {
+            while (true)
+            {
+                std::unique_lock lock{ mutex_ };
+                jobs_changed_.wait(lock, stop, [this]()
+                {
+                    return !jobs_.empty();
+                });
+
+                if (jobs_.empty())
+                {
+                    return;
+                }
+
+                auto j = std::move(jobs_.front());
+                jobs_.pop_front();
+                lock.unlock();
+
+                simulate(j);
+
+                lock.lock();
+                --pending_;
+                lock.unlock();
+                idle_.notify_all();
+            }
+        }
+
+        void simulate(job& j)
+        {
+            try
+            {
+                // an identical query may have been answered while this one
+                // was queued
+                if (auto odds = find(j.key))
+                {
+                    j.respond(odds_response(j.query, *odds, true, j.start));
+                    return;
+                }
+
+                const auto seed = j.query.seed.value_or(random_seed());
+                const auto counts = run_scenarios(
+                    std::span{ &j.query.scenario, 1 }, j.query.draws, seed,
+                    pool_);
+
+                auto odds = std::make_shared<pick_odds const>(
+                    to_pick_odds(counts.front()));
+                store(j.key, odds);
+
+                j.query.seed = seed;
+                j.respond(odds_response(j.query, *odds, false, j.start));
+            }
+            catch (std::exception const& e)
+            {
+                j.respond(error_response(j.query.id, e.what()));
+            }
+        }
+
+        static double elapsed_us(clock::time_point start)
+        {
+            return std::chrono::duration<double, std::micro>(
+                clock::now() - start).count();
+        }
+
+        // {"id":..,"kind":..,"cached":..,"rounds":..,"draws":..,"seed":..,
+        //  "elapsed_us":..,"teams":[{"ranking":..,"team":..,"picks":[..]}]}
+        // draws and seed are only there for simulations; picks[p - 1] is
+        // the probability of pick p
+        static std::string odds_response(odds_query const& query,
+            pick_odds const& odds, bool cached, clock::time_point start)
+        {
+            const auto n = odds.team_count;
+            io::output_buffer out{ 256 + n * (64 + n * 10) };
+
+            out.append("{\"id\":");
+            detail::append_json_string(out, query.id);
+            out.append((query.kind == odds_query_kind::exact) ?
+                ",\"kind\":\"exact\"" : ",\"kind\":\"simulate\"");
+            out.append(cached ? ",\"cached\":true" : ",\"cached\":false");
+            out.append(",\"rounds\":");
+            out.append_number(query.scenario.format.rounds);
+
+            if (query.kind == odds_query_kind::simulate)
+            {
+                out.append(",\"draws\":");
+                out.append_number(query.draws);
+                if (query.seed)
+                {
+                    out.append(",\"seed\":");
+                    out.append_number(*query.seed);
+                }
+            }
+
+            out.append(",\"elapsed_us\":");
+            out.append_number(elapsed_us(start), 1);
+
+            out.append(",\"teams\":[");
+            for (std::size_t r = 0; r < n; ++r)
+            {
+                const auto ranking = static_cast<int>(r + 1);
+
+                out.append((r > 0) ? ",{\"ranking\":" : "{\"ranking\":");
+                out.append_number(ranking);
+                out.append(",\"team\":\"");
+                out.append(to_string(query.scenario.teams[r]));
+                out.append("\",\"picks\":[");
+
+                for (int pick = 1; pick <= static_cast<int>(n); ++pick)
+                {
+                    if (pick > 1)
+                    {
+                        out.append(',');
+                    }
+                    out.append_number(odds.pick_probability(ranking, pick),
+                        6);
+                }
+
+                out.append("]}");
+            }
+            out.append("]}");
+
+            return std::string{ out.view() };
+        }
+
+        static std::string stats_response(std::string_view id,
+            statistics const& s)
+        {
+            io::output_buffer out{ 256 };
+
+            out.append("{\"id\":");
+            detail::append_json_string(out, id);
+            out.append(",\"kind\":\"stats\",\"hits\":");
+            out.append_number(s.hits);
+            out.append(",\"misses\":");
+            out.append_number(s.misses);
+            out.append(",\"pending\":");
+            out.append_number(s.pending);
+            out.append(",\"entries\":");
+            out.append_number(s.entries);
+            out.append('}');
+
+            return std::string{ out.view() };
+        }
+
+        static std::string error_response(std::string_view id,
+            std::string_view message)
+        {
+            io::output_buffer out{ 64 + id.size() + message.size() * 2 };
+
+            out.append("{\"id\":");
+            detail::append_json_string(out, id);
+            out.append(",\"error\":");
+            detail::append_json_string(out, message);
+            out.append('}');
+
+            return std::string{ out.view() };
+        }
+
+        thread_pool& pool_;
+
+        mutable std::mutex mutex_;
+        lru_cache<std::string, odds_ptr> cache_;
+        std::size_t hits_{ 0 };
+        std::size_t misses_{ 0 };
+
+        std::deque<job> jobs_;
+        std::size_t pending_{ 0 };
+        std::condition_variable_any jobs_changed_;
+        std::condition_variable_any idle_;
+
+        // last, so it starts after everything it uses and stops first
+        std::jthread scheduler_;
+    };
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <algorithm>
+#include "nhl/lottery/lottery.h"
+
+namespace nhl::lottery
+{
+    // A draft order of up to 16 rankings in one 64-bit word, 4 bits per
+    // pick: bits [4 * i, 4 * i + 4) hold the ranking with pick i + 1, minus
+    // 1. The word is the whole order, so it compares, hashes and records as
+    // a single integer.
+    class packed_draft_order
+    {
+    public:
+        using word_type = std::uint64_t;
+
+        static constexpr std::size_t slot_bits{ 4 };
+        static constexpr std::size_t max_size{
+            (sizeof(word_type) * 8) / slot_bits };
+        static_assert(max_size == 16);
+
+        // The rankings in order (1, 2, ..., 16)
+        constexpr packed_draft_order() noexcept = default;
+
+        constexpr explicit packed_draft_order(std::span<int const> rankings) :
+            word_{ 0 }
+        {
+            if (rankings.size() > max_size)
+            {
+                throw std::out_of_range("Too many rankings");
+            }
+
+            for (std::size_t i = 0; i < rankings.size(); ++i)
+            {
+                if (rankings[i] < 1 ||
+                    rankings[i] > static_cast<int>(max_size))
+                {
+                    throw std::out_of_range("Invalid ranking");
+                }
+
+                word_ |= static_cast<word_type>(rankings[i] - 1) <<
+                    (i * slot_bits);
+            }
+        }
+
+        static constexpr packed_draft_order from_word(word_type word) noexcept
+        {
+            packed_draft_order ret;
+            ret.word_ = word;
+            return ret;
+        }
+
+        constexpr word_type word() const noexcept
+        {
+            return word_;
+        }
+
+        // The ranking with pick index + 1
+        constexpr int operator[](std::size_t index) const noexcept
+        {
+            return static_cast<int>((word_ >> (index * slot_bits)) &
+                slot_mask) + 1;
+        }
+
+        // The pick index of the ranking, found without a loop: the slot that
+        // XORs to 0 against the ranking repeated in every slot. Only the
+        // lowest 0 slot is exact, which is the one wanted since every
+        // ranking is in the order once.
+        constexpr std::size_t index_of(int ranking) const noexcept
+        {
+            const auto v = word_ ^ (static_cast<word_type>(ranking - 1) *
+                low_bit_of_each_slot);
+            const auto zero_slots = (v - low_bit_of_each_slot) & ~v &
+                high_bit_of_each_slot;
+            return static_cast<std::size_t>(std::countr_zero(zero_slots)) /
+                slot_bits;
+        }
+
+        // Moves the winner of a round up, the same way detail::move_up does.
+        // Returns false if the winner's pick is already locked in.
+        constexpr bool move_up(std::size_t round_index, int winner,
+            int max_jump) noexcept
+        {
+            const auto pos = index_of(winner);
+            if (pos < round_index)
+            {
+                return false;
+            }
+
+            const auto top_ranking = static_cast<int>(round_index + 1);
+            const auto adjusted_ranking = (winner <= max_jump) ?
+                top_ranking : std::max(winner - max_jump, top_ranking);
+            const auto target = static_cast<std::size_t>(adjusted_ranking - 1);
+
+            // the picks in [target, pos) move down one slot
+            const auto below = low_slots(target);
+            const auto between = low_slots(pos) & ~below;
+            const auto above = ~low_slots(pos + 1);
+
+            word_ = (word_ & below) | ((word_ & between) << slot_bits) |
+                (word_ & above) |
+                (static_cast<word_type>(winner - 1) << (target * slot_bits));
+
+            return true;
+        }
+
+        template <std::size_t N>
+        constexpr std::array<int, N> to_array() const noexcept
+        {
+            static_assert(N <= max_size);
+
+            std::array<int, N> ret{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                ret[i] = (*this)[i];
+            }
+            return ret;
+        }
+
+        constexpr auto operator<=>(packed_draft_order const&) const = default;
+
+    private:
+        static constexpr word_type slot_mask{ (1u << slot_bits) - 1 };
+        static constexpr word_type low_bit_of_each_slot{
+            0x1111'1111'1111'1111ull };
+        static constexpr word_type high_bit_of_each_slot{
+            0x8888'8888'8888'8888ull };
+
+        // the bits of slots [0, n)
+        static constexpr word_type low_slots(std::size_t n) noexcept
+        {
+            return (n >= max_size) ? ~word_type{ 0 } :
+                (word_type{ 1 } << (n * slot_bits)) - 1;
+        }
+
+        // 0xfedc...3210, i.e. ranking i + 1 at pick i + 1
+        word_type word_{ 0xfedc'ba98'7654'3210ull };
+    };
+
+    static_assert(packed_draft_order{}[0] == 1);
+    static_assert(packed_draft_order{}[15] == 16);
+    static_assert(packed_draft_order{}.index_of(16) == 15);
+    static_assert([]()
+        {
+            // 12th moves up 10 spots to 2nd in round 1
+            packed_draft_order order;
+            order.move_up(0, 12, 10);
+            return order[0] == 1 && order[1] == 12 && order[2] == 2 &&
+                order[11] == 11 && order[12] == 13;
+        }());
+}
+
+template <>
+struct std::hash<nhl::lottery::packed_draft_order>
+{
+    std::size_t operator()(nhl::lottery::packed_draft_order const& order) const
+        noexcept
+    {
+        return std::hash<std::uint64_t>{}(order.word());
+    }
+};
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
 #include "nhl/math/cmath.h"
 #include "nhl/lottery/odds.h"
 #include "nhl/lottery/stats.h"
@@ -9,6 +12,23 @@
 
 namespace nhl::lottery
 {
+    namespace detail
+    {
+        // The team with the ranking when the teams are known, otherwise the
+        // ranking itself
+        inline std::string ranking_label(lottery_stats const& stats,
+            int ranking)
+        {
+            if (stats.lottery_teams)
+            {
+                return std::string{ to_string(
+                    stats.lottery_teams->team_at(ranking)) };
+            }
+
+            return std::to_string(ranking);
+        }
+    }
+
     inline void print_round_winner_stats(lottery_stats const& stats)
     {
         for (const auto& [round, round_stats] : stats.round_winner_stats)
@@ -33,8 +53,8 @@ namespace nhl::lottery
                     count = pos->second;
                 }
 
-                temp::println("{:^10} {:^10} {:^10.3f}", ranking,
-                    count,
+                temp::println("{:^10} {:^10} {:^10.3f}",
+                    detail::ranking_label(stats, ranking), count,
                     math::percent(count, stats.simulations).to_ratio()
                 );
             }
@@ -130,8 +150,9 @@ namespace nhl::lottery
 
         for (auto const& ranking : rankings)
         {
+            const auto label = detail::ranking_label(stats, ranking);
             std::cout << std::vformat(team_column_format,
-                std::make_format_args(ranking)) << " ";
+                std::make_format_args(label)) << " ";
 
             for (int j = 1; j <= 16; ++j)
             {
@@ -168,6 +189,130 @@ namespace nhl::lottery
         }
     }
 
+    // The most frequent complete draft orders (at most max_rows of them),
+    // when they were counted
+    inline void print_draft_order_frequencies(lottery_stats const& stats,
+        std::size_t max_rows)
+    {
+        if (!stats.draft_orders)
+        {
+            return;
+        }
+
+        const auto orders = stats.draft_orders->sorted();
+
+        temp::println("[ Draft Orders ] ({} distinct in {} simulations)",
+            orders.size(), stats.draft_orders->total());
+        temp::println("");
+
+        std::string header = fmt::format("{:^5} {:^10}", "Pct.", "Count");
+        for (std::size_t pick = 1; pick <= rankings_count; ++pick)
+        {
+            header += fmt::format(" {:^3}", pick);
+        }
+        std::cout << header << "\n";
+        std::cout << std::string(header.size(), '-') << "\n";
+
+        for (std::size_t i = 0; i < std::min(max_rows, orders.size()); ++i)
+        {
+            temp::print("{:^5.3f} {:^10}", math::percent(orders[i].count,
+                stats.draft_orders->total()).to_ratio(), orders[i].count);
+
+            for (std::size_t pick = 0; pick < rankings_count; ++pick)
+            {
+                temp::print(" {:^3}", detail::ranking_label(stats,
+                    orders[i].key[pick]));
+            }
+
+            temp::println("");
+        }
+
+        if (orders.size() > max_rows)
+        {
+            temp::println("... {} more", orders.size() - max_rows);
+        }
+
+        temp::println("");
+    }
+
+    inline void print_draft_pick_stats(draft_pick_stats const& stats)
+    {
+        const std::string_view season_suffix =
+            (stats.seasons == 1) ? "season" : "seasons";
+        const std::string_view draw_suffix =
+            (stats.draws_per_season == 1) ? "draw" : "draws";
+
+        temp::println("[ Draft Pick Probabilities ] ({} {}, {} lottery {} "
+            "per season)", stats.seasons, season_suffix,
+            stats.draws_per_season, draw_suffix);
+        temp::println("");
+
+        // The "Lot." column is the probability of missing the playoffs (i.e.
+        // being in the lottery at all)
+        std::string header = fmt::format("{:^4} {:^5}", "Team", "Lot.");
+        for (std::size_t pick = 1; pick <= rankings_count; ++pick)
+        {
+            header += fmt::format(" {:^5}", pick);
+        }
+        std::cout << header << "\n";
+        std::cout << std::string(header.size(), '-') << "\n";
+
+        // Teams are ordered by their average lottery ranking; teams that
+        // never missed the playoffs are left out
+        std::vector<std::pair<double, nhl::team_id>> teams;
+
+        for (std::size_t t = 0; t < stats.lottery_rankings.size(); ++t)
+        {
+            std::size_t seasons{ 0 };
+            std::size_t ranking_sum{ 0 };
+
+            for (std::size_t r = 0; r < rankings_count; ++r)
+            {
+                seasons += stats.lottery_rankings[t][r];
+                ranking_sum += stats.lottery_rankings[t][r] * (r + 1);
+            }
+
+            if (seasons > 0)
+            {
+                teams.emplace_back(static_cast<double>(ranking_sum) / seasons,
+                    static_cast<nhl::team_id>(t));
+            }
+        }
+
+        std::ranges::sort(teams);
+
+        for (auto const& [average_ranking, team] : teams)
+        {
+            const auto t = static_cast<std::size_t>(team);
+
+            std::size_t seasons{ 0 };
+            for (auto const& count : stats.lottery_rankings[t])
+            {
+                seasons += count;
+            }
+
+            temp::print("{:^4} {:^5.3f}", to_string(team),
+                math::percent(seasons, stats.seasons).to_ratio());
+
+            for (auto const& count : stats.picks[t])
+            {
+                if (count == 0)
+                {
+                    temp::print(" {:^5}", "-");
+                }
+                else
+                {
+                    temp::print(" {:^5.3f}",
+                        math::percent(count, stats.draws()).to_ratio());
+                }
+            }
+
+            temp::println("");
+        }
+
+        temp::println("");
+    }
+
     inline void print_draft_order(std::array<int, nhl::lottery::rankings_count>
         const& draft_order)
     {
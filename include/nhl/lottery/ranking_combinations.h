@@ -66,7 +66,19 @@ namespace nhl::lottery
 
     // NOTE: Can't be constexpr due to std::random_device
     inline std::array<int, combinations_used_count>
-        ranking_combination_distribution(bool shuffle = true)
+        ranking_combination_distribution(bool shuffle = true);
+
+    template <std::uniform_random_bit_generator URBG>
+    std::array<int, combinations_used_count>
+        ranking_combination_distribution(URBG& gen)
+    {
+        auto ret = ranking_combination_distribution(false);
+        std::shuffle(ret.begin(), ret.end(), gen);
+        return ret;
+    }
+
+    inline std::array<int, combinations_used_count>
+        ranking_combination_distribution(bool shuffle)
     {
         std::array<int, combinations_used_count> ret;
 
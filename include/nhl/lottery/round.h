@@ -51,7 +51,7 @@ namespace nhl::lottery
     
         static constexpr round_number (max)() noexcept
         {
-            return round_number{ 2 };
+            return round_number{ static_cast<weak_type>(max_lottery_rounds) };
         }
     
     private:
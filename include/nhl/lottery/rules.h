@@ -0,0 +1,212 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include "nhl/lottery/lottery.h"
+#include "nhl/lottery/ranking_combinations.h"
+
+namespace nhl::lottery
+{
+    // A lottery format. Every format draws 4 of the 14 balls, so only the
+    // number of draws, the teams, their combinations and how far a winner may
+    // move up differ.
+    //
+    // struct rules
+    // {
+    //     static constexpr std::string_view name;
+    //     static constexpr std::size_t rounds;            // draws
+    //     static constexpr std::size_t team_count;        // rankings
+    //     static constexpr int max_ranking_jump;          // spots a winner
+    //                                                     // can move up
+    //     static constexpr std::array<std::size_t, team_count>
+    //         combinations_per_ranking;                   // index 0 is
+    //                                                     // ranking 1
+    // };
+    template <typename R>
+    concept lottery_rules = requires
+    {
+        { R::name } -> std::convertible_to<std::string_view>;
+        { R::rounds } -> std::convertible_to<std::size_t>;
+        { R::team_count } -> std::convertible_to<std::size_t>;
+        { R::max_ranking_jump } -> std::convertible_to<int>;
+        { R::combinations_per_ranking[0] } ->
+            std::convertible_to<std::size_t>;
+    } &&
+    (R::rounds >= 1 && R::rounds <= max_lottery_rounds) &&
+    (R::team_count > R::rounds && R::team_count <= max_team_count) &&
+    (R::max_ranking_jump >= 1) &&
+    (R::combinations_per_ranking.size() == R::team_count) &&
+    // at least one combination has to be left over for redraws
+    (std::accumulate(R::combinations_per_ranking.begin(),
+        R::combinations_per_ranking.end(), std::size_t{ 0 }) <
+        combination_count);
+
+    // Used since the 2022 draft: 2 draws, and a winner can move up at most 10
+    // spots
+    struct standard_rules
+    {
+        static constexpr std::string_view name{ "standard" };
+        static constexpr std::size_t rounds{ lottery_rounds };
+        static constexpr std::size_t team_count{ rankings_count };
+        static constexpr int max_ranking_jump{ nhl::lottery::max_ranking_jump };
+        static constexpr auto combinations_per_ranking = []()
+        {
+            std::array<std::size_t, team_count> ret{};
+            for (auto const& rc : nhl::lottery::combinations_per_ranking)
+            {
+                ret[static_cast<std::size_t>(rc.ranking - 1)] = rc.combinations;
+            }
+            return ret;
+        }();
+    };
+
+    // The current combinations with a third draw
+    struct three_draw_rules
+    {
+        static constexpr std::string_view name{ "three-draw" };
+        static constexpr std::size_t rounds{ 3 };
+        static constexpr std::size_t team_count{
+            standard_rules::team_count };
+        static constexpr int max_ranking_jump{
+            standard_rules::max_ranking_jump };
+        static constexpr auto combinations_per_ranking{
+            standard_rules::combinations_per_ranking };
+    };
+
+    // 2018 to 2020 drafts (31 teams): 3 draws for the top 3 picks, any
+    // non-playoff team can win
+    struct rules_2019
+    {
+        static constexpr std::string_view name{ "2019" };
+        static constexpr std::size_t rounds{ 3 };
+        static constexpr std::size_t team_count{ 15 };
+        static constexpr int max_ranking_jump{ static_cast<int>(team_count) };
+        static constexpr std::array<std::size_t, team_count>
+            combinations_per_ranking
+        {
+            185, 135, 115, 95, 85, 75, 65, 60, 50, 35, 30, 25, 20, 15, 10
+        };
+    };
+
+    // 2016 and 2017 drafts (30 teams)
+    struct rules_2016
+    {
+        static constexpr std::string_view name{ "2016" };
+        static constexpr std::size_t rounds{ 3 };
+        static constexpr std::size_t team_count{ 14 };
+        static constexpr int max_ranking_jump{ static_cast<int>(team_count) };
+        static constexpr std::array<std::size_t, team_count>
+            combinations_per_ranking
+        {
+            200, 135, 115, 95, 85, 75, 65, 60, 50, 35, 30, 25, 20, 10
+        };
+    };
+
+    static_assert(lottery_rules<standard_rules>);
+    static_assert(lottery_rules<three_draw_rules>);
+    static_assert(lottery_rules<rules_2019>);
+    static_assert(lottery_rules<rules_2016>);
+
+    template <lottery_rules Rules>
+    inline constexpr std::size_t combinations_used_by{
+        std::accumulate(Rules::combinations_per_ranking.begin(),
+            Rules::combinations_per_ranking.end(), std::size_t{ 0 }) };
+    static_assert(combinations_used_by<standard_rules> ==
+        combinations_used_count);
+
+    // 1 to team_count
+    template <lottery_rules Rules>
+    inline constexpr auto rankings_for = []()
+    {
+        std::array<int, Rules::team_count> ret;
+        std::iota(ret.begin(), ret.end(), 1);
+        return ret;
+    }();
+
+    // Each ranking repeated once per combination it is assigned, in ranking
+    // order (see ranking_combination_distribution)
+    template <lottery_rules Rules>
+    constexpr std::array<int, combinations_used_by<Rules>>
+        ranking_distribution()
+    {
+        std::array<int, combinations_used_by<Rules>> ret{};
+
+        std::size_t ret_index{ 0 };
+        for (std::size_t r = 0; r < Rules::team_count; ++r)
+        {
+            for (std::size_t n = 0; n < Rules::combinations_per_ranking[r]; ++n)
+            {
+                ret[ret_index++] = static_cast<int>(r + 1);
+            }
+        }
+
+        return ret;
+    }
+
+    // A format only known at run time (e.g. loaded from a file), with the
+    // same meaning as the members of a lottery_rules type
+    struct lottery_format
+    {
+        std::size_t rounds{ lottery_rounds };
+        int max_ranking_jump{ nhl::lottery::max_ranking_jump };
+
+        // index 0 is ranking 1
+        std::vector<std::size_t> combinations_per_ranking;
+
+        std::size_t team_count() const noexcept
+        {
+            return combinations_per_ranking.size();
+        }
+
+        void validate() const
+        {
+            if (rounds < 1 || rounds > max_lottery_rounds)
+            {
+                throw std::out_of_range("Invalid number of lottery rounds");
+            }
+
+            if (team_count() <= rounds || team_count() > max_team_count)
+            {
+                throw std::out_of_range("Invalid number of lottery teams");
+            }
+
+            if (max_ranking_jump < 1)
+            {
+                throw std::out_of_range("Invalid max ranking jump");
+            }
+
+            if (std::accumulate(combinations_per_ranking.begin(),
+                combinations_per_ranking.end(), std::size_t{ 0 }) >=
+                combination_count)
+            {
+                throw std::out_of_range("Too many combinations");
+            }
+
+            // every draw needs a winner that hasn't already won
+            if (static_cast<std::size_t>(std::ranges::count_if(
+                combinations_per_ranking, [](auto c) { return c > 0; })) <
+                rounds)
+            {
+                throw std::out_of_range("Not enough rankings with "
+                    "combinations");
+            }
+        }
+    };
+
+    template <lottery_rules Rules>
+    lottery_format format_of()
+    {
+        return
+        {
+            Rules::rounds,
+            Rules::max_ranking_jump,
+            { Rules::combinations_per_ranking.begin(),
+                Rules::combinations_per_ranking.end() }
+        };
+    }
+}
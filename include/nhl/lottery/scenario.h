@@ -0,0 +1,309 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <fmt/format.h>
+#include "nhl/print.h"
+#include "nhl/progress.h"
+#include "nhl/team.h"
+#include "nhl/thread_pool.h"
+#include "nhl/io/loader.h"
+#include "nhl/io/mapped_file.h"
+#include "nhl/lottery/batch.h"
+#include "nhl/lottery/combination_table.h"
+#include "nhl/lottery/exact_odds.h"
+#include "nhl/lottery/ranking_combinations.h"
+#include "nhl/lottery/rules.h"
+#include "nhl/lottery/teams.h"
+#include "nhl/lottery/ties.h"
+
+namespace nhl::lottery
+{
+    // A hypothetical lottery: the teams in ranking order and the format to
+    // draw them with
+    struct scenario
+    {
+        std::string name;
+        lottery_format format;
+
+        // index 0 is ranking 1
+        std::vector<team_id> teams;
+    };
+
+    // The given teams in the standard format, with the combinations of their
+    // tie groups split
+    inline scenario make_scenario(std::string name, lottery_teams const& teams,
+        std::size_t rounds = lottery_rounds)
+    {
+        scenario ret{ std::move(name), format_for(teams, rounds) };
+
+        for (int ranking = 1; ranking <= static_cast<int>(rankings_count);
+            ++ranking)
+        {
+            ret.teams.push_back(teams.lookup(ranking).value());
+        }
+
+        return ret;
+    }
+
+    // Keys: scenario, ranking, team, combinations, tie, rounds, max_jump
+    // One record per team per scenario. combinations defaults to the
+    // standard combinations for the ranking, rounds and max_jump to the
+    // standard format, and they only need to be given once per scenario.
+    // Teams with the same tie label finished tied, and their combinations are
+    // split (see split_tied_combinations). The scenarios are returned in the
+    // order they first appear.
+    inline std::vector<scenario> parse_scenarios(std::string_view text)
+    {
+        struct scenario_rows
+        {
+            std::string_view name;
+            std::optional<int> rounds;
+            std::optional<int> max_jump;
+
+            struct row
+            {
+                int ranking;
+                team_id team;
+                std::size_t combinations;
+                std::string_view tie;
+            };
+            std::vector<row> rows;
+        };
+
+        std::vector<scenario_rows> scenarios;
+        std::unordered_map<std::string_view, std::size_t> indices;
+
+        io::for_each_record(text, [&](io::record const& r)
+            {
+                const auto name = r.required("scenario");
+
+                const auto [it, inserted] = indices.try_emplace(name,
+                    scenarios.size());
+                if (inserted)
+                {
+                    scenarios.push_back({ name });
+                }
+
+                const auto pos = scenarios.begin() +
+                    static_cast<std::ptrdiff_t>(it->second);
+
+                const auto set_once = [&r](std::optional<int>& value,
+                    std::string_view key)
+                {
+                    if (const auto v = r.get_int(key))
+                    {
+                        if (value && *value != *v)
+                        {
+                            throw r.error(fmt::format(
+                                "Conflicting values for '{}'", key));
+                        }
+                        value = v;
+                    }
+                };
+
+                set_once(pos->rounds, "rounds");
+                set_once(pos->max_jump, "max_jump");
+
+                const auto ranking = r.get_int("ranking");
+                if (!ranking || *ranking < 1)
+                {
+                    throw r.error("Invalid value for 'ranking'");
+                }
+
+                std::size_t combinations{ 0 };
+                if (const auto c = r.get_int("combinations"))
+                {
+                    if (*c < 0)
+                    {
+                        throw r.error("Invalid value for 'combinations'");
+                    }
+                    combinations = static_cast<std::size_t>(*c);
+                }
+                else if (*ranking <= static_cast<int>(rankings_count))
+                {
+                    combinations = combinations_for_ranking(*ranking);
+                }
+                else
+                {
+                    throw r.error("Missing value for 'combinations'");
+                }
+
+                pos->rows.push_back({ *ranking, r.get_team("team"),
+                    combinations, r.get("tie").value_or("") });
+            });
+
+        std::vector<scenario> ret;
+        ret.reserve(scenarios.size());
+
+        for (auto& s : scenarios)
+        {
+            const auto error = [&s](std::string_view message)
+            {
+                return std::invalid_argument(fmt::format("Scenario '{}': {}",
+                    s.name, message));
+            };
+
+            std::ranges::sort(s.rows, {}, &scenario_rows::row::ranking);
+
+            scenario sc{ std::string{ s.name } };
+            sc.format.rounds = static_cast<std::size_t>(
+                s.rounds.value_or(static_cast<int>(lottery_rounds)));
+            sc.format.max_ranking_jump = s.max_jump.value_or(
+                nhl::lottery::max_ranking_jump);
+
+            for (std::size_t i = 0; i < s.rows.size(); ++i)
+            {
+                auto const& row = s.rows[i];
+
+                if (row.ranking != static_cast<int>(i + 1))
+                {
+                    throw error("The rankings must be 1 to the number of "
+                        "teams");
+                }
+
+                if (std::ranges::find(sc.teams, row.team) != sc.teams.end())
+                {
+                    throw error(fmt::format("Duplicate team '{}'",
+                        to_string(row.team)));
+                }
+
+                sc.format.combinations_per_ranking.push_back(
+                    row.combinations);
+                sc.teams.push_back(row.team);
+            }
+
+            // rows with the same label have to be next to each other
+            std::vector<tie_group> ties;
+            for (std::size_t i = 0; i < s.rows.size();)
+            {
+                auto j = i + 1;
+                while (j < s.rows.size() && !s.rows[i].tie.empty() &&
+                    s.rows[j].tie == s.rows[i].tie)
+                {
+                    ++j;
+                }
+
+                if (!s.rows[i].tie.empty())
+                {
+                    if (j - i < 2 || std::ranges::find(s.rows.begin() +
+                        static_cast<std::ptrdiff_t>(j), s.rows.end(),
+                        s.rows[i].tie, &scenario_rows::row::tie) !=
+                        s.rows.end())
+                    {
+                        throw error(fmt::format("Tie '{}' must be 2 or more "
+                            "consecutive rankings", s.rows[i].tie));
+                    }
+
+                    ties.push_back({ static_cast<int>(i + 1),
+                        static_cast<int>(j) });
+                }
+
+                i = j;
+            }
+
+            split_tied_combinations(sc.format.combinations_per_ranking, ties);
+
+            try
+            {
+                sc.format.validate();
+            }
+            catch (std::out_of_range const& e)
+            {
+                throw error(e.what());
+            }
+
+            ret.push_back(std::move(sc));
+        }
+
+        return ret;
+    }
+
+    inline std::vector<scenario> load_scenarios(
+        std::filesystem::path const& path)
+    {
+        const io::mapped_file file{ path };
+        return parse_scenarios(file.view());
+    }
+
+    // Draws every scenario draws_per_scenario times, with all the scenarios
+    // in one job (see run_batch). The results are in the same order as the
+    // scenarios.
+    inline std::vector<pick_counts> run_scenarios(
+        std::span<scenario const> scenarios, std::size_t draws_per_scenario,
+        std::uint64_t seed, thread_pool& pool,
+        progress_counters* progress = nullptr)
+    {
+        std::vector<format_combination_table> tables;
+        tables.reserve(scenarios.size());
+
+        std::vector<pick_counts> empty_results;
+        empty_results.reserve(scenarios.size());
+
+        for (auto const& s : scenarios)
+        {
+            tables.emplace_back(s.format);
+            empty_results.emplace_back(s.format.team_count());
+        }
+
+        return run_batch(std::span{ std::as_const(tables) },
+            draws_per_scenario, seed, pool, empty_results,
+            [](pick_counts& result, std::size_t,
+                format_draw_result const& draw)
+            {
+                result.record(draw.draft_order());
+            }, progress);
+    }
+
+    // The exact odds of every scenario (see exact_pick_odds)
+    inline std::vector<pick_odds> exact_scenario_odds(
+        std::span<scenario const> scenarios)
+    {
+        std::vector<pick_odds> ret;
+        ret.reserve(scenarios.size());
+
+        for (auto const& s : scenarios)
+        {
+            ret.push_back(exact_pick_odds(s.format));
+        }
+
+        return ret;
+    }
+
+    // One line per team: the odds of the first pick, of a lottery pick (won
+    // in one of the draws) and of dropping down, and the expected pick.
+    // Result is pick_counts or pick_odds.
+    template <typename Result>
+    void print_scenario_result(scenario const& s, Result const& result)
+    {
+        const auto rounds = static_cast<int>(s.format.rounds);
+
+        temp::println("[ {} ]", s.name);
+        temp::println("{:^4} {:^4} {:^5} {:^5} {:^5} {:^5}", "Rank", "Team",
+            "1st", fmt::format("Top{}", rounds), "Down", "Exp.");
+
+        for (std::size_t r = 0; r < s.teams.size(); ++r)
+        {
+            const auto ranking = static_cast<int>(r + 1);
+
+            temp::println("{:^4} {:^4} {:^5.3f} {:^5.3f} {:^5.3f} {:^5.2f}",
+                ranking, to_string(s.teams[r]),
+                result.pick_probability(ranking, 1),
+                result.pick_probability(ranking, 1, rounds),
+                result.pick_probability(ranking, ranking + 1,
+                    static_cast<int>(result.team_count)),
+                result.expected_pick(ranking));
+        }
+
+        temp::println("");
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include "nhl/league.h"
+#include "nhl/parallel.h"
+#include "nhl/random.h"
+#include "nhl/season.h"
+#include "nhl/standings.h"
+#include "nhl/thread_pool.h"
+#include "nhl/lottery/lottery.h"
+#include "nhl/lottery/combination_table.h"
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/machine.h"
+#include "nhl/lottery/rules.h"
+
+namespace nhl::lottery
+{
+    static_assert(nhl::team_count - playoff_team_count == rankings_count);
+
+    struct season_lottery_options
+    {
+        std::size_t seasons{ 1 };
+        std::size_t draws_per_season{ 1 };
+        std::size_t rounds{ lottery_rounds };
+        std::uint64_t seed{ 0 };
+    };
+
+    // Plays out the rest of the season and then runs the lottery on the
+    // resulting order, all within the same worker; only the pick counts are
+    // kept, so nothing is stored per season
+    template <lottery_rules Rules = standard_rules>
+    draft_pick_stats simulate_season_lottery(season_model const& model,
+        season_lottery_options const& options, thread_pool& pool)
+    {
+        static_assert(Rules::team_count == rankings_count,
+            "The rules must cover every non-playoff team");
+
+        struct worker_state
+        {
+            draft_pick_stats stats;
+            basic_combination_table<Rules> table;
+            nhl::lottery::machine machine;
+        };
+
+        const auto make_state = [&options]()
+        {
+            worker_state ret;
+            ret.stats.draws_per_season = options.draws_per_season;
+            ret.stats.rounds = options.rounds;
+            return ret;
+        };
+
+        const auto run_block = [&](worker_state& state, std::size_t block)
+        {
+            auto gen = make_random_engine(options.seed, block);
+            state.table.populate(gen);
+
+            const auto range = block_at(options.seasons, block);
+
+            for (std::size_t s = range.first; s < range.last; ++s)
+            {
+                const auto order = non_playoff_teams(model.simulate(gen));
+
+                for (std::size_t r = 0; r < order.size(); ++r)
+                {
+                    state.stats.lottery_rankings[
+                        static_cast<std::size_t>(order[r])][r]++;
+                }
+
+                for (std::size_t d = 0; d < options.draws_per_season; ++d)
+                {
+                    const auto result = run_draw(state.table, state.machine,
+                        options.rounds, gen);
+
+                    for (std::size_t pick = 0;
+                        pick < result.draft_order.size(); ++pick)
+                    {
+                        const auto team = order[static_cast<std::size_t>(
+                            result.draft_order[pick] - 1)];
+                        state.stats.picks[static_cast<std::size_t>(team)]
+                            [pick]++;
+                    }
+                }
+            }
+
+            state.stats.seasons += range.size();
+        };
+
+        auto states = run_blocks(pool, 0, block_count(options.seasons),
+            make_state, run_block);
+
+        auto ret = make_state().stats;
+        for (auto const& state : states)
+        {
+            ret += state.stats;
+        }
+
+        return ret;
+    }
+}
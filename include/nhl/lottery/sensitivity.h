@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include "nhl/parallel.h"
+#include "nhl/print.h"
+#include "nhl/random.h"
+#include "nhl/thread_pool.h"
+#include "nhl/lottery/batch.h"
+#include "nhl/lottery/packed_draft_order.h"
+#include "nhl/lottery/rules.h"
+
+namespace nhl::lottery
+{
+    // How the odds respond to the combinations of each ranking: the counts
+    // of the format itself and of every format with one ranking's
+    // combinations moved up and down by step
+    struct odds_sensitivity
+    {
+        std::size_t step{ 0 };
+        pick_counts base;
+
+        // index 0 is the ranking whose combinations were moved
+        std::vector<pick_counts> increased;
+        std::vector<pick_counts> decreased;
+
+        // The decrease actually used for each ranking; a ranking keeps at
+        // least 1 combination, so it's less than step for small rankings
+        std::vector<std::size_t> decreases;
+
+        std::size_t team_count() const noexcept
+        {
+            return base.team_count;
+        }
+
+        // The change in the probability of the ranking getting the pick per
+        // combination given to moved (a central difference)
+        double derivative(int moved, int ranking, int pick) const
+        {
+            const auto m = static_cast<std::size_t>(moved - 1);
+
+            return (increased[m].pick_probability(ranking, pick) -
+                decreased[m].pick_probability(ranking, pick)) /
+                static_cast<double>(step + decreases[m]);
+        }
+
+        odds_sensitivity& operator+=(odds_sensitivity const& rhs)
+        {
+            base += rhs.base;
+            for (std::size_t m = 0; m < increased.size(); ++m)
+            {
+                increased[m] += rhs.increased[m];
+                decreased[m] += rhs.decreased[m];
+            }
+            return *this;
+        }
+    };
+
+    namespace detail
+    {
+        // The combinations of a format laid end to end, ranking 1 first, so
+        // each draw is one uniform number u. Moving step combinations to a
+        // ranking claims [total, total + step) and taking them away releases
+        // the end of its own range, so a perturbed format only sees a
+        // different winner when u lands in those few numbers.
+        class shared_draw_layout
+        {
+        public:
+            shared_draw_layout(lottery_format const& format,
+                std::size_t step) :
+                step_{ step }
+            {
+                std::size_t end{ 0 };
+                for (std::size_t r = 0; r < format.team_count(); ++r)
+                {
+                    const auto c = format.combinations_per_ranking[r];
+
+                    ranking_at_.insert(ranking_at_.end(), c,
+                        static_cast<std::uint8_t>(r + 1));
+
+                    end += c;
+                    ends_.push_back(end);
+                    decreases_.push_back((c > 0) ? std::min(step, c - 1) : 0);
+                }
+            }
+
+            // the uniform numbers are in [0, size())
+            std::size_t size() const noexcept
+            {
+                return ranking_at_.size() + step_;
+            }
+
+            std::vector<std::size_t> const& decreases() const noexcept
+            {
+                return decreases_;
+            }
+
+            // The winner of u, or 0 for a redraw. moved is 0 for the format
+            // itself, and increase says which way its combinations moved.
+            int ranking_at(std::size_t u, int moved, bool increase) const
+                noexcept
+            {
+                if (u >= ranking_at_.size())
+                {
+                    return (moved > 0 && increase) ? moved : 0;
+                }
+
+                const int ranking = ranking_at_[u];
+
+                if (moved > 0 && !increase && ranking == moved)
+                {
+                    const auto m = static_cast<std::size_t>(moved - 1);
+                    if (u >= ends_[m] - decreases_[m])
+                    {
+                        return 0;
+                    }
+                }
+
+                return ranking;
+            }
+
+        private:
+            std::size_t step_;
+            std::vector<std::uint8_t> ranking_at_;
+            std::vector<std::size_t> ends_;
+            std::vector<std::size_t> decreases_;
+        };
+    }
+
+    // Estimates the sensitivity of every pick probability to the
+    // combinations of every ranking with common random numbers: each draw
+    // makes one stream of uniform numbers, and the format and all its 2 *
+    // team_count perturbations are drawn from that same stream (redraws
+    // included). The draws skip the machine and the combination table,
+    // which only turn the uniform numbers into balls and back. Since the
+    // perturbed draws only differ in the rare draws that hit a moved range,
+    // the differences have a fraction of the noise of independent runs, and
+    // they all come from one pass.
+    inline odds_sensitivity run_odds_sensitivity(
+        lottery_format const& format, std::size_t draws, std::size_t step,
+        std::uint64_t seed, thread_pool& pool)
+    {
+        format.validate();
+
+        const auto n = format.team_count();
+        if (n > packed_draft_order::max_size)
+        {
+            throw std::out_of_range("Too many teams for a sensitivity run");
+        }
+
+        if (step < 1)
+        {
+            throw std::out_of_range("Invalid sensitivity step");
+        }
+
+        const detail::shared_draw_layout layout{ format, step };
+
+        odds_sensitivity empty{ step, pick_counts{ n },
+            std::vector<pick_counts>(n, pick_counts{ n }),
+            std::vector<pick_counts>(n, pick_counts{ n }),
+            layout.decreases() };
+
+        struct worker_state
+        {
+            odds_sensitivity result;
+            std::vector<std::size_t> stream;
+        };
+
+        const auto make_state = [&]()
+        {
+            return worker_state{ empty, {} };
+        };
+
+        const auto run_block = [&](worker_state& state, std::size_t block)
+        {
+            const auto range = block_at(draws, block);
+
+            auto gen = make_random_engine(seed, block);
+            std::uniform_int_distribution<std::size_t> uniform{ 0,
+                layout.size() - 1 };
+
+            auto& stream = state.stream;
+
+            const auto draw = [&](pick_counts& counts, int moved,
+                bool increase)
+            {
+                packed_draft_order draft_order;
+                std::uint32_t winners{ 0 };
+                std::size_t next{ 0 };
+
+                for (std::size_t round_index = 0; round_index < format.rounds;)
+                {
+                    // the stream only grows as far as some format needs it
+                    if (next == stream.size())
+                    {
+                        stream.push_back(uniform(gen));
+                    }
+
+                    const auto winner = layout.ranking_at(stream[next++],
+                        moved, increase);
+
+                    if (winner == 0 || (winners & (1u << (winner - 1))) != 0)
+                    {
+                        continue;
+                    }
+
+                    if (draft_order.move_up(round_index, winner,
+                        format.max_ranking_jump))
+                    {
+                        winners |= 1u << (winner - 1);
+                        ++round_index;
+                    }
+                }
+
+                const auto order = draft_order.to_array<
+                    packed_draft_order::max_size>();
+                counts.record(std::span{ order.data(), n });
+            };
+
+            for (std::size_t d = range.first; d < range.last; ++d)
+            {
+                stream.clear();
+
+                draw(state.result.base, 0, false);
+
+                for (std::size_t m = 0; m < n; ++m)
+                {
+                    const auto moved = static_cast<int>(m + 1);
+                    draw(state.result.increased[m], moved, true);
+                    draw(state.result.decreased[m], moved, false);
+                }
+            }
+        };
+
+        auto states = run_blocks(pool, 0, block_count(draws), make_state,
+            run_block);
+
+        auto ret = std::move(empty);
+        for (auto const& state : states)
+        {
+            ret += state.result;
+        }
+
+        return ret;
+    }
+
+    // The change in each ranking's pick odds, in percentage points, from
+    // moving 10 combinations to the given ranking
+    inline void print_odds_sensitivity(odds_sensitivity const& sensitivity,
+        int moved)
+    {
+        const auto n = static_cast<int>(sensitivity.team_count());
+
+        temp::println("[ Sensitivity to Ranking {} ] (percentage points per "
+            "10 combinations, {} draws)", moved, sensitivity.base.draws);
+
+        std::string header = fmt::format("{:^4}", "Rank");
+        for (int pick = 1; pick <= n; ++pick)
+        {
+            header += fmt::format(" {:^5}", pick);
+        }
+        temp::println("{}", header);
+        temp::println("{}", std::string(header.size(), '-'));
+
+        for (int ranking = 1; ranking <= n; ++ranking)
+        {
+            temp::print("{:^4}", ranking);
+
+            for (int pick = 1; pick <= n; ++pick)
+            {
+                const auto d = sensitivity.derivative(moved, ranking, pick) *
+                    10.0 * 100.0;
+
+                if (d == 0.0)
+                {
+                    temp::print(" {:^5}", "-");
+                }
+                else
+                {
+                    temp::print(" {:^+5.2f}", d);
+                }
+            }
+
+            temp::println("");
+        }
+
+        temp::println("");
+    }
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <fmt/format.h>
+#include "nhl/parallel.h"
+#include "nhl/progress.h"
+#include "nhl/random.h"
+#include "nhl/thread_pool.h"
+#include "nhl/io/mapped_file.h"
+#include "nhl/io/output_buffer.h"
+#include "nhl/lottery/combination_table.h"
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/export.h"
+#include "nhl/lottery/machine.h"
+#include "nhl/lottery/rules.h"
+#include "nhl/lottery/stats.h"
+#include "nhl/lottery/stats_cache.h"
+
+namespace nhl::lottery
+{
+    enum class draw_method
+    {
+        // every ball of every attempt (see run_draw)
+        draw,
+
+        // the winners straight from the rankings (see sample_draw)
+        sampled
+    };
+
+    constexpr std::string_view to_string(draw_method method) noexcept
+    {
+        return (method == draw_method::sampled) ? "sampled" : "draw";
+    }
+
+    // One of count equal parts of a run's blocks (see nhl/parallel.h). Each
+    // block has its own random stream, so the shards of a run can be drawn
+    // anywhere, in any order, and add up to the same stats as the whole run.
+    struct shard
+    {
+        std::size_t index{ 0 };
+        std::size_t count{ 1 };
+
+        void validate() const
+        {
+            if (count < 1 || index >= count)
+            {
+                throw std::out_of_range("Invalid shard");
+            }
+        }
+
+        // The shard's blocks of a run of the given simulations
+        constexpr block_range blocks(std::size_t simulations) const noexcept
+        {
+            const auto total = block_count(simulations);
+            return { total * index / count, total * (index + 1) / count };
+        }
+
+        constexpr std::size_t simulations(std::size_t total) const noexcept
+        {
+            const auto [first, last] = blocks(total);
+            return (first == last) ? 0 :
+                block_at(total, last - 1).last - block_at(total, first).first;
+        }
+
+        friend bool operator==(shard const&, shard const&) = default;
+    };
+
+    // Draws block of the total simulations of the standard lottery into
+    // stats, with the block's random stream. The table is repopulated before
+    // every draw, as the lottery does each year.
+    template <typename Observer = draw_observer>
+    void simulate_block(lottery_stats& stats, std::size_t total,
+        std::size_t block, std::uint64_t seed, draw_method method,
+        combination_table& table, machine& machine, Observer&& observer = {})
+    {
+        const auto range = block_at(total, block);
+        auto gen = make_random_engine(seed, block);
+
+        for (std::size_t d = range.first; d < range.last; ++d)
+        {
+            if (method == draw_method::sampled)
+            {
+                record(stats, sample_draw<standard_rules>(stats.rounds, gen));
+            }
+            else
+            {
+                table.populate(gen);
+                record(stats, run_draw(table, machine, stats.rounds, gen,
+                    observer));
+            }
+        }
+
+        stats.simulations += range.size();
+    }
+
+    // The shard's part of empty.simulations draws of the standard lottery,
+    // counted into copies of empty (its teams, rounds and whether it counts
+    // the draft orders). The stats only depend on the seed and the blocks
+    // drawn, not on the pool.
+    inline lottery_stats simulate_stats(lottery_stats const& empty,
+        std::uint64_t seed, draw_method method, thread_pool& pool,
+        shard const& part = {}, progress_counters* progress = nullptr)
+    {
+        part.validate();
+
+        const auto total = empty.simulations;
+        const auto [first, last] = part.blocks(total);
+
+        auto ret = empty;
+        ret.simulations = 0;
+
+        struct worker_state
+        {
+            lottery_stats stats;
+            combination_table table;
+            nhl::lottery::machine machine;
+            std::size_t progress_counter{ 0 };
+        };
+
+        const auto make_state = [&]()
+        {
+            return worker_state{ ret, {}, {},
+                progress ? progress->claim() : 0 };
+        };
+
+        const auto run_block = [&](worker_state& state, std::size_t block)
+        {
+            simulate_block(state.stats, total, block, seed, method,
+                state.table, state.machine);
+
+            if (progress)
+            {
+                progress->add(state.progress_counter,
+                    block_at(total, block).size());
+            }
+        };
+
+        for (auto const& state : run_blocks(pool, first, last, make_state,
+            run_block))
+        {
+            ret += state.stats;
+        }
+
+        return ret;
+    }
+
+    // File layout (little-endian), version 1:
+    //   "NHLD", u16 version, u32 shard index, u32 shard count
+    //   u32 key size, the key text (see stats_key)
+    //   a binary stats export of the shard (see write_stats)
+    inline constexpr std::string_view shard_file_magic{ "NHLD" };
+    inline constexpr std::uint16_t shard_file_version{ 1 };
+
+    struct shard_file
+    {
+        std::string key;
+        nhl::lottery::shard shard;
+        lottery_stats stats;
+    };
+
+    inline void write_shard_file(std::filesystem::path const& path,
+        stats_key const& key, shard const& part, lottery_stats const& stats)
+    {
+        const auto& text = key.text();
+
+        io::output_buffer out{ shard_file_magic.size() + 2 + 3 * 4 +
+            text.size() + export_size(stats, export_format::binary) };
+
+        out.append(shard_file_magic);
+        out.append_le(shard_file_version);
+        out.append_le(static_cast<std::uint32_t>(part.index));
+        out.append_le(static_cast<std::uint32_t>(part.count));
+        out.append_le(static_cast<std::uint32_t>(text.size()));
+        out.append(text);
+        write_stats(stats, export_format::binary, out);
+
+        out.write_to(path);
+    }
+
+    inline shard_file parse_shard_file(std::string_view bytes)
+    {
+        detail::binary_stats_reader in{ bytes };
+
+        if (in.read_bytes(shard_file_magic.size()) != shard_file_magic)
+        {
+            throw std::runtime_error("Not a shard file");
+        }
+
+        if (in.read<std::uint16_t>() != shard_file_version)
+        {
+            throw std::runtime_error("Unsupported shard file version");
+        }
+
+        shard_file ret;
+        ret.shard.index = in.read<std::uint32_t>();
+        ret.shard.count = in.read<std::uint32_t>();
+        ret.shard.validate();
+
+        ret.key = in.read_bytes(in.read<std::uint32_t>());
+
+        const auto header = shard_file_magic.size() + 2 + 3 * 4 +
+            ret.key.size();
+        ret.stats = parse_binary_stats(bytes.substr(header));
+
+        return ret;
+    }
+
+    inline shard_file load_shard_file(std::filesystem::path const& path)
+    {
+        const io::mapped_file file{ path };
+        return parse_shard_file(file.view());
+    }
+
+    // Adds up the shards of one run, which is the same as the whole run.
+    // They must all have the same key and shard count, and every shard has
+    // to be given exactly once.
+    inline lottery_stats merge_shards(std::span<shard_file const> shards)
+    {
+        if (shards.empty())
+        {
+            throw std::invalid_argument("No shards to merge");
+        }
+
+        auto const& first = shards.front();
+        std::vector<bool> seen(first.shard.count);
+
+        for (auto const& s : shards)
+        {
+            if (s.key != first.key)
+            {
+                throw std::invalid_argument(fmt::format("Shard {} was run "
+                    "with different options", s.shard.index));
+            }
+
+            if (s.shard.count != first.shard.count)
+            {
+                throw std::invalid_argument(fmt::format("Shard {} is one of "
+                    "{} shards, not {}", s.shard.index, s.shard.count,
+                    first.shard.count));
+            }
+
+            if (seen[s.shard.index])
+            {
+                throw std::invalid_argument(fmt::format("Shard {} was given "
+                    "more than once", s.shard.index));
+            }
+            seen[s.shard.index] = true;
+
+            if (s.stats.rounds != first.stats.rounds)
+            {
+                throw std::invalid_argument(fmt::format("Shard {} has a "
+                    "different number of rounds", s.shard.index));
+            }
+        }
+
+        if (const auto missing = std::ranges::find(seen, false);
+            missing != seen.end())
+        {
+            throw std::invalid_argument(fmt::format("Shard {} of {} is "
+                "missing", missing - seen.begin(), first.shard.count));
+        }
+
+        auto ret = first.stats;
+        for (auto const& s : shards.subspan(1))
+        {
+            ret += s.stats;
+        }
+
+        return ret;
+    }
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <array>
 #include <map>
+#include <optional>
 #include <unordered_map>
+#include "nhl/league.h"
 #include "nhl/print.h"
+#include "nhl/lottery/histogram.h"
 #include "nhl/lottery/teams.h"
 #include "nhl/lottery/round.h"
 
@@ -24,5 +28,88 @@ namespace nhl::lottery
         std::size_t original_draft_order_retained{ 0 };
 
         std::unordered_map<round_number, std::size_t> redraws;
+
+        // Every complete draft order, when the joint outcomes are wanted
+        std::optional<draft_order_histogram> draft_orders;
+
+        // Adds the counts of other simulations of the same lottery (same
+        // teams and rounds)
+        lottery_stats& operator+=(lottery_stats const& rhs)
+        {
+            simulations += rhs.simulations;
+            original_draft_order_retained += rhs.original_draft_order_retained;
+
+            for (auto const& [round, winners] : rhs.round_winner_stats)
+            {
+                for (auto const& [ranking, count] : winners)
+                {
+                    round_winner_stats[round][ranking] += count;
+                }
+            }
+
+            for (auto const& [pick, rankings] : rhs.draft_order_stats)
+            {
+                for (auto const& [ranking, count] : rankings)
+                {
+                    draft_order_stats[pick][ranking] += count;
+                }
+            }
+
+            for (auto const& [round, count] : rhs.redraws)
+            {
+                redraws[round] += count;
+            }
+
+            if (rhs.draft_orders)
+            {
+                if (!draft_orders)
+                {
+                    draft_orders.emplace();
+                }
+                *draft_orders += *rhs.draft_orders;
+            }
+
+            return *this;
+        }
+    };
+
+    struct draft_pick_stats
+    {
+        using table_type = std::array<std::array<std::size_t, rankings_count>,
+            nhl::team_count>;
+
+        std::size_t seasons{ 0 };
+        std::size_t draws_per_season{ 1 };
+        std::size_t rounds{ lottery_rounds };
+
+        // [team id][pick - 1] -> number of draws the team ended up with the
+        // pick
+        table_type picks{};
+
+        // [team id][ranking - 1] -> number of seasons the team finished with
+        // the lottery ranking
+        table_type lottery_rankings{};
+
+        constexpr std::size_t draws() const noexcept
+        {
+            return seasons * draws_per_season;
+        }
+
+        constexpr draft_pick_stats& operator+=(draft_pick_stats const& rhs)
+            noexcept
+        {
+            seasons += rhs.seasons;
+
+            for (std::size_t t = 0; t < picks.size(); ++t)
+            {
+                for (std::size_t p = 0; p < picks[t].size(); ++p)
+                {
+                    picks[t][p] += rhs.picks[t][p];
+                    lottery_rankings[t][p] += rhs.lottery_rankings[t][p];
+                }
+            }
+
+            return *this;
+        }
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <fmt/format.h>
+#include "nhl/random.h"
+#include "nhl/team.h"
+#include "nhl/io/mapped_file.h"
+#include "nhl/io/output_buffer.h"
+#include "nhl/lottery/export.h"
+#include "nhl/lottery/rules.h"
+#include "nhl/lottery/stats.h"
+#include "nhl/lottery/teams.h"
+
+namespace nhl::lottery
+{
+    // Everything that decides the stats of a run, written out as text: the
+    // format, the teams and their ties, the number of simulations, the seed
+    // and how the draws were made (i.e. "draw" or "sampled", which use the
+    // random numbers differently). Two runs with the same key produce the
+    // same stats.
+    class stats_key
+    {
+    public:
+        stats_key(lottery_format const& format,
+            std::optional<lottery_teams> const& teams,
+            std::size_t simulations, std::uint64_t seed,
+            std::string_view method = "draw")
+        {
+            text_ = fmt::format("rounds={}\nmax_jump={}\ncombinations={}\n",
+                format.rounds, format.max_ranking_jump,
+                fmt::join(format.combinations_per_ranking, ","));
+
+            text_ += "teams=";
+            if (teams)
+            {
+                for (int ranking = 1;
+                    ranking <= static_cast<int>(rankings_count); ++ranking)
+                {
+                    text_ += (ranking > 1) ? "," : "";
+                    text_ += to_string(teams->team_at(ranking));
+                }
+            }
+
+            text_ += "\nties=";
+            if (teams)
+            {
+                for (bool first{ true }; auto const& tie : teams->ties())
+                {
+                    text_ += fmt::format("{}{}-{}", first ? "" : ",",
+                        tie.first_ranking, tie.last_ranking);
+                    first = false;
+                }
+            }
+
+            text_ += fmt::format("\nsimulations={}\nseed={}\nmethod={}\n",
+                simulations, seed, method);
+        }
+
+        std::string const& text() const noexcept
+        {
+            return text_;
+        }
+
+        // 64-bit FNV-1a of the text
+        std::uint64_t hash() const noexcept
+        {
+            std::uint64_t ret{ 0xcbf2'9ce4'8422'2325 };
+            for (const char c : text_)
+            {
+                ret ^= static_cast<std::uint8_t>(c);
+                ret *= 0x0000'0100'0000'01b3;
+            }
+            return ret;
+        }
+
+        std::string file_name() const
+        {
+            return fmt::format("{:016x}.nhlc", hash());
+        }
+
+        friend bool operator==(stats_key const&, stats_key const&) = default;
+
+    private:
+        std::string text_;
+    };
+
+    // File layout (little-endian), version 2 (the lottery simulation's
+    // draws were split into blocks):
+    //   "NHLC", u16 version, u32 key size, the key text
+    //   a binary stats export (see write_stats)
+    inline constexpr std::string_view stats_cache_magic{ "NHLC" };
+    inline constexpr std::uint16_t stats_cache_version{ 2 };
+
+    // lottery_stats saved in a directory, one file per stats_key. A file is
+    // written to a temporary name and renamed into place, so processes that
+    // share the directory only ever see whole files; if two of them compute
+    // the same stats, the last rename wins and both files were the same. A
+    // file that can't be read (or was written for a different key with the
+    // same hash) is a miss.
+    class stats_cache
+    {
+    public:
+        explicit stats_cache(std::filesystem::path directory) :
+            directory_{ std::move(directory) }
+        {
+            std::filesystem::create_directories(directory_);
+        }
+
+        std::filesystem::path const& directory() const noexcept
+        {
+            return directory_;
+        }
+
+        std::filesystem::path path_of(stats_key const& key) const
+        {
+            return directory_ / key.file_name();
+        }
+
+        std::optional<lottery_stats> load(stats_key const& key) const
+        {
+            const auto path = path_of(key);
+
+            std::error_code ec;
+            if (!std::filesystem::is_regular_file(path, ec))
+            {
+                return std::nullopt;
+            }
+
+            try
+            {
+                const io::mapped_file file{ path };
+                return parse(file.view(), key);
+            }
+            catch (std::exception const&)
+            {
+                return std::nullopt;
+            }
+        }
+
+        void store(stats_key const& key, lottery_stats const& stats) const
+        {
+            const auto& text = key.text();
+
+            io::output_buffer out{ stats_cache_magic.size() + 2 + 4 +
+                text.size() + export_size(stats, export_format::binary) };
+
+            out.append(stats_cache_magic);
+            out.append_le(stats_cache_version);
+            out.append_le(static_cast<std::uint32_t>(text.size()));
+            out.append(text);
+            write_stats(stats, export_format::binary, out);
+
+            const auto path = path_of(key);
+            auto temporary = path;
+            temporary += fmt::format(".{:016x}.tmp", random_seed());
+
+            try
+            {
+                out.write_to(temporary);
+                std::filesystem::rename(temporary, path);
+            }
+            catch (...)
+            {
+                std::error_code ec;
+                std::filesystem::remove(temporary, ec);
+                throw;
+            }
+        }
+
+        // The cached stats of key, or compute() stored under key. The
+        // teams are always key's, since the file doesn't keep the ties.
+        template <typename Compute>
+        std::pair<lottery_stats, bool> load_or_compute(stats_key const& key,
+            std::optional<lottery_teams> const& teams, Compute compute) const
+        {
+            if (auto stats = load(key))
+            {
+                stats->lottery_teams = teams;
+                return { std::move(*stats), true };
+            }
+
+            lottery_stats stats = compute();
+            store(key, stats);
+            return { std::move(stats), false };
+        }
+
+    private:
+        static lottery_stats parse(std::string_view bytes,
+            stats_key const& key)
+        {
+            detail::binary_stats_reader in{ bytes };
+
+            if (in.read_bytes(stats_cache_magic.size()) != stats_cache_magic ||
+                in.read<std::uint16_t>() != stats_cache_version)
+            {
+                throw std::runtime_error("Not a stats cache file");
+            }
+
+            const auto size = in.read<std::uint32_t>();
+            if (in.read_bytes(size) != key.text())
+            {
+                throw std::runtime_error("Different key");
+            }
+
+            const auto header = stats_cache_magic.size() + 2 + 4 + size;
+            return parse_binary_stats(bytes.substr(header));
+        }
+
+        std::filesystem::path directory_;
+    };
+}
@@ -1,12 +1,35 @@
 #pragma once
 
 #include <array>
+#include <optional>
 #include <span>
+#include <stdexcept>
+#include <algorithm>
+#include "nhl/league.h"
+#include "nhl/team.h"
 #include "nhl/lottery/lottery.h"
 #include "nhl/lottery/team.h"
 
 namespace nhl::lottery
 {
+    // Teams that finished tied on points. Their rankings come from the
+    // tiebreakers, so a group is always a run of consecutive rankings.
+    struct tie_group
+    {
+        int first_ranking;
+        int last_ranking;
+
+        constexpr bool contains(int ranking) const noexcept
+        {
+            return ranking >= first_ranking && ranking <= last_ranking;
+        }
+
+        constexpr std::size_t size() const noexcept
+        {
+            return static_cast<std::size_t>(last_ranking - first_ranking + 1);
+        }
+    };
+
     class lottery_teams
     {
     public:
@@ -21,10 +44,68 @@ namespace nhl::lottery
         using const_reference = typename teams_type::const_reference;
         using size_type = typename teams_type::size_type;
 
+        // every group has at least 2 teams
+        using ties_type = std::array<tie_group, nhl::lottery::team_count / 2>;
+
+        // Every ranking from 1 to team_count has to be used exactly once, and
+        // every team at most once
         constexpr explicit lottery_teams(teams_type const& teams) :
             teams_(teams)
         {
             std::ranges::sort(teams_, {}, &nhl::lottery::team::team_id);
+
+            std::array<bool, nhl::lottery::team_count> seen{};
+
+            for (auto const& t : teams_)
+            {
+                if (t.ranking < 1 ||
+                    t.ranking > static_cast<int>(teams_.size()) ||
+                    seen[static_cast<std::size_t>(t.ranking - 1)])
+                {
+                    throw std::invalid_argument("Invalid lottery ranking");
+                }
+
+                if (!team_id_values::ok(t.team_id) ||
+                    rankings_by_team_[static_cast<std::size_t>(t.team_id)] !=
+                    0)
+                {
+                    throw std::invalid_argument("Invalid lottery team");
+                }
+
+                seen[static_cast<std::size_t>(t.ranking - 1)] = true;
+                teams_by_ranking_[static_cast<std::size_t>(t.ranking - 1)] =
+                    t.team_id;
+                rankings_by_team_[static_cast<std::size_t>(t.team_id)] =
+                    t.ranking;
+            }
+        }
+
+        constexpr lottery_teams(teams_type const& teams,
+            std::span<tie_group const> ties) :
+            lottery_teams(teams)
+        {
+            if (ties.size() > ties_.size())
+            {
+                throw std::invalid_argument("Too many tie groups");
+            }
+
+            std::ranges::copy(ties, ties_.begin());
+            tie_count_ = ties.size();
+
+            const auto t = std::span{ ties_.data(), tie_count_ };
+            std::ranges::sort(t, {}, &tie_group::first_ranking);
+
+            int next_ranking{ 1 };
+            for (auto const& tie : t)
+            {
+                if (tie.first_ranking < next_ranking ||
+                    tie.last_ranking <= tie.first_ranking ||
+                    tie.last_ranking > static_cast<int>(teams_.size()))
+                {
+                    throw std::invalid_argument("Invalid tie group");
+                }
+                next_ranking = tie.last_ranking + 1;
+            }
         }
 
         // NOTE: This class is read-only once constructed
@@ -75,16 +156,52 @@ namespace nhl::lottery
         }
 
         constexpr std::optional<nhl::team_id> lookup(int ranking) const
+            noexcept
         {
-            if (auto pos = std::ranges::find(teams_, ranking,
-                &nhl::lottery::team::ranking); pos != std::ranges::end(teams_))
+            if (ranking < 1 || ranking > static_cast<int>(teams_.size()))
             {
-                return pos->team_id;
+                return std::nullopt;
             }
-            return std::nullopt;
+
+            return teams_by_ranking_[static_cast<std::size_t>(ranking - 1)];
+        }
+
+        // ranking must be 1 to team_count
+        constexpr nhl::team_id team_at(int ranking) const noexcept
+        {
+            return teams_by_ranking_[static_cast<std::size_t>(ranking - 1)];
+        }
+
+        // The team's lottery ranking, if it is in the lottery
+        constexpr std::optional<int> ranking_of(nhl::team_id id) const
+            noexcept
+        {
+            if (!team_id_values::ok(id))
+            {
+                return std::nullopt;
+            }
+
+            const auto ranking = rankings_by_team_[
+                static_cast<std::size_t>(id)];
+            return (ranking != 0) ? std::optional{ ranking } : std::nullopt;
+        }
+
+        // Sorted by ranking
+        constexpr std::span<tie_group const> ties() const noexcept
+        {
+            return { ties_.data(), tie_count_ };
         }
 
     private:
         teams_type teams_;
+
+        // [ranking - 1]
+        std::array<nhl::team_id, nhl::lottery::team_count> teams_by_ranking_{};
+
+        // [team id], 0 for the teams that aren't in the lottery
+        std::array<int, nhl::team_count> rankings_by_team_{};
+
+        ties_type ties_{};
+        std::size_t tie_count_{ 0 };
     };
 }
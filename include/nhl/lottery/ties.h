@@ -0,0 +1,72 @@
+#pragma once
+
+#include <span>
+#include <stdexcept>
+#include "nhl/lottery/lottery.h"
+#include "nhl/lottery/rules.h"
+#include "nhl/lottery/teams.h"
+
+namespace nhl::lottery
+{
+    // Pools the combinations of each group of tied rankings and splits them
+    // evenly between the tied teams. Any remainder is handed out one
+    // combination at a time in ranking order, so the teams the tiebreakers
+    // ranked first get the extra combinations. Index 0 of combinations is
+    // ranking 1.
+    constexpr void split_tied_combinations(std::span<std::size_t> combinations,
+        std::span<tie_group const> ties)
+    {
+        for (auto const& tie : ties)
+        {
+            if (tie.first_ranking < 1 ||
+                tie.last_ranking <= tie.first_ranking ||
+                static_cast<std::size_t>(tie.last_ranking) >
+                combinations.size())
+            {
+                throw std::out_of_range("Invalid tie group");
+            }
+
+            const auto group = combinations.subspan(
+                static_cast<std::size_t>(tie.first_ranking - 1), tie.size());
+
+            std::size_t pooled{ 0 };
+            for (auto c : group)
+            {
+                pooled += c;
+            }
+
+            const auto share = pooled / group.size();
+            auto remainder = pooled % group.size();
+
+            for (auto& c : group)
+            {
+                c = share;
+                if (remainder > 0)
+                {
+                    ++c;
+                    --remainder;
+                }
+            }
+        }
+    }
+
+    // The standard format with the combinations of the teams' tie groups
+    // split
+    inline lottery_format format_for(lottery_teams const& teams,
+        std::size_t rounds = lottery_rounds)
+    {
+        auto ret = format_of<standard_rules>();
+        ret.rounds = rounds;
+        split_tied_combinations(ret.combinations_per_ranking, teams.ties());
+        return ret;
+    }
+
+    static_assert([]()
+        {
+            // 115 + 95 + 85 = 295 = 3 * 98 + 1
+            auto c = standard_rules::combinations_per_ranking;
+            const tie_group ties[]{ { 3, 5 } };
+            split_tied_combinations(c, ties);
+            return c[2] == 99 && c[3] == 98 && c[4] == 98 && c[5] == 75;
+        }());
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <algorithm>
+
+namespace nhl
+{
+    // A map that holds at most capacity entries and drops the least recently
+    // used one to make room. Lookups and inserts are O(1): the entries are
+    // kept in a list in order of use, and the map points into it. It isn't
+    // thread safe.
+    template <typename Key, typename Value, typename Hash = std::hash<Key>>
+    class lru_cache
+    {
+    public:
+        explicit lru_cache(std::size_t capacity) :
+            capacity_{ (std::max)(std::size_t{ 1 }, capacity) }
+        {
+        }
+
+        std::size_t size() const noexcept
+        {
+            return index_.size();
+        }
+
+        std::size_t capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        // The value of key, now the most recently used, or nullptr. The
+        // pointer is valid until the next insert.
+        Value const* find(Key const& key)
+        {
+            const auto pos = index_.find(key);
+            if (pos == index_.end())
+            {
+                return nullptr;
+            }
+
+            entries_.splice(entries_.begin(), entries_, pos->second);
+            return &pos->second->second;
+        }
+
+        // Adds or replaces the value of key, as the most recently used
+        void insert(Key const& key, Value value)
+        {
+            if (const auto pos = index_.find(key); pos != index_.end())
+            {
+                pos->second->second = std::move(value);
+                entries_.splice(entries_.begin(), entries_, pos->second);
+                return;
+            }
+
+            if (index_.size() == capacity_)
+            {
+                index_.erase(entries_.back().first);
+                entries_.pop_back();
+            }
+
+            entries_.emplace_front(key, std::move(value));
+            index_.emplace(key, entries_.begin());
+        }
+
+        void clear() noexcept
+        {
+            index_.clear();
+            entries_.clear();
+        }
+
+    private:
+        using entry = std::pair<Key, Value>;
+
+        std::size_t capacity_;
+        std::list<entry> entries_;
+        std::unordered_map<Key, typename std::list<entry>::iterator, Hash>
+            index_;
+    };
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+
+namespace math
+{
+    struct fit_test_result
+    {
+        double statistic{ 0.0 };
+        std::size_t degrees_of_freedom{ 0 };
+
+        // the probability of a statistic at least this large if the counts
+        // did come from the distribution
+        double p_value{ 1.0 };
+    };
+
+    namespace detail
+    {
+        // The regularized upper incomplete gamma function Q(a, x): a series
+        // below a + 1 and a continued fraction (modified Lentz) above it
+        //
+        // Reference:
+        // Numerical Recipes, 3rd edition, section 6.2
+        inline double gamma_q(double a, double x)
+        {
+            if (x <= 0.0)
+            {
+                return 1.0;
+            }
+
+            constexpr int max_iterations{ 1000 };
+            constexpr double epsilon{ 1e-15 };
+            constexpr double tiny{ 1e-300 };
+
+            const auto log_prefix = a * std::log(x) - x - std::lgamma(a);
+
+            if (x < a + 1.0)
+            {
+                auto term = 1.0 / a;
+                auto sum = term;
+
+                for (int n = 1; n < max_iterations; ++n)
+                {
+                    term *= x / (a + n);
+                    sum += term;
+
+                    if (std::abs(term) < std::abs(sum) * epsilon)
+                    {
+                        break;
+                    }
+                }
+
+                return 1.0 - sum * std::exp(log_prefix);
+            }
+
+            auto b = x + 1.0 - a;
+            auto c = 1.0 / tiny;
+            auto d = 1.0 / b;
+            auto h = d;
+
+            for (int n = 1; n < max_iterations; ++n)
+            {
+                const auto an = -n * (n - a);
+                b += 2.0;
+
+                d = an * d + b;
+                d = (std::abs(d) < tiny) ? tiny : d;
+                c = b + an / c;
+                c = (std::abs(c) < tiny) ? tiny : c;
+                d = 1.0 / d;
+
+                const auto delta = d * c;
+                h *= delta;
+
+                if (std::abs(delta - 1.0) < epsilon)
+                {
+                    break;
+                }
+            }
+
+            return std::exp(log_prefix) * h;
+        }
+    }
+
+    // P(X >= x) for a chi-square distribution with k degrees of freedom
+    inline double chi_square_p_value(double x, std::size_t k)
+    {
+        if (k == 0)
+        {
+            return (x > 0.0) ? 0.0 : 1.0;
+        }
+
+        return detail::gamma_q(static_cast<double>(k) / 2.0, x / 2.0);
+    }
+
+    namespace detail
+    {
+        // Adds f(observed, expected) over the bins with an expected count,
+        // where probabilities are the bins' probabilities (normalized here).
+        // An observation in a bin that can't happen fails the test outright.
+        template <typename Term>
+        fit_test_result fit_test(std::span<std::size_t const> observed,
+            std::span<double const> probabilities, Term term)
+        {
+            if (observed.size() != probabilities.size())
+            {
+                throw std::invalid_argument("Each bin needs a probability");
+            }
+
+            const auto total = static_cast<double>(std::accumulate(
+                observed.begin(), observed.end(), std::size_t{ 0 }));
+            const auto probability_sum = std::accumulate(
+                probabilities.begin(), probabilities.end(), 0.0);
+
+            fit_test_result ret;
+            std::size_t bins{ 0 };
+
+            for (std::size_t i = 0; i < observed.size(); ++i)
+            {
+                const auto o = static_cast<double>(observed[i]);
+
+                if (probabilities[i] <= 0.0)
+                {
+                    if (observed[i] > 0)
+                    {
+                        return { std::numeric_limits<double>::infinity(), 0,
+                            0.0 };
+                    }
+                    continue;
+                }
+
+                ret.statistic += term(o, total * probabilities[i] /
+                    probability_sum);
+                ++bins;
+            }
+
+            ret.degrees_of_freedom = (bins > 1) ? bins - 1 : 0;
+            ret.p_value = chi_square_p_value(ret.statistic,
+                ret.degrees_of_freedom);
+            return ret;
+        }
+    }
+
+    // Pearson's test of the counts against the probabilities of their bins.
+    // The approximation needs an expected count of about 5 or more per bin.
+    inline fit_test_result chi_square_test(
+        std::span<std::size_t const> observed,
+        std::span<double const> probabilities)
+    {
+        return detail::fit_test(observed, probabilities,
+            [](double o, double e)
+            {
+                return (o - e) * (o - e) / e;
+            });
+    }
+
+    // The likelihood ratio (G) test, 2 * sum(o * ln(o / e)), which is also
+    // compared to the chi-square distribution
+    inline fit_test_result g_test(std::span<std::size_t const> observed,
+        std::span<double const> probabilities)
+    {
+        return detail::fit_test(observed, probabilities,
+            [](double o, double e)
+            {
+                return (o > 0.0) ? 2.0 * o * std::log(o / e) : 0.0;
+            });
+    }
+}
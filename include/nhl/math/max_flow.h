@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+
+namespace math
+{
+    // Dinic's algorithm
+    // Reference:
+    // https://cp-algorithms.com/graph/dinic.html
+    class max_flow
+    {
+    public:
+        using capacity_type = std::int64_t;
+
+        static constexpr capacity_type infinite_capacity =
+            std::numeric_limits<capacity_type>::max() / 4;
+
+        explicit max_flow(std::size_t nodes = 0) :
+            adjacency_(nodes)
+        {
+        }
+
+        void reset(std::size_t nodes)
+        {
+            edges_.clear();
+            adjacency_.assign(nodes, {});
+        }
+
+        std::size_t add_node()
+        {
+            adjacency_.emplace_back();
+            return adjacency_.size() - 1;
+        }
+
+        std::size_t node_count() const noexcept
+        {
+            return adjacency_.size();
+        }
+
+        void add_edge(std::size_t from, std::size_t to, capacity_type capacity)
+        {
+            if (from >= adjacency_.size() || to >= adjacency_.size())
+            {
+                throw std::out_of_range("Invalid node");
+            }
+
+            adjacency_[from].push_back(edges_.size());
+            edges_.push_back({ to, capacity });
+            adjacency_[to].push_back(edges_.size());
+            edges_.push_back({ from, 0 });
+        }
+
+        capacity_type compute(std::size_t source, std::size_t sink)
+        {
+            capacity_type ret{ 0 };
+
+            level_.resize(adjacency_.size());
+            next_.resize(adjacency_.size());
+
+            while (build_levels(source, sink))
+            {
+                std::ranges::fill(next_, 0);
+
+                while (const auto pushed = push(source, sink,
+                    infinite_capacity))
+                {
+                    ret += pushed;
+                }
+            }
+
+            return ret;
+        }
+
+    private:
+        struct edge
+        {
+            std::size_t to;
+            capacity_type capacity;
+        };
+
+        bool build_levels(std::size_t source, std::size_t sink)
+        {
+            std::ranges::fill(level_, -1);
+            level_[source] = 0;
+
+            std::queue<std::size_t> q;
+            q.push(source);
+
+            while (!q.empty())
+            {
+                const auto node = q.front();
+                q.pop();
+
+                for (auto e : adjacency_[node])
+                {
+                    auto const& edge = edges_[e];
+                    if (edge.capacity > 0 && level_[edge.to] < 0)
+                    {
+                        level_[edge.to] = level_[node] + 1;
+                        q.push(edge.to);
+                    }
+                }
+            }
+
+            return level_[sink] >= 0;
+        }
+
+        capacity_type push(std::size_t node, std::size_t sink,
+            capacity_type flow)
+        {
+            if (node == sink)
+            {
+                return flow;
+            }
+
+            for (auto& i = next_[node]; i < adjacency_[node].size(); ++i)
+            {
+                const auto e = adjacency_[node][i];
+                auto& edge = edges_[e];
+
+                if (edge.capacity <= 0 || level_[edge.to] != level_[node] + 1)
+                {
+                    continue;
+                }
+
+                if (const auto pushed = push(edge.to, sink,
+                    std::min(flow, edge.capacity)))
+                {
+                    edge.capacity -= pushed;
+                    edges_[e ^ 1].capacity += pushed;
+                    return pushed;
+                }
+            }
+
+            return 0;
+        }
+
+        std::vector<edge> edges_;
+        std::vector<std::vector<std::size_t>> adjacency_;
+        std::vector<int> level_;
+        std::vector<std::size_t> next_;
+    };
+}
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <unordered_set>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include "nhl/game.h"
+#include "nhl/season.h"
+#include "nhl/standings.h"
+
+namespace nhl
+{
+    // The outcome of every remaining game, 3 bits per game. Outcomes never
+    // straddle two words, so 21 fit in each 64-bit word (the top bit is
+    // unused).
+    namespace packing
+    {
+        using word_type = std::uint64_t;
+
+        inline constexpr std::size_t outcome_bits{ 3 };
+        static_assert(game_outcome_count <= (1u << outcome_bits));
+
+        inline constexpr std::size_t outcomes_per_word{
+            (sizeof(word_type) * 8) / outcome_bits };
+        static_assert(outcomes_per_word == 21);
+
+        inline constexpr word_type outcome_mask{ (1u << outcome_bits) - 1 };
+
+        constexpr std::size_t word_count(std::size_t outcomes) noexcept
+        {
+            return (outcomes + outcomes_per_word - 1) / outcomes_per_word;
+        }
+
+        constexpr game_outcome get(std::span<word_type const> words,
+            std::size_t i) noexcept
+        {
+            const auto shift = (i % outcomes_per_word) * outcome_bits;
+            return static_cast<game_outcome>(
+                (words[i / outcomes_per_word] >> shift) & outcome_mask);
+        }
+
+        constexpr void set(std::span<word_type> words, std::size_t i,
+            game_outcome outcome) noexcept
+        {
+            const auto shift = (i % outcomes_per_word) * outcome_bits;
+            auto& w = words[i / outcomes_per_word];
+            w = (w & ~(outcome_mask << shift)) |
+                (static_cast<word_type>(outcome) << shift);
+        }
+
+        // FNV-1a over the words
+        constexpr std::size_t hash(std::span<word_type const> words) noexcept
+        {
+            std::uint64_t ret{ 14695981039346656037ull };
+            for (auto w : words)
+            {
+                for (std::size_t b = 0; b < sizeof(word_type); ++b)
+                {
+                    ret = (ret ^ ((w >> (b * 8)) & 0xff)) * 1099511628211ull;
+                }
+            }
+            return static_cast<std::size_t>(ret);
+        }
+
+        // Plays the games with the given outcomes
+        constexpr void apply(team_records& records,
+            std::span<game const> games, std::span<word_type const> words)
+        {
+            if (word_count(games.size()) != words.size())
+            {
+                throw std::invalid_argument(
+                    "The outcomes don't match the games");
+            }
+
+            for (std::size_t i = 0; i < games.size(); ++i)
+            {
+                nhl::apply(records, games[i], get(words, i));
+            }
+        }
+    }
+
+    class packed_outcomes
+    {
+    public:
+        using word_type = packing::word_type;
+
+        constexpr packed_outcomes() = default;
+
+        // every game defaults to game_outcome::home_regulation
+        constexpr explicit packed_outcomes(std::size_t games) :
+            size_{ games },
+            words_(packing::word_count(games))
+        {
+        }
+
+        constexpr explicit packed_outcomes(std::span<word_type const> words,
+            std::size_t games) :
+            size_{ games },
+            words_{ words.begin(), words.end() }
+        {
+            if (words_.size() != packing::word_count(games))
+            {
+                throw std::invalid_argument("Invalid number of words");
+            }
+        }
+
+        constexpr std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        constexpr std::span<word_type const> words() const noexcept
+        {
+            return words_;
+        }
+
+        constexpr game_outcome operator[](std::size_t i) const noexcept
+        {
+            return packing::get(words_, i);
+        }
+
+        constexpr game_outcome at(std::size_t i) const
+        {
+            if (i >= size_)
+            {
+                throw std::out_of_range("Invalid game index");
+            }
+            return (*this)[i];
+        }
+
+        constexpr void set(std::size_t i, game_outcome outcome)
+        {
+            if (i >= size_)
+            {
+                throw std::out_of_range("Invalid game index");
+            }
+
+            if (!game_outcome_values::ok(outcome))
+            {
+                throw std::out_of_range("Invalid game outcome");
+            }
+
+            packing::set(words_, i, outcome);
+        }
+
+        constexpr auto operator<=>(packed_outcomes const&) const = default;
+
+    private:
+        std::size_t size_{ 0 };
+        std::vector<word_type> words_;
+    };
+
+    constexpr void apply(team_records& records, std::span<game const> games,
+        packed_outcomes const& outcomes)
+    {
+        packing::apply(records, games, outcomes.words());
+    }
+
+    // The outcomes of many seasons over the same games, stored back to back
+    // with a fixed number of words per season
+    class packed_outcome_store
+    {
+    public:
+        using word_type = packing::word_type;
+
+        explicit packed_outcome_store(std::size_t games) :
+            games_{ games },
+            stride_{ packing::word_count(games) }
+        {
+        }
+
+        std::size_t games() const noexcept
+        {
+            return games_;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        std::size_t memory_usage() const noexcept
+        {
+            return words_.size() * sizeof(word_type);
+        }
+
+        void resize(std::size_t seasons)
+        {
+            words_.resize(seasons * stride_);
+            size_ = seasons;
+        }
+
+        void push_back(packed_outcomes const& outcomes)
+        {
+            if (outcomes.size() != games_)
+            {
+                throw std::invalid_argument(
+                    "The outcomes don't match the games");
+            }
+
+            words_.insert(words_.end(), outcomes.words().begin(),
+                outcomes.words().end());
+            ++size_;
+        }
+
+        std::span<word_type const> words(std::size_t season) const noexcept
+        {
+            return { words_.data() + season * stride_, stride_ };
+        }
+
+        packed_outcomes operator[](std::size_t season) const
+        {
+            return packed_outcomes{ words(season), games_ };
+        }
+
+        game_outcome outcome(std::size_t season, std::size_t game_index) const
+            noexcept
+        {
+            return packing::get(words(season), game_index);
+        }
+
+        // Seasons only ever write their own words, so different seasons can
+        // be set from different threads
+        void set(std::size_t season, std::size_t game_index,
+            game_outcome outcome) noexcept
+        {
+            packing::set({ words_.data() + season * stride_, stride_ },
+                game_index, outcome);
+        }
+
+        std::size_t hash(std::size_t season) const noexcept
+        {
+            return packing::hash(words(season));
+        }
+
+        bool equal(std::size_t lhs, std::size_t rhs) const noexcept
+        {
+            return std::ranges::equal(words(lhs), words(rhs));
+        }
+
+        // The number of different seasons
+        std::size_t distinct_count() const
+        {
+            const auto hasher = [this](std::size_t season)
+            {
+                return hash(season);
+            };
+
+            const auto key_equal = [this](std::size_t lhs, std::size_t rhs)
+            {
+                return equal(lhs, rhs);
+            };
+
+            std::unordered_set<std::size_t, decltype(hasher),
+                decltype(key_equal)> seen(size_, hasher, key_equal);
+
+            for (std::size_t s = 0; s < size_; ++s)
+            {
+                seen.insert(s);
+            }
+
+            return seen.size();
+        }
+
+    private:
+        std::size_t games_;
+        std::size_t stride_;
+        std::size_t size_{ 0 };
+        std::vector<word_type> words_;
+    };
+}
+
+template <>
+struct std::hash<nhl::packed_outcomes>
+{
+    std::size_t operator()(nhl::packed_outcomes const& outcomes) const noexcept
+    {
+        return nhl::packing::hash(outcomes.words());
+    }
+};
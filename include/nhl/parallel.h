@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <vector>
+#include "nhl/thread_pool.h"
+
+namespace nhl
+{
+    // Simulations are split into fixed size blocks, each one with its own
+    // random stream (the block index), so the results only depend on the seed
+    // and not on the number of threads or which thread ran which block
+    inline constexpr std::size_t simulation_block_size{ 4096 };
+
+    struct block_range
+    {
+        std::size_t first;
+        std::size_t last;
+
+        constexpr std::size_t size() const noexcept
+        {
+            return last - first;
+        }
+    };
+
+    constexpr std::size_t block_count(std::size_t simulations) noexcept
+    {
+        return (simulations + simulation_block_size - 1) /
+            simulation_block_size;
+    }
+
+    constexpr block_range block_at(std::size_t simulations, std::size_t block)
+        noexcept
+    {
+        const auto first = block * simulation_block_size;
+        return { first, std::min(first + simulation_block_size, simulations) };
+    }
+
+    // Runs body(state, block) for every block in [first_block, last_block),
+    // where each worker creates its state once with make_state() and then
+    // keeps claiming blocks until there are none left. The per-worker states
+    // are returned so the caller can merge them.
+    template <typename MakeState, typename Body>
+    auto run_blocks(thread_pool& pool, std::size_t first_block,
+        std::size_t last_block, MakeState make_state, Body body)
+    {
+        using state_type = std::invoke_result_t<MakeState&>;
+
+        const auto blocks = (last_block > first_block) ?
+            last_block - first_block : 0;
+        const auto workers = std::max(std::size_t{ 1 },
+            std::min(pool.size(), blocks));
+
+        std::atomic<std::size_t> next_block{ first_block };
+
+        std::vector<std::future<state_type>> futures;
+        futures.reserve(workers);
+
+        for (std::size_t w = 0; w < workers; ++w)
+        {
+            futures.push_back(pool.submit([&]()
+            {
+                auto state = make_state();
+
+                for (auto block = next_block.fetch_add(1,
+                    std::memory_order_relaxed); block < last_block;
+                    block = next_block.fetch_add(1, std::memory_order_relaxed))
+                {
+                    body(state, block);
+                }
+
+                return state;
+            }));
+        }
+
+        // the tasks reference locals, so they must all finish before an
+        // exception can be rethrown by get()
+        for (auto& f : futures)
+        {
+            f.wait();
+        }
+
+        std::vector<state_type> ret;
+        ret.reserve(workers);
+
+        for (auto& f : futures)
+        {
+            ret.push_back(f.get());
+        }
+
+        return ret;
+    }
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include "nhl/print.h"
+
+namespace nhl
+{
+    // The simulations done so far, one counter per worker. Each worker adds
+    // to its own counter on its own cache line and readers sum them, all with
+    // relaxed atomics, so a worker never waits on a reader.
+    class progress_counters
+    {
+    public:
+        progress_counters(std::size_t total, std::size_t workers) :
+            total_{ total },
+            workers_{ (std::max)(std::size_t{ 1 }, workers) },
+            slots_{ std::make_unique<slot[]>(workers_) }
+        {
+        }
+
+        std::size_t total() const noexcept
+        {
+            return total_;
+        }
+
+        // The counter of a worker, claimed once when the worker starts. There
+        // are only as many counters as workers, so a run that starts more
+        // workers than that shares them.
+        std::size_t claim() noexcept
+        {
+            return next_.fetch_add(1, std::memory_order_relaxed) % workers_;
+        }
+
+        void add(std::size_t counter, std::size_t simulations) noexcept
+        {
+            slots_[counter].done.fetch_add(simulations,
+                std::memory_order_relaxed);
+        }
+
+        // A snapshot; it may trail the workers by a few blocks
+        std::size_t completed() const noexcept
+        {
+            std::size_t ret{ 0 };
+            for (std::size_t i = 0; i < workers_; ++i)
+            {
+                ret += slots_[i].done.load(std::memory_order_relaxed);
+            }
+            return ret;
+        }
+
+    private:
+        // padded so workers don't share a cache line
+        struct alignas(64) slot
+        {
+            std::atomic<std::size_t> done{ 0 };
+        };
+
+        std::size_t total_;
+        std::size_t workers_;
+        std::unique_ptr<slot[]> slots_;
+        std::atomic<std::size_t> next_{ 0 };
+    };
+
+    // Samples the counters from its own thread every interval and prints the
+    // simulations per second, the time left and the width of a 95%
+    // confidence interval on the estimated probabilities. The width is the
+    // widest one (p = 0.5) for the simulations done per estimate, since the
+    // estimates themselves are only merged at the end. The reporter stops,
+    // without a final line, when it's destroyed.
+    class progress_reporter
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        // estimates is the number of independent results the simulations
+        // are split between (e.g. the scenarios of a batch)
+        progress_reporter(progress_counters const& counters,
+            std::chrono::milliseconds interval, std::size_t estimates = 1) :
+            counters_{ counters },
+            interval_{ interval },
+            estimates_{ (std::max)(std::size_t{ 1 }, estimates) },
+            thread_{ [this](std::stop_token stop) { run(stop); } }
+        {
+        }
+
+        progress_reporter(progress_reporter const&) = delete;
+        progress_reporter& operator=(progress_reporter const&) = delete;
+
+        ~progress_reporter()
+        {
+            thread_.request_stop();
+        }
+
+    private:
+        void run(std::stop_token stop)
+        {
+            const auto start = clock::now();
+
+            std::mutex mutex;
+            std::condition_variable_any wake;
+            std::unique_lock lock{ mutex };
+
+            // nothing notifies wake; the wait ends after the interval, or
+            // early when a stop is requested
+            while (true)
+            {
+                wake.wait_for(lock, stop, interval_, []() { return false; });
+
+                if (stop.stop_requested())
+                {
+                    return;
+                }
+
+                print(counters_.completed(), clock::now() - start);
+            }
+        }
+
+        void print(std::size_t done, clock::duration elapsed) const
+        {
+            const auto total = counters_.total();
+            const auto seconds =
+                std::chrono::duration<double>(elapsed).count();
+            const auto rate = (seconds > 0.0) ?
+                static_cast<double>(done) / seconds : 0.0;
+
+            const auto percent = (total > 0) ?
+                static_cast<double>(done) / static_cast<double>(total) * 100.0 :
+                100.0;
+            const auto eta = (rate > 0.0 && total > done) ?
+                static_cast<double>(total - done) / rate : 0.0;
+
+            // 1.96 * sqrt(0.25 / n) on each side
+            const auto per_estimate = done / estimates_;
+            const auto ci = (per_estimate > 0) ? 2.0 * 0.98 /
+                std::sqrt(static_cast<double>(per_estimate)) * 100.0 : 100.0;
+
+            temp::println("[ Progress ] {} of {} ({:.1f}%), {:.0f} "
+                "simulations/s, ETA {:.1f}s, 95% CI width <= {:.3f} pp",
+                done, total, percent, rate, eta, ci);
+        }
+
+        progress_counters const& counters_;
+        std::chrono::milliseconds interval_;
+        std::size_t estimates_;
+        std::jthread thread_;
+    };
+}
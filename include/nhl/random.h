@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+namespace nhl
+{
+    using random_engine = std::mt19937_64;
+
+    inline std::uint64_t random_seed()
+    {
+        std::random_device rd;
+        return (std::uint64_t{ rd() } << 32) | std::uint64_t{ rd() };
+    }
+
+    // Creates an engine for an independent stream of random numbers. The same
+    // seed and stream always produce the same sequence, which is what allows
+    // work to be split across threads without changing the results.
+    inline random_engine make_random_engine(std::uint64_t seed,
+        std::uint64_t stream)
+    {
+        std::seed_seq seq
+        {
+            static_cast<std::uint32_t>(seed),
+            static_cast<std::uint32_t>(seed >> 32),
+            static_cast<std::uint32_t>(stream),
+            static_cast<std::uint32_t>(stream >> 32)
+        };
+
+        return random_engine{ seq };
+    }
+}
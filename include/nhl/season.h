@@ -0,0 +1,253 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include "nhl/game.h"
+#include "nhl/standings.h"
+
+namespace nhl
+{
+    struct game_model_options
+    {
+        // added to the home team's probability of winning
+        double home_advantage{ 0.04 };
+
+        // proportion of games that are tied after regulation
+        double overtime_rate{ 0.23 };
+
+        // proportion of tied games that are decided by a shootout
+        double shootout_rate{ 0.35 };
+    };
+
+    using outcome_probabilities = std::array<double, game_outcome_count>;
+
+    namespace detail
+    {
+        constexpr double strength(team_record const& r) noexcept
+        {
+            if (r.games_played == 0)
+            {
+                return 0.5;
+            }
+
+            // points percentage, kept away from 0 and 1 so that every team
+            // can still win (or lose) any game
+            return std::clamp(static_cast<double>(points(r)) /
+                (2.0 * r.games_played), 0.05, 0.95);
+        }
+    }
+
+    // Estimates the probability of each outcome by comparing the points
+    // percentage of both teams (log5), adjusted for home ice
+    constexpr outcome_probabilities outcome_odds(team_record const& visitor,
+        team_record const& home, game_model_options const& options = {})
+    {
+        const auto h = detail::strength(home);
+        const auto v = detail::strength(visitor);
+
+        const auto home_win = std::clamp(
+            (h * (1.0 - v)) / ((h * (1.0 - v)) + (v * (1.0 - h))) +
+            options.home_advantage, 0.01, 0.99);
+        const auto visitor_win = 1.0 - home_win;
+
+        const auto regulation = 1.0 - options.overtime_rate;
+        const auto overtime = options.overtime_rate *
+            (1.0 - options.shootout_rate);
+        const auto shootout = options.overtime_rate * options.shootout_rate;
+
+        // shootouts are treated as a coin flip
+        return
+        {
+            home_win * regulation,
+            home_win * overtime,
+            0.5 * shootout,
+            visitor_win * regulation,
+            visitor_win * overtime,
+            0.5 * shootout
+        };
+    }
+
+    constexpr void apply(team_records& records, game const& g,
+        game_outcome outcome) noexcept
+    {
+        apply(outcome, records[static_cast<std::size_t>(winner(g, outcome))],
+            records[static_cast<std::size_t>(loser(g, outcome))]);
+    }
+
+    // Updates the records of both participants, including goals
+    constexpr void apply(team_records& records, game_result const& result)
+        noexcept
+    {
+        apply(records, result.game, result.outcome);
+
+        auto& visitor = records[static_cast<std::size_t>(result.game.visitor)];
+        auto& home = records[static_cast<std::size_t>(result.game.home)];
+
+        visitor.goals_for += result.visitor_goals;
+        visitor.goals_against += result.home_goals;
+        home.goals_for += result.home_goals;
+        home.goals_against += result.visitor_goals;
+    }
+
+    // The standings after the given games, starting from empty records
+    constexpr team_records standings_after(std::span<game_result const> results)
+    {
+        auto ret = index_by_team({});
+        for (auto const& r : results)
+        {
+            if (!team_id_values::ok(r.game.visitor) ||
+                !team_id_values::ok(r.game.home))
+            {
+                throw std::out_of_range("Invalid team id");
+            }
+
+            apply(ret, r);
+        }
+        return ret;
+    }
+
+    struct null_outcome_observer
+    {
+        constexpr void operator()(std::size_t, game_outcome) const noexcept
+        {
+        }
+    };
+
+    // The records at a point in the season, the games left to be played and
+    // the odds of each outcome of those games
+    class season_model
+    {
+    public:
+        season_model(team_records const& records, std::span<game const> games,
+            game_model_options const& options = {}) :
+            records_{ records },
+            games_{ games.begin(), games.end() }
+        {
+            cumulative_.reserve(games_.size());
+
+            for (auto const& g : games_)
+            {
+                if (!team_id_values::ok(g.visitor) ||
+                    !team_id_values::ok(g.home))
+                {
+                    throw std::out_of_range("Invalid team id");
+                }
+
+                const auto odds = outcome_odds(
+                    records_[static_cast<std::size_t>(g.visitor)],
+                    records_[static_cast<std::size_t>(g.home)], options);
+
+                outcome_probabilities cumulative{};
+                double total{ 0.0 };
+                for (std::size_t i = 0; i < odds.size(); ++i)
+                {
+                    total += odds[i];
+                    cumulative[i] = total;
+                }
+
+                cumulative_.push_back(cumulative);
+            }
+        }
+
+        team_records const& records() const noexcept
+        {
+            return records_;
+        }
+
+        std::span<game const> games() const noexcept
+        {
+            return games_;
+        }
+
+        outcome_probabilities probabilities(std::size_t game_index) const
+        {
+            auto const& cumulative = cumulative_.at(game_index);
+
+            outcome_probabilities ret{};
+            double previous{ 0.0 };
+            for (std::size_t i = 0; i < ret.size(); ++i)
+            {
+                ret[i] = cumulative[i] - previous;
+                previous = cumulative[i];
+            }
+
+            return ret;
+        }
+
+        // Replaces the odds of a game; the probabilities are normalized so
+        // they only need to be relative to each other
+        void set_probabilities(std::size_t game_index,
+            outcome_probabilities const& probabilities)
+        {
+            auto& cumulative = cumulative_.at(game_index);
+
+            double sum{ 0.0 };
+            for (auto const& p : probabilities)
+            {
+                if (p < 0.0)
+                {
+                    throw std::invalid_argument(
+                        "Outcome probabilities can't be negative");
+                }
+                sum += p;
+            }
+
+            if (sum <= 0.0)
+            {
+                throw std::invalid_argument(
+                    "At least one outcome must be possible");
+            }
+
+            double total{ 0.0 };
+            for (std::size_t i = 0; i < probabilities.size(); ++i)
+            {
+                total += probabilities[i] / sum;
+                cumulative[i] = total;
+            }
+        }
+
+        template <std::uniform_random_bit_generator URBG>
+        game_outcome sample(std::size_t game_index, URBG& gen) const
+        {
+            std::uniform_real_distribution<double> dist{ 0.0, 1.0 };
+            const auto u = dist(gen);
+
+            auto const& cumulative = cumulative_[game_index];
+
+            std::size_t i{ 0 };
+            while (i < cumulative.size() - 1 && u >= cumulative[i])
+            {
+                ++i;
+            }
+
+            return static_cast<game_outcome>(i);
+        }
+
+        // Plays out the rest of the season, calling on_outcome(game_index,
+        // outcome) for every game, and returns the final records
+        template <std::uniform_random_bit_generator URBG,
+            typename OnOutcome = null_outcome_observer>
+        team_records simulate(URBG& gen, OnOutcome&& on_outcome = {}) const
+        {
+            auto ret = records_;
+
+            for (std::size_t i = 0; i < games_.size(); ++i)
+            {
+                const auto outcome = sample(i, gen);
+                on_outcome(i, outcome);
+                apply(ret, games_[i], outcome);
+            }
+
+            return ret;
+        }
+
+    private:
+        team_records records_;
+        std::vector<game> games_;
+        std::vector<outcome_probabilities> cumulative_;
+    };
+}
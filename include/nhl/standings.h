@@ -1,81 +1,190 @@
 #pragma once
 
 #include <array>
-#include "team_record.h"
+#include <span>
+#include <algorithm>
+#include <stdexcept>
+#include "nhl/league.h"
+#include "nhl/conference.h"
+#include "nhl/division.h"
+#include "nhl/team_record.h"
 
-struct standings
+namespace nhl
 {
-    std::array<team_record, 32> teams =
+    // Standings as of the snapshot that remaining_games was taken from
+    inline constexpr std::array standings
     {
-        team_record{ BOS, 77, 60, 12, 5, 50, 56, 4, 3, 286, 166 },
-        team_record{ CAR, 77, 50, 18, 9, 37, 46, 4, 3, 251, 198 },
-        team_record{ NJD, 78, 49, 21, 8, 37, 47, 2, 4, 271, 217 },
-        team_record{ VGK, 78, 48, 22, 8, 35, 43, 5, 3, 259, 223 },
-        team_record{ TOR, 77, 46, 21, 10, 39, 45, 1, 2, 262, 213 },
-        team_record{ NYR, 77, 45, 21, 11, 35, 41, 4, 2, 261, 207 },
-        team_record{ EDM, 78, 46, 23, 9, 42, 46, 0, 4, 309, 255 },
-        team_record{ LAK, 78, 45, 23, 10, 35, 39, 6, 3, 267, 245 },
-        team_record{ COL, 76, 46, 24, 6, 32, 40, 6, 3, 256, 210 },
-        team_record{ DAL, 77, 42, 21, 14, 35, 39, 3, 3, 267, 213 },
-        team_record{ MIN, 77, 44, 23, 10, 32, 37, 7, 6, 232, 209 },
-        team_record{ TBL, 77, 45, 26, 6, 37, 42, 3, 2, 267, 231 },
-        team_record{ SEA, 77, 43, 26, 8, 34, 43, 0, 4, 272, 243 },
-        team_record{ WPG, 77, 43, 31, 3, 33, 42, 1, 1, 233, 215 },
-        team_record{ FLA, 78, 40, 31, 7, 34, 38, 2, 1, 274, 261 },
-        team_record{ NYI, 78, 39, 30, 9, 33, 38, 1, 5, 227, 214 },
-        team_record{ CGY, 78, 36, 27, 15, 29, 34, 2, 3, 250, 244 },
-        team_record{ NSH, 77, 39, 30, 8, 28, 34, 5, 2, 216, 227 },
-        team_record{ PIT, 78, 38, 30, 10, 29, 37, 1, 1, 249, 254 },
-        team_record{ BUF, 76, 37, 32, 7, 28, 36, 1, 3, 271, 278 },
-        team_record{ OTT, 78, 37, 34, 7, 29, 35, 2, 1, 246, 254 },
-        team_record{ DET, 77, 35, 33, 9, 28, 32, 3, 3, 231, 252 },
-        team_record{ STL, 78, 36, 35, 7, 27, 33, 3, 3, 255, 288 },
-        team_record{ WSH, 77, 34, 34, 9, 26, 32, 2, 4, 240, 243 },
-        team_record{ VAN, 77, 34, 36, 7, 22, 29, 5, 2, 262, 287 },
-        team_record{ PHI, 77, 29, 35, 13, 26, 27, 2, 1, 209, 257 },
-        team_record{ ARI, 78, 27, 38, 13, 20, 24, 3, 4, 216, 282 },
-        team_record{ MTL, 78, 30, 42, 6, 20, 25, 5, 2, 219, 289 },
-        team_record{ SJS, 77, 22, 39, 16, 16, 21, 1, 6, 226, 295 },
-        team_record{ CHI, 77, 25, 46, 6, 17, 23, 2, 2, 190, 280 },
-        team_record{ CBJ, 77, 24, 45, 8, 15, 23, 1, 1, 205, 307 },
-        team_record{ ANA, 77, 23, 44, 10, 13, 20, 3, 3, 195, 317 }
+        team_record{ team_id::bos, 77, 60, 12, 5, 50, 56, 4, 3, 286, 166 },
+        team_record{ team_id::car, 77, 50, 18, 9, 37, 46, 4, 3, 251, 198 },
+        team_record{ team_id::njd, 78, 49, 21, 8, 37, 47, 2, 4, 271, 217 },
+        team_record{ team_id::vgk, 78, 48, 22, 8, 35, 43, 5, 3, 259, 223 },
+        team_record{ team_id::tor, 77, 46, 21, 10, 39, 45, 1, 2, 262, 213 },
+        team_record{ team_id::nyr, 77, 45, 21, 11, 35, 41, 4, 2, 261, 207 },
+        team_record{ team_id::edm, 78, 46, 23, 9, 42, 46, 0, 4, 309, 255 },
+        team_record{ team_id::lak, 78, 45, 23, 10, 35, 39, 6, 3, 267, 245 },
+        team_record{ team_id::col, 76, 46, 24, 6, 32, 40, 6, 3, 256, 210 },
+        team_record{ team_id::dal, 77, 42, 21, 14, 35, 39, 3, 3, 267, 213 },
+        team_record{ team_id::min, 77, 44, 23, 10, 32, 37, 7, 6, 232, 209 },
+        team_record{ team_id::tbl, 77, 45, 26, 6, 37, 42, 3, 2, 267, 231 },
+        team_record{ team_id::sea, 77, 43, 26, 8, 34, 43, 0, 4, 272, 243 },
+        team_record{ team_id::wpg, 77, 43, 31, 3, 33, 42, 1, 1, 233, 215 },
+        team_record{ team_id::fla, 78, 40, 31, 7, 34, 38, 2, 1, 274, 261 },
+        team_record{ team_id::nyi, 78, 39, 30, 9, 33, 38, 1, 5, 227, 214 },
+        team_record{ team_id::cgy, 78, 36, 27, 15, 29, 34, 2, 3, 250, 244 },
+        team_record{ team_id::nsh, 77, 39, 30, 8, 28, 34, 5, 2, 216, 227 },
+        team_record{ team_id::pit, 78, 38, 30, 10, 29, 37, 1, 1, 249, 254 },
+        team_record{ team_id::buf, 76, 37, 32, 7, 28, 36, 1, 3, 271, 278 },
+        team_record{ team_id::ott, 78, 37, 34, 7, 29, 35, 2, 1, 246, 254 },
+        team_record{ team_id::det, 77, 35, 33, 9, 28, 32, 3, 3, 231, 252 },
+        team_record{ team_id::stl, 78, 36, 35, 7, 27, 33, 3, 3, 255, 288 },
+        team_record{ team_id::wsh, 77, 34, 34, 9, 26, 32, 2, 4, 240, 243 },
+        team_record{ team_id::van, 77, 34, 36, 7, 22, 29, 5, 2, 262, 287 },
+        team_record{ team_id::phi, 77, 29, 35, 13, 26, 27, 2, 1, 209, 257 },
+        team_record{ team_id::ari, 78, 27, 38, 13, 20, 24, 3, 4, 216, 282 },
+        team_record{ team_id::mtl, 78, 30, 42, 6, 20, 25, 5, 2, 219, 289 },
+        team_record{ team_id::sjs, 77, 22, 39, 16, 16, 21, 1, 6, 226, 295 },
+        team_record{ team_id::chi, 77, 25, 46, 6, 17, 23, 2, 2, 190, 280 },
+        team_record{ team_id::cbj, 77, 24, 45, 8, 15, 23, 1, 1, 205, 307 },
+        team_record{ team_id::ana, 77, 23, 44, 10, 13, 20, 3, 3, 195, 317 }
     };
-};
+    static_assert(standings.size() == team_count);
 
-/*
-inline constexpr std::array standings
-{
-    team_record{ BOS, 77, 60, 12, 5, 50, 56, 4, 3, 286, 166 },
-    team_record{ CAR, 77, 50, 18, 9, 37, 46, 4, 3, 251, 198 },
-    team_record{ NJD, 78, 49, 21, 8, 37, 47, 2, 4, 271, 217 },
-    team_record{ VGK, 78, 48, 22, 8, 35, 43, 5, 3, 259, 223 },
-    team_record{ TOR, 77, 46, 21, 10, 39, 45, 1, 2, 262, 213 },
-    team_record{ NYR, 77, 45, 21, 11, 35, 41, 4, 2, 261, 207 },
-    team_record{ EDM, 78, 46, 23, 9, 42, 46, 0, 4, 309, 255 },
-    team_record{ LAK, 78, 45, 23, 10, 35, 39, 6, 3, 267, 245 },
-    team_record{ COL, 76, 46, 24, 6, 32, 40, 6, 3, 256, 210 },
-    team_record{ DAL, 77, 42, 21, 14, 35, 39, 3, 3, 267, 213 },
-    team_record{ MIN, 77, 44, 23, 10, 32, 37, 7, 6, 232, 209 },
-    team_record{ TBL, 77, 45, 26, 6, 37, 42, 3, 2, 267, 231 },
-    team_record{ SEA, 77, 43, 26, 8, 34, 43, 0, 4, 272, 243 },
-    team_record{ WPG, 77, 43, 31, 3, 33, 42, 1, 1, 233, 215 },
-    team_record{ FLA, 78, 40, 31, 7, 34, 38, 2, 1, 274, 261 },
-    team_record{ NYI, 78, 39, 30, 9, 33, 38, 1, 5, 227, 214 },
-    team_record{ CGY, 78, 36, 27, 15, 29, 34, 2, 3, 250, 244 },
-    team_record{ NSH, 77, 39, 30, 8, 28, 34, 5, 2, 216, 227 },
-    team_record{ PIT, 78, 38, 30, 10, 29, 37, 1, 1, 249, 254 },
-    team_record{ BUF, 76, 37, 32, 7, 28, 36, 1, 3, 271, 278 },
-    team_record{ OTT, 78, 37, 34, 7, 29, 35, 2, 1, 246, 254 },
-    team_record{ DET, 77, 35, 33, 9, 28, 32, 3, 3, 231, 252 },
-    team_record{ STL, 78, 36, 35, 7, 27, 33, 3, 3, 255, 288 },
-    team_record{ WSH, 77, 34, 34, 9, 26, 32, 2, 4, 240, 243 },
-    team_record{ VAN, 77, 34, 36, 7, 22, 29, 5, 2, 262, 287 },
-    team_record{ PHI, 77, 29, 35, 13, 26, 27, 2, 1, 209, 257 },
-    team_record{ ARI, 78, 27, 38, 13, 20, 24, 3, 4, 216, 282 },
-    team_record{ MTL, 78, 30, 42, 6, 20, 25, 5, 2, 219, 289 },
-    team_record{ SJS, 77, 22, 39, 16, 16, 21, 1, 6, 226, 295 },
-    team_record{ CHI, 77, 25, 46, 6, 17, 23, 2, 2, 190, 280 },
-    team_record{ CBJ, 77, 24, 45, 8, 15, 23, 1, 1, 205, 307 },
-    team_record{ ANA, 77, 23, 44, 10, 13, 20, 3, 3, 195, 317 }
-};
-*/
+    // One record per team, where the index of each record is its team_id
+    using team_records = std::array<team_record, team_count>;
+
+    constexpr team_records index_by_team(std::span<team_record const> records)
+    {
+        team_records ret{};
+
+        for (std::size_t i = 0; i < ret.size(); ++i)
+        {
+            ret[i].id = static_cast<team_id>(i);
+        }
+
+        for (auto const& r : records)
+        {
+            if (!team_id_values::ok(r.id))
+            {
+                throw std::out_of_range("Invalid team id");
+            }
+
+            ret[static_cast<std::size_t>(r.id)] = r;
+        }
+
+        return ret;
+    }
+
+    // Tie-breaking procedure (in order):
+    // 1. points
+    // 2. points percentage (i.e. fewer games played on equal points)
+    // 3. regulation wins
+    // 4. regulation + overtime wins
+    // 5. total wins
+    // 6. goal differential
+    // 7. goals for
+    //
+    // Head-to-head points aren't tracked by team_record, so that step is
+    // skipped. The team id is used as a final (arbitrary but stable) step so
+    // the ordering is strict.
+    constexpr bool ranks_ahead(team_record const& lhs, team_record const& rhs)
+        noexcept
+    {
+        if (const auto l = points(lhs), r = points(rhs); l != r)
+        {
+            return l > r;
+        }
+
+        // lhs.points / lhs.gp > rhs.points / rhs.gp, with equal points
+        if (lhs.games_played != rhs.games_played)
+        {
+            return lhs.games_played < rhs.games_played;
+        }
+
+        if (lhs.regulation_wins != rhs.regulation_wins)
+        {
+            return lhs.regulation_wins > rhs.regulation_wins;
+        }
+
+        if (lhs.regulation_or_overtime_wins != rhs.regulation_or_overtime_wins)
+        {
+            return lhs.regulation_or_overtime_wins >
+                rhs.regulation_or_overtime_wins;
+        }
+
+        if (lhs.wins != rhs.wins)
+        {
+            return lhs.wins > rhs.wins;
+        }
+
+        if (const auto l = goal_differential(lhs), r = goal_differential(rhs);
+            l != r)
+        {
+            return l > r;
+        }
+
+        if (lhs.goals_for != rhs.goals_for)
+        {
+            return lhs.goals_for > rhs.goals_for;
+        }
+
+        return lhs.id < rhs.id;
+    }
+
+    inline constexpr std::size_t playoff_team_count{ 16 };
+    inline constexpr std::size_t division_playoff_spots{ 3 };
+    inline constexpr std::size_t wild_card_spots{ 2 };
+
+    // Returns the teams that missed the playoffs, ordered from the worst record
+    // to the best (i.e. in draft lottery ranking order)
+    //
+    // Per conference, the top 3 teams in each division qualify, plus the next
+    // 2 best teams in the conference (the wild cards)
+    constexpr std::array<team_id, team_count - playoff_team_count>
+        non_playoff_teams(team_records const& records)
+    {
+        const auto ahead = [&records](team_id lhs, team_id rhs)
+        {
+            return ranks_ahead(records[static_cast<std::size_t>(lhs)],
+                records[static_cast<std::size_t>(rhs)]);
+        };
+
+        std::array<team_id, team_count - playoff_team_count> ret{};
+        std::size_t ret_index{ 0 };
+
+        for (auto const& c : conferences::all)
+        {
+            // division winners/runners-up are removed, the rest compete for
+            // the wild cards
+            std::array<team_id, 16> wild_card_race{};
+            std::size_t race_size{ 0 };
+
+            for (auto const& d : c.divisions)
+            {
+                auto teams = lookup(d).teams;
+                std::ranges::sort(teams, ahead);
+
+                for (std::size_t i = division_playoff_spots; i < teams.size();
+                    ++i)
+                {
+                    wild_card_race[race_size++] = teams[i];
+                }
+            }
+
+            std::ranges::sort(wild_card_race.begin(),
+                wild_card_race.begin() + race_size, ahead);
+
+            for (std::size_t i = wild_card_spots; i < race_size; ++i)
+            {
+                ret[ret_index++] = wild_card_race[i];
+            }
+        }
+
+        // worst record first
+        std::ranges::sort(ret, [&ahead](team_id lhs, team_id rhs)
+            {
+                return ahead(rhs, lhs);
+            });
+
+        return ret;
+    }
+}
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
 #include "nhl/text_literals.h"
 
 namespace nhl
@@ -66,6 +71,119 @@ namespace nhl
             nhl::text_literals::unknown;
     }
 
+    namespace detail
+    {
+        // A perfect hash over the 3 letter abbreviations: the letters are
+        // packed into an integer, multiplied and the top bits taken as the
+        // slot. The multiplier is searched for at compile time so that no 2
+        // abbreviations share a slot.
+        inline constexpr std::size_t abbreviation_hash_bits{ 6 };
+        inline constexpr std::size_t abbreviation_slot_count{
+            std::size_t{ 1 } << abbreviation_hash_bits };
+        static_assert(abbreviation_slot_count >=
+            text_literals::team_ids.size());
+
+        constexpr std::uint32_t pack_abbreviation(char const* p) noexcept
+        {
+            return (static_cast<std::uint32_t>(static_cast<unsigned char>(
+                p[0])) << 16) |
+                (static_cast<std::uint32_t>(static_cast<unsigned char>(
+                p[1])) << 8) |
+                static_cast<std::uint32_t>(static_cast<unsigned char>(p[2]));
+        }
+
+        constexpr std::size_t abbreviation_slot(std::uint32_t key,
+            std::uint32_t multiplier) noexcept
+        {
+            return static_cast<std::size_t>((key * multiplier) >>
+                (32 - abbreviation_hash_bits));
+        }
+
+        inline constexpr std::uint32_t abbreviation_multiplier = []()
+        {
+            // multiples of 2^32 / phi (made odd) mix the keys' bits well, so
+            // only a few hundred candidates are tried
+            for (std::uint32_t k = 1; k != 0; ++k)
+            {
+                const std::uint32_t m{ (k * 0x9e3779b9u) | 1u };
+
+                std::array<bool, abbreviation_slot_count> used{};
+                bool ok{ true };
+
+                for (auto const& id : text_literals::team_ids)
+                {
+                    auto& slot = used[abbreviation_slot(
+                        pack_abbreviation(id.data()), m)];
+                    if (slot)
+                    {
+                        ok = false;
+                        break;
+                    }
+                    slot = true;
+                }
+
+                if (ok)
+                {
+                    return m;
+                }
+            }
+
+            throw "No perfect hash multiplier";
+        }();
+
+        struct abbreviation_slot_entry
+        {
+            // empty slots keep a key that no 3 letters pack to
+            std::uint32_t key{ ~std::uint32_t{ 0 } };
+            std::uint8_t id{ 0 };
+        };
+
+        inline constexpr auto abbreviation_table = []()
+        {
+            std::array<abbreviation_slot_entry, abbreviation_slot_count>
+                ret{};
+            for (std::size_t i = 0; i < text_literals::team_ids.size(); ++i)
+            {
+                const auto key = pack_abbreviation(
+                    text_literals::team_ids[i].data());
+                ret[abbreviation_slot(key, abbreviation_multiplier)] =
+                    { key, static_cast<std::uint8_t>(i) };
+            }
+            return ret;
+        }();
+    }
+
+    // Converts an abbreviation (i.e. "TOR") to its team id. A hash and a
+    // single integer compare, instead of a string compare per team.
+    constexpr std::optional<team_id> to_team_id(std::string_view abbreviation)
+        noexcept
+    {
+        if (abbreviation.size() != 3)
+        {
+            return std::nullopt;
+        }
+
+        const auto key = detail::pack_abbreviation(abbreviation.data());
+        auto const& entry = detail::abbreviation_table[
+            detail::abbreviation_slot(key, detail::abbreviation_multiplier)];
+
+        return (entry.key == key) ?
+            std::optional{ static_cast<team_id>(entry.id) } : std::nullopt;
+    }
+
+    static_assert([]()
+        {
+            for (std::size_t i = 0; i < text_literals::team_ids.size(); ++i)
+            {
+                if (to_team_id(text_literals::team_ids[i]) !=
+                    static_cast<team_id>(i))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }());
+
     inline std::ostream& operator<<(std::ostream& os, team_id id)
     {
         os << to_string(id);
@@ -119,37 +237,28 @@ namespace nhl
     static_assert(std::ranges::is_sorted(teams, {}, &team::id));
 #endif
 
-    constexpr team lookup(team_id id)
-    {
-        struct teams_sort_by_team_id
+    // teams is indexed by team id
+    static_assert(teams.size() == text_literals::team_ids.size());
+    static_assert([]()
         {
-            bool operator()(const team& lhs, const team& rhs) const
-            {
-                return lhs.id < rhs.id;
-            }
-            bool operator()(const team& lhs, const team_id& rhs) const
+            for (std::size_t i = 0; i < teams.size(); ++i)
             {
-                return lhs.id < rhs;
+                if (teams[i].id != static_cast<team_id>(i))
+                {
+                    return false;
+                }
             }
-            bool operator()(const team_id& lhs, const team& rhs) const
-            {
-                return lhs < rhs.id;
-            }
-        };
+            return true;
+        }());
 
-        if (auto pos = std::lower_bound(teams.begin(), teams.end(), id,
-            teams_sort_by_team_id{}); pos != teams.end() && pos->id == id)
+    constexpr team const& lookup(team_id id)
+    {
+        if (!team_id_values::ok(id))
         {
-            return *pos;
+            throw std::out_of_range("Invalid team id");
         }
 
-        // if (auto pos = std::ranges::lower_bound(teams, id, {}, &team::id);
-        //     pos != std::ranges::end(teams) && pos->id == id)
-        // {
-        //     return *pos;
-        // }
-
-        throw std::out_of_range("Invalid team id");
+        return teams[static_cast<std::size_t>(id)];
     }
 
 }
@@ -20,6 +20,16 @@ namespace nhl
         int goals_against{ 0 };
     };
 
+    constexpr int points(team_record const& r) noexcept
+    {
+        return (r.wins * 2) + r.overtime_losses;
+    }
+
+    constexpr int goal_differential(team_record const& r) noexcept
+    {
+        return r.goals_for - r.goals_against;
+    }
+
     inline std::ostream& operator<<(std::ostream& os, team_record const& r)
     {
         auto s = fmt::format(
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace nhl
+{
+    class thread_pool
+    {
+    public:
+        explicit thread_pool(std::size_t threads = default_thread_count())
+        {
+            threads = std::max(std::size_t{ 1 }, threads);
+            workers_.reserve(threads);
+
+            for (std::size_t i = 0; i < threads; ++i)
+            {
+                workers_.emplace_back([this](std::stop_token stop)
+                {
+                    run(stop);
+                });
+            }
+        }
+
+        thread_pool(thread_pool const&) = delete;
+        thread_pool& operator=(thread_pool const&) = delete;
+
+        ~thread_pool()
+        {
+            for (auto& worker : workers_)
+            {
+                worker.request_stop();
+            }
+
+            tasks_available_.notify_all();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return workers_.size();
+        }
+
+        template <typename F>
+        auto submit(F&& f) -> std::future<std::invoke_result_t<F>>
+        {
+            using result_type = std::invoke_result_t<F>;
+
+            auto task = std::make_shared<std::packaged_task<result_type()>>(
+                std::forward<F>(f));
+            auto ret = task->get_future();
+
+            {
+                std::scoped_lock lock{ mutex_ };
+                tasks_.emplace([task]() { (*task)(); });
+            }
+
+            tasks_available_.notify_one();
+            return ret;
+        }
+
+        static std::size_t default_thread_count() noexcept
+        {
+            return std::max(1u, std::thread::hardware_concurrency());
+        }
+
+    private:
+        void run(std::stop_token stop)
+        {
+            while (true)
+            {
+                std::function<void()> task;
+
+                {
+                    std::unique_lock lock{ mutex_ };
+                    if (!tasks_available_.wait(lock, stop,
+                        [this]() { return !tasks_.empty(); }))
+                    {
+                        return;
+                    }
+
+                    task = std::move(tasks_.front());
+                    tasks_.pop();
+                }
+
+                task();
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable_any tasks_available_;
+        std::queue<std::function<void()>> tasks_;
+
+        // declared last so the workers are joined before the queue is
+        // destroyed
+        std::vector<std::jthread> workers_;
+    };
+}
@@ -0,0 +1,433 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include "nhl/game.h"
+#include "nhl/league.h"
+#include "nhl/lru_cache.h"
+#include "nhl/packed_outcomes.h"
+#include "nhl/parallel.h"
+#include "nhl/random.h"
+#include "nhl/season.h"
+#include "nhl/standings.h"
+#include "nhl/thread_pool.h"
+
+namespace nhl
+{
+    inline constexpr std::size_t non_playoff_team_count{
+        team_count - playoff_team_count };
+
+    // The odds to use for one of the remaining games in place of the model's
+    // odds. A fixed result is a condition where every other outcome has a
+    // probability of 0.
+    struct game_condition
+    {
+        std::size_t game_index;
+        outcome_probabilities probabilities;
+
+        auto operator<=>(game_condition const&) const = default;
+    };
+
+    // Fixes a game to the given outcomes, keeping their relative odds
+    inline game_condition fix_outcomes(season_model const& model,
+        std::size_t game_index, std::span<game_outcome const> outcomes)
+    {
+        const auto odds = model.probabilities(game_index);
+
+        game_condition ret{ game_index, {} };
+        for (auto const& outcome : outcomes)
+        {
+            if (!game_outcome_values::ok(outcome))
+            {
+                throw std::out_of_range("Invalid game outcome");
+            }
+
+            const auto i = static_cast<std::size_t>(outcome);
+            ret.probabilities[i] = odds[i];
+        }
+
+        return ret;
+    }
+
+    namespace detail
+    {
+        // FNV-1a over the conditions' games and odds
+        inline std::uint64_t hash_conditions(
+            std::span<game_condition const> conditions,
+            std::uint64_t basis = 0)
+        {
+            std::uint64_t ret{ 14695981039346656037ull ^ basis };
+
+            const auto hash = [&ret](auto const& value)
+            {
+                std::array<unsigned char, sizeof(value)> bytes;
+                std::memcpy(bytes.data(), &value, sizeof(value));
+
+                for (auto b : bytes)
+                {
+                    ret = (ret ^ b) * 1099511628211ull;
+                }
+            };
+
+            for (auto const& c : conditions)
+            {
+                hash(c.game_index);
+                for (auto const& p : c.probabilities)
+                {
+                    hash(p);
+                }
+            }
+
+            return ret;
+        }
+
+        struct conditions_hash
+        {
+            std::size_t operator()(
+                std::vector<game_condition> const& conditions) const
+            {
+                return static_cast<std::size_t>(hash_conditions(conditions));
+            }
+        };
+    }
+
+    // Fixes the winner of a game, regardless of how the game is won
+    inline game_condition fix_winner(season_model const& model,
+        std::size_t game_index, team_id winner)
+    {
+        if (game_index >= model.games().size())
+        {
+            throw std::out_of_range("Invalid game index");
+        }
+
+        auto const& g = model.games()[game_index];
+
+        if (winner == g.home)
+        {
+            constexpr std::array outcomes{ game_outcome::home_regulation,
+                game_outcome::home_overtime, game_outcome::home_shootout };
+            return fix_outcomes(model, game_index, outcomes);
+        }
+        else if (winner == g.visitor)
+        {
+            constexpr std::array outcomes{ game_outcome::visitor_regulation,
+                game_outcome::visitor_overtime,
+                game_outcome::visitor_shootout };
+            return fix_outcomes(model, game_index, outcomes);
+        }
+
+        throw std::invalid_argument("The team doesn't play in the game");
+    }
+
+    struct season_query_result
+    {
+        // number of samples the query was answered from, and how many
+        // unweighted samples they are worth
+        std::size_t samples{ 0 };
+        double effective_samples{ 0.0 };
+
+        // true if the samples were simulated with the conditions applied
+        // because too few of the cached samples matched
+        bool resampled{ false };
+
+        std::array<double, team_count> playoff_odds{};
+
+        // [team id][ranking - 1]
+        std::array<std::array<double, non_playoff_team_count>, team_count>
+            lottery_ranking_odds{};
+    };
+
+    // The outcome of every remaining game plus the resulting non-playoff
+    // teams, for each simulated season. Outcomes are bit-packed (3 bits per
+    // game), so a season of 75 games takes 32 bytes.
+    class season_samples
+    {
+    public:
+        using lottery_order_type = std::array<std::uint8_t,
+            non_playoff_team_count>;
+
+        explicit season_samples(season_model model) :
+            model_{ std::move(model) },
+            outcomes_{ model_.games().size() }
+        {
+        }
+
+        season_model const& model() const noexcept
+        {
+            return model_;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return lottery_orders_.size();
+        }
+
+        game_outcome outcome(std::size_t sample, std::size_t game_index) const
+        {
+            return outcomes_.outcome(sample, game_index);
+        }
+
+        packed_outcomes outcomes(std::size_t sample) const
+        {
+            return outcomes_[sample];
+        }
+
+        packed_outcome_store const& outcome_store() const noexcept
+        {
+            return outcomes_;
+        }
+
+        lottery_order_type const& lottery_order(std::size_t sample) const
+        {
+            return lottery_orders_[sample];
+        }
+
+        // Simulates more seasons and adds them to the samples. Each call
+        // continues the random streams where the previous call stopped.
+        void generate(std::size_t simulations, std::uint64_t seed,
+            thread_pool& pool)
+        {
+            const auto offset = size();
+            const auto first_block = next_block_;
+
+            outcomes_.resize(offset + simulations);
+            lottery_orders_.resize(offset + simulations);
+
+            const auto make_state = []() { return 0; };
+
+            const auto run_block = [&](int&, std::size_t block)
+            {
+                auto gen = make_random_engine(seed, block);
+                const auto range = block_at(simulations, block - first_block);
+
+                for (auto s = offset + range.first; s < offset + range.last;
+                    ++s)
+                {
+                    const auto records = model_.simulate(gen,
+                        [&](std::size_t game_index, game_outcome outcome)
+                        {
+                            outcomes_.set(s, game_index, outcome);
+                        });
+
+                    const auto teams = non_playoff_teams(records);
+                    for (std::size_t i = 0; i < teams.size(); ++i)
+                    {
+                        lottery_orders_[s][i] =
+                            static_cast<std::uint8_t>(teams[i]);
+                    }
+                }
+            };
+
+            next_block_ += block_count(simulations);
+            run_blocks(pool, first_block, next_block_, make_state, run_block);
+        }
+
+        // Answers the query from the samples, where each sample is weighted
+        // by how much more (or less) likely it is under the conditions than
+        // under the model it was simulated with. For fixed results this is
+        // the same as filtering out the samples that don't match.
+        season_query_result query(
+            std::span<game_condition const> conditions) const
+        {
+            // [condition][outcome] -> likelihood ratio
+            std::vector<outcome_probabilities> ratios;
+            ratios.reserve(conditions.size());
+
+            for (auto const& c : conditions)
+            {
+                const auto odds = model_.probabilities(c.game_index);
+
+                double sum{ 0.0 };
+                for (auto const& p : c.probabilities)
+                {
+                    sum += p;
+                }
+
+                if (sum <= 0.0)
+                {
+                    throw std::invalid_argument(
+                        "At least one outcome must be possible");
+                }
+
+                outcome_probabilities ratio{};
+                for (std::size_t i = 0; i < ratio.size(); ++i)
+                {
+                    ratio[i] = (odds[i] > 0.0) ?
+                        (c.probabilities[i] / sum) / odds[i] : 0.0;
+                }
+
+                ratios.push_back(ratio);
+            }
+
+            std::vector<double> weights(size(), 1.0);
+
+            for (std::size_t c = 0; c < conditions.size(); ++c)
+            {
+                const auto game_index = conditions[c].game_index;
+                if (game_index >= outcomes_.games())
+                {
+                    throw std::out_of_range("Invalid game index");
+                }
+
+                auto const& ratio = ratios[c];
+
+                for (std::size_t s = 0; s < weights.size(); ++s)
+                {
+                    weights[s] *= ratio[static_cast<std::size_t>(
+                        outcomes_.outcome(s, game_index))];
+                }
+            }
+
+            season_query_result ret;
+
+            double weight_sum{ 0.0 };
+            double weight_sum_squared{ 0.0 };
+
+            for (std::size_t s = 0; s < weights.size(); ++s)
+            {
+                const auto w = weights[s];
+                if (w == 0.0)
+                {
+                    continue;
+                }
+
+                ++ret.samples;
+                weight_sum += w;
+                weight_sum_squared += w * w;
+
+                auto const& order = lottery_orders_[s];
+                for (std::size_t r = 0; r < order.size(); ++r)
+                {
+                    ret.lottery_ranking_odds[order[r]][r] += w;
+                }
+            }
+
+            if (weight_sum == 0.0)
+            {
+                return ret;
+            }
+
+            ret.effective_samples = (weight_sum * weight_sum) /
+                weight_sum_squared;
+
+            for (std::size_t t = 0; t < team_count; ++t)
+            {
+                double missed{ 0.0 };
+                for (auto& odds : ret.lottery_ranking_odds[t])
+                {
+                    odds /= weight_sum;
+                    missed += odds;
+                }
+
+                ret.playoff_odds[t] = std::max(0.0, 1.0 - missed);
+            }
+
+            return ret;
+        }
+
+    private:
+        season_model model_;
+
+        // [sample] -> outcome of each game
+        packed_outcome_store outcomes_;
+
+        // [sample] -> non-playoff team ids, worst record first
+        std::vector<lottery_order_type> lottery_orders_;
+
+        std::size_t next_block_{ 0 };
+    };
+
+    struct what_if_options
+    {
+        // the minimum number of effective samples for a query to be answered
+        // from the cached samples
+        double min_effective_samples{ 1000.0 };
+
+        // the number of seasons to simulate when a query has to resample
+        std::size_t resample_simulations{ 20000 };
+
+        // the number of resampled condition sets kept; the least recently
+        // queried one is dropped to make room
+        std::size_t resampled_queries{ 8 };
+    };
+
+    // Answers what-if queries from a cache of simulated seasons. When too few
+    // cached samples match a query, the seasons are simulated again with the
+    // conditions applied, and those samples are kept for the next time the
+    // same conditions are queried (up to options.resampled_queries sets).
+    class what_if_engine
+    {
+    public:
+        what_if_engine(season_model model, std::size_t simulations,
+            std::uint64_t seed, thread_pool& pool,
+            what_if_options const& options = {}) :
+            samples_{ std::move(model) },
+            seed_{ seed },
+            pool_{ pool },
+            options_{ options },
+            conditional_samples_{ options.resampled_queries }
+        {
+            samples_.generate(simulations, seed_, pool_);
+        }
+
+        season_samples const& samples() const noexcept
+        {
+            return samples_;
+        }
+
+        // the number of resampled condition sets kept
+        std::size_t resampled_count() const noexcept
+        {
+            return conditional_samples_.size();
+        }
+
+        season_query_result query(std::vector<game_condition> conditions)
+        {
+            std::ranges::sort(conditions);
+
+            if (auto ret = samples_.query(conditions);
+                ret.effective_samples >= options_.min_effective_samples)
+            {
+                return ret;
+            }
+
+            auto resampled = conditional_samples_.find(conditions);
+
+            if (resampled == nullptr)
+            {
+                auto model = samples_.model();
+                for (auto const& c : conditions)
+                {
+                    model.set_probabilities(c.game_index, c.probabilities);
+                }
+
+                season_samples samples{ std::move(model) };
+                samples.generate(options_.resample_simulations,
+                    detail::hash_conditions(conditions, seed_), pool_);
+
+                conditional_samples_.insert(conditions, std::move(samples));
+                resampled = conditional_samples_.find(conditions);
+            }
+
+            auto ret = resampled->query({});
+            ret.resampled = true;
+            return ret;
+        }
+
+    private:
+        // the conditions are hashed with seed_ for their samples' seed, so
+        // the same conditions always get the same random streams
+        season_samples samples_;
+        std::uint64_t seed_;
+        thread_pool& pool_;
+        what_if_options options_;
+
+        lru_cache<std::vector<game_condition>, season_samples,
+            detail::conditions_hash> conditional_samples_;
+    };
+}
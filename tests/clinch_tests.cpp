@@ -0,0 +1,97 @@
+#include <doctest/doctest.h>
+#include <vector>
+#include "nhl/clinch.h"
+#include "nhl/schedule.h"
+
+TEST_CASE("clinch_calculator")
+{
+    using namespace nhl;
+    using enum nhl::team_id;
+
+    const auto records = index_by_team(standings);
+
+    SUBCASE("snapshot")
+    {
+        clinch_calculator calc{ records, remaining_games };
+
+        REQUIRE(calc.result(bos).status == playoff_status::clinched);
+        REQUIRE(calc.result(bos).magic_number == 0);
+
+        REQUIRE(calc.result(ana).status == playoff_status::eliminated);
+        REQUIRE(!calc.result(ana).magic_number.has_value());
+
+        REQUIRE(calc.result(sea).status == playoff_status::undecided);
+        REQUIRE(calc.result(sea).magic_number == 3);
+    }
+
+    SUBCASE("magic number")
+    {
+        clinch_calculator calc{ records, remaining_games };
+
+        // earning the magic number clinches, whatever else happens
+        for (std::size_t i = 0; i < calc.games().size(); ++i)
+        {
+            auto const& g = calc.games()[i];
+            if (g.home == sea)
+            {
+                calc.add_result(i, game_outcome::home_regulation);
+            }
+            else if (g.visitor == sea)
+            {
+                calc.add_result(i, game_outcome::visitor_regulation);
+            }
+
+            if (points(calc.records()[static_cast<std::size_t>(sea)]) >=
+                points(records[static_cast<std::size_t>(sea)]) + 3)
+            {
+                break;
+            }
+        }
+
+        REQUIRE(calc.result(sea).status == playoff_status::clinched);
+    }
+
+    SUBCASE("incremental")
+    {
+        clinch_calculator calc{ records, remaining_games };
+
+        std::vector<std::size_t> order(calc.games().size());
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+            order[i] = (i * 37) % order.size();
+        }
+
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+            calc.add_result(order[i], static_cast<game_outcome>(i % 6));
+
+            std::vector<game> left;
+            for (std::size_t g = 0; g < calc.games().size(); ++g)
+            {
+                if (!calc.played(g))
+                {
+                    left.push_back(calc.games()[g]);
+                }
+            }
+
+            // the same as computing from scratch
+            const clinch_calculator fresh{ calc.records(), left };
+            for (std::size_t t = 0; t < team_count; ++t)
+            {
+                CAPTURE(t);
+                REQUIRE(calc.results()[t].status == fresh.results()[t].status);
+                REQUIRE(calc.results()[t].magic_number ==
+                    fresh.results()[t].magic_number);
+            }
+        }
+
+        // with no games left, every team is decided
+        for (auto const& r : calc.results())
+        {
+            REQUIRE(r.status != playoff_status::undecided);
+        }
+
+        REQUIRE_THROWS_AS(calc.add_result(0, game_outcome::home_regulation),
+            std::invalid_argument);
+    }
+}
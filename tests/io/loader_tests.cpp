@@ -0,0 +1,110 @@
+#include <doctest/doctest.h>
+#include <filesystem>
+#include <fstream>
+#include "nhl/io/loader.h"
+#include "nhl/season.h"
+
+TEST_CASE("parse_standings")
+{
+    using namespace nhl;
+    using enum nhl::team_id;
+
+    SUBCASE("csv")
+    {
+        constexpr std::string_view text =
+            "# standings\r\n"
+            "team,gp,w,l,otl,rw,row,sow,sol,gf,ga\r\n"
+            "BOS,77,60,12,5,46,55,5,1,284,161\r\n"
+            "\r\n"
+            "\"TOR\", 77, 46, 20, 11, 34, 43, 3, 4, 259, 209\r\n";
+
+        const auto records = io::parse_standings(text);
+
+        REQUIRE(records.size() == 2);
+        REQUIRE(records[0].id == bos);
+        REQUIRE(records[0].wins == 60);
+        REQUIRE(records[0].goals_against == 161);
+        REQUIRE(records[1].id == tor);
+        REQUIRE(points(records[1]) == 103);
+    }
+
+    SUBCASE("json")
+    {
+        constexpr std::string_view text = R"([
+            { "team": "BOS", "gp": 77, "w": 60, "l": 12, "otl": 5 },
+            { "team": "TOR", "gp": 77, "w": 46, "l": 20, "otl": null }
+        ])";
+
+        const auto records = io::parse_standings(text);
+
+        REQUIRE(records.size() == 2);
+        REQUIRE(points(records[0]) == 125);
+        REQUIRE(records[1].overtime_losses == 0);
+    }
+
+    SUBCASE("errors")
+    {
+        REQUIRE_THROWS_AS(io::parse_standings("team,gp\nXYZ,1\n"),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(io::parse_standings("team,gp\nBOS,1x\n"),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(io::parse_standings("team\nBOS\nBOS\n"),
+            std::invalid_argument);
+        REQUIRE_THROWS_AS(io::parse_standings(R"([{ "team": "BOS" })"),
+            std::invalid_argument);
+    }
+}
+
+TEST_CASE("parse_games")
+{
+    using namespace nhl;
+    using enum nhl::team_id;
+
+    constexpr std::string_view text =
+        "date,visitor,home,visitor_goals,home_goals,decision\n"
+        "2023-04-01,BOS,TOR,3,2,OT\n"
+        "2023-04-02,TOR,BOS,1,4,\n"
+        "2023-04-03,MTL,BOS,4,3,SO\n"
+        "2023-04-05,BOS,MTL,,,\n";
+
+    const auto log = io::parse_games(text);
+
+    REQUIRE(log.results.size() == 3);
+    REQUIRE(log.results[0].outcome == game_outcome::visitor_overtime);
+    REQUIRE(log.results[1].outcome == game_outcome::home_regulation);
+    REQUIRE(log.results[2].outcome == game_outcome::visitor_shootout);
+
+    REQUIRE(log.remaining.size() == 1);
+    REQUIRE(log.remaining[0].visitor == bos);
+    REQUIRE(log.remaining[0].home == mtl);
+
+    const auto records = standings_after(log.results);
+    auto const& b = records[static_cast<std::size_t>(bos)];
+
+    REQUIRE(b.games_played == 3);
+    REQUIRE(points(b) == 5);
+    REQUIRE(b.goals_for == 10);
+    REQUIRE(b.goals_against == 7);
+
+    REQUIRE_THROWS_AS(io::parse_games("visitor,home,visitor_goals,home_goals\n"
+        "BOS,TOR,2,2\n"), std::invalid_argument);
+}
+
+TEST_CASE("load_games")
+{
+    const auto path = std::filesystem::temp_directory_path() /
+        "nhl_loader_tests.csv";
+
+    {
+        std::ofstream out{ path };
+        out << "visitor,home,visitor_goals,home_goals\nBOS,TOR,3,2\n";
+    }
+
+    const auto log = nhl::io::load_games(path);
+    std::filesystem::remove(path);
+
+    REQUIRE(log.results.size() == 1);
+    REQUIRE(log.remaining.empty());
+
+    REQUIRE_THROWS_AS(nhl::io::load_games(path), std::system_error);
+}
@@ -0,0 +1,154 @@
+#include <doctest/doctest.h>
+#include <stdexcept>
+#include <string_view>
+#include "nhl/lottery/backtest.h"
+
+namespace
+{
+    // 2023: CHI (3rd) won the first draw and ANA (1st) the second.
+    // 2019: NJD (3rd), NYR (6th) and CHI (12th) won the 3 draws.
+    constexpr std::string_view history{
+        "year,rounds,max_jump,ranking,team,combinations,pick\n"
+        "2023,2,10,1,ANA,185,2\n"
+        "2023,,,2,CBJ,135,3\n"
+        "2023,,,3,CHI,115,1\n"
+        "2023,,,4,SJS,95,4\n"
+        "2023,,,5,MTL,85,5\n"
+        "2023,,,6,ARI,75,6\n"
+        "2023,,,7,PHI,65,7\n"
+        "2023,,,8,WSH,60,8\n"
+        "2023,,,9,DET,50,9\n"
+        "2023,,,10,STL,35,10\n"
+        "2023,,,11,VAN,30,11\n"
+        "2023,,,12,OTT,25,12\n"
+        "2023,,,13,BUF,20,13\n"
+        "2023,,,14,PIT,15,14\n"
+        "2023,,,15,NSH,5,15\n"
+        "2023,,,16,CGY,5,16\n"
+        "# no jump limit in 2019\n"
+        "2019,3,,1,OTT,185,4\n"
+        "2019,,,2,LAK,135,5\n"
+        "2019,,,3,NJD,115,1\n"
+        "2019,,,4,DET,95,6\n"
+        "2019,,,5,BUF,85,7\n"
+        "2019,,,6,NYR,75,2\n"
+        "2019,,,7,EDM,65,8\n"
+        "2019,,,8,ANA,60,9\n"
+        "2019,,,9,VAN,50,10\n"
+        "2019,,,10,PHI,35,11\n"
+        "2019,,,11,MIN,30,12\n"
+        "2019,,,12,CHI,25,3\n"
+        "2019,,,13,FLA,20,13\n"
+        "2019,,,14,ARI,15,14\n"
+        "2019,,,15,MTL,10,15\n"
+    };
+}
+
+TEST_CASE("parse_lottery_history")
+{
+    using namespace nhl::lottery;
+
+    const auto years = parse_lottery_history(history);
+
+    REQUIRE(years.size() == 2);
+
+    REQUIRE(years[0].year == 2019);
+    REQUIRE(years[0].format.rounds == 3);
+    REQUIRE(years[0].format.max_ranking_jump == 15);
+    REQUIRE(years[0].format.combinations_per_ranking ==
+        format_of<rules_2019>().combinations_per_ranking);
+    REQUIRE(years[0].teams[11] == nhl::team_id::chi);
+    REQUIRE(years[0].draft_order[2] == 12);
+
+    REQUIRE(years[1].year == 2023);
+    REQUIRE(years[1].format.rounds == 2);
+    REQUIRE(years[1].format.max_ranking_jump == 10);
+    REQUIRE(years[1].draft_order[0] == 3);
+    REQUIRE(years[1].draft_order[1] == 1);
+
+    SUBCASE("invalid history")
+    {
+        // the same pick twice
+        REQUIRE_THROWS_AS(parse_lottery_history(
+            "year,rounds,ranking,team,combinations,pick\n"
+            "2023,1,1,ANA,500,1\n"
+            "2023,1,2,CBJ,400,1\n"), std::invalid_argument);
+
+        // conflicting rounds
+        REQUIRE_THROWS_AS(parse_lottery_history(
+            "year,rounds,ranking,team,combinations,pick\n"
+            "2023,1,1,ANA,500,1\n"
+            "2023,2,2,CBJ,400,2\n"), std::invalid_argument);
+
+        // no combinations left for redraws
+        REQUIRE_THROWS_AS(parse_lottery_history(
+            "year,rounds,ranking,team,combinations,pick\n"
+            "2023,1,1,ANA,501,1\n"
+            "2023,1,2,CBJ,500,2\n"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("run_backtest")
+{
+    using namespace nhl::lottery;
+
+    const auto years = parse_lottery_history(history);
+
+    constexpr std::size_t draws{ 100'000 };
+
+    nhl::thread_pool pool{ 2 };
+    const auto results = run_backtest(years, draws, 2023, pool);
+
+    REQUIRE(results.size() == years.size());
+
+    for (auto const& r : results)
+    {
+        CAPTURE(r.year);
+        REQUIRE(r.draws == draws);
+
+        // every pick is handed out once per draw
+        for (std::size_t pick = 1; pick <= r.team_count; ++pick)
+        {
+            double total{ 0.0 };
+            for (std::size_t ranking = 1; ranking <= r.team_count; ++ranking)
+            {
+                total += r.pick_probability(static_cast<int>(ranking),
+                    static_cast<int>(pick));
+            }
+            REQUIRE(total == doctest::Approx(1.0));
+        }
+    }
+
+    SUBCASE("matches the exact odds")
+    {
+        auto const& r = results[1];
+
+        // ANA keeps the first pick when it wins the first draw, or when a
+        // team ranked 12th or lower does (1 of the 1001 combinations is
+        // redrawn)
+        REQUIRE(r.pick_probability(1, 1) ==
+            doctest::Approx((185.0 + 70.0) / 1000.0).epsilon(0.03));
+
+        // CHI wins the first draw, then ANA wins the second
+        const auto exact = (115.0 / 1000.0) * (185.0 / (1000.0 - 115.0));
+        REQUIRE(r.actual_probability() ==
+            doctest::Approx(exact).epsilon(0.1));
+
+        // the 16th team can't move up more than 10 spots
+        REQUIRE(r.pick_probability(16, 1) == 0.0);
+        REQUIRE(r.pick_probability(16, 6) > 0.0);
+    }
+
+    SUBCASE("the results don't depend on the number of threads")
+    {
+        nhl::thread_pool single{ 1 };
+        const auto other = run_backtest(years, draws, 2023, single);
+
+        for (std::size_t y = 0; y < results.size(); ++y)
+        {
+            REQUIRE(other[y].picks == results[y].picks);
+            REQUIRE(other[y].actual_draft_orders ==
+                results[y].actual_draft_orders);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <cmath>
+#include <random>
+#include "nhl/lottery/batch.h"
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/exact_odds.h"
+#include "nhl/lottery/scenario.h"
+
+TEST_CASE("sample_draw")
+{
+    using namespace nhl::lottery;
+
+    constexpr std::size_t draws{ 200'000 };
+
+    const auto format = format_of<standard_rules>();
+    const auto odds = exact_pick_odds(format);
+
+    std::mt19937_64 gen{ 2023 };
+
+    pick_counts counts{ format.team_count() };
+    std::array<std::size_t, 2> redraws{};
+
+    for (std::size_t i = 0; i < draws; ++i)
+    {
+        const auto result = sample_draw<standard_rules>(2, gen);
+
+        counts.record(result.draft_order);
+        redraws[0] += result.redraws[0];
+        redraws[1] += result.redraws[1];
+
+        // no ranking wins twice
+        REQUIRE(result.winners[0] != result.winners[1]);
+    }
+
+    SUBCASE("the picks match the exact odds")
+    {
+        for (int ranking = 1; ranking <= 16; ++ranking)
+        {
+            for (int pick = 1; pick <= 16; ++pick)
+            {
+                const auto p = odds.pick_probability(ranking, pick);
+                const auto se = std::sqrt(p * (1.0 - p) / draws);
+
+                CAPTURE(ranking);
+                CAPTURE(pick);
+                REQUIRE(std::abs(counts.pick_probability(ranking, pick) - p) <=
+                    5.0 * se + 1e-12);
+            }
+        }
+    }
+
+    SUBCASE("the redraws match their expected number")
+    {
+        const auto c = [](int ranking)
+        {
+            return static_cast<double>(standard_rules::combinations_per_ranking[
+                static_cast<std::size_t>(ranking - 1)]);
+        };
+
+        const auto total = static_cast<double>(combination_count);
+        const auto used = static_cast<double>(combinations_used_count);
+
+        // round 1 only misses the redraw combination; round 2 also misses
+        // the first winner and, when the winner was too far down to take the
+        // 1st pick, the locked in 1st ranking
+        const auto round_1 = (total - used) / used;
+
+        double round_2{ 0.0 };
+        for (int w = 1; w <= 16; ++w)
+        {
+            const auto hits = used - c(w) -
+                ((w > max_ranking_jump + 1) ? c(1) : 0.0);
+            round_2 += c(w) / used * (total - hits) / hits;
+        }
+
+        const auto mean_1 = static_cast<double>(redraws[0]) / draws;
+        const auto mean_2 = static_cast<double>(redraws[1]) / draws;
+
+        REQUIRE(mean_1 == doctest::Approx(round_1).epsilon(0.25));
+        REQUIRE(mean_2 == doctest::Approx(round_2).epsilon(0.03));
+    }
+
+    SUBCASE("a format")
+    {
+        const auto three_draw = format_of<three_draw_rules>();
+        const auto three_draw_odds = exact_pick_odds(three_draw);
+
+        pick_counts format_counts{ three_draw.team_count() };
+        for (std::size_t i = 0; i < draws; ++i)
+        {
+            format_counts.record(sample_draw(three_draw, gen).draft_order());
+        }
+
+        for (int pick = 1; pick <= 3; ++pick)
+        {
+            const auto p = three_draw_odds.pick_probability(1, pick);
+            const auto se = std::sqrt(p * (1.0 - p) / draws);
+
+            CAPTURE(pick);
+            REQUIRE(std::abs(format_counts.pick_probability(1, pick) - p) <=
+                5.0 * se);
+        }
+    }
+}
@@ -0,0 +1,179 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <span>
+#include "nhl/lottery/exact_odds.h"
+#include "nhl/lottery/odds.h"
+#include "nhl/lottery/scenario.h"
+
+namespace
+{
+    constexpr bool near(double a, double b)
+    {
+        return (a > b ? a - b : b - a) < 1e-12;
+    }
+
+    using nhl::lottery::standard_pick_table;
+    using nhl::lottery::standard_round_winner_table;
+
+    // the published odds of winning the first draw
+    static_assert([]()
+        {
+            for (auto const& [ranking, odds] : nhl::lottery::first_round_odds)
+            {
+                if (!near(standard_round_winner_table[0][
+                    static_cast<std::size_t>(ranking - 1)], odds.to_ratio()))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }());
+
+    // 185 combinations, plus the 70 of the rankings that can't reach 1st
+    static_assert(near(standard_pick_table[0][0], 0.255));
+    static_assert(standard_pick_table[11][0] == 0.0);
+
+    // the 16th ranking can move up at most 10 spots
+    static_assert(standard_pick_table[15][4] == 0.0);
+    static_assert(standard_pick_table[15][5] > 0.0);
+
+    // every draw has a winner, and every pick goes to one ranking
+    static_assert([]()
+        {
+            for (auto const& round : standard_round_winner_table)
+            {
+                double total{ 0.0 };
+                for (const auto p : round)
+                {
+                    total += p;
+                }
+                if (!near(total, 1.0))
+                {
+                    return false;
+                }
+            }
+
+            for (std::size_t pick = 0; pick < 16; ++pick)
+            {
+                double total{ 0.0 };
+                for (auto const& ranking : standard_pick_table)
+                {
+                    total += ranking[pick];
+                }
+                if (!near(total, 1.0))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }());
+}
+
+TEST_CASE("exact_pick_odds")
+{
+    using namespace nhl::lottery;
+
+    const auto format = format_of<standard_rules>();
+    const auto odds = exact_pick_odds(format);
+
+    // every pick goes to one ranking, and every ranking gets one pick
+    for (int i = 1; i <= 16; ++i)
+    {
+        double pick{ 0.0 };
+        for (int r = 1; r <= 16; ++r)
+        {
+            pick += odds.pick_probability(r, i);
+        }
+
+        CAPTURE(i);
+        REQUIRE(pick == doctest::Approx(1.0));
+        REQUIRE(odds.pick_probability(i, 1, 16) == doctest::Approx(1.0));
+    }
+
+    // 185 combinations, plus the 70 of the rankings that can't reach 1st
+    REQUIRE(odds.pick_probability(1, 1) == doctest::Approx(0.255));
+    REQUIRE(odds.pick_probability(12, 1) == 0.0);
+
+    // the 16th ranking can move up at most 10 spots
+    REQUIRE(odds.pick_probability(16, 1, 5) == 0.0);
+    REQUIRE(odds.pick_probability(16, 6) > 0.0);
+
+    SUBCASE("the standard format is worked out at compile time")
+    {
+        // exact_pick_odds copies the table for the standard format, so the
+        // table is checked against the same enumeration run at runtime
+        std::array<std::array<double, 16>, 16> enumerated{};
+        detail::for_each_exact_draw(standard_rules::combinations_per_ranking,
+            standard_rules::rounds, standard_rules::max_ranking_jump,
+            [&enumerated](std::span<int const> draft_order,
+                std::span<int const>, double probability)
+            {
+                for (std::size_t pick = 0; pick < draft_order.size(); ++pick)
+                {
+                    enumerated[static_cast<std::size_t>(draft_order[pick] -
+                        1)][pick] += probability;
+                }
+            });
+
+        REQUIRE(enumerated[0][0] == doctest::Approx(0.255));
+        REQUIRE(enumerated[15][4] == 0.0);
+
+        for (std::size_t r = 0; r < 16; ++r)
+        {
+            for (std::size_t p = 0; p < 16; ++p)
+            {
+                CAPTURE(r);
+                CAPTURE(p);
+                REQUIRE(odds.pick_probability(static_cast<int>(r + 1),
+                    static_cast<int>(p + 1)) == doctest::Approx(
+                        enumerated[r][p]));
+            }
+        }
+
+        // the tables follow the same draws as the runtime enumeration
+        const auto three_draw = exact_pick_odds(
+            format_of<three_draw_rules>());
+        constexpr auto const& table = exact_pick_table<three_draw_rules>;
+
+        for (int r = 1; r <= 16; ++r)
+        {
+            for (int p = 1; p <= 16; ++p)
+            {
+                REQUIRE(three_draw.pick_probability(r, p) == doctest::Approx(
+                    table[static_cast<std::size_t>(r - 1)]
+                    [static_cast<std::size_t>(p - 1)]));
+            }
+        }
+
+        REQUIRE(exact_round_winner_table<three_draw_rules>.size() == 3);
+    }
+
+    SUBCASE("matches the simulation")
+    {
+        const std::array scenarios
+        {
+            scenario{ "standard", format, {} },
+            scenario{ "three-draw", format_of<three_draw_rules>(), {} }
+        };
+
+        nhl::thread_pool pool{ 2 };
+        const auto simulated = run_scenarios(scenarios, 100'000, 2023, pool);
+        const auto exact = exact_scenario_odds(scenarios);
+
+        for (std::size_t s = 0; s < scenarios.size(); ++s)
+        {
+            for (int r = 1; r <= 16; ++r)
+            {
+                for (int p = 1; p <= 16; ++p)
+                {
+                    CAPTURE(s);
+                    CAPTURE(r);
+                    CAPTURE(p);
+                    REQUIRE(simulated[s].pick_probability(r, p) ==
+                        doctest::Approx(exact[s].pick_probability(r, p))
+                        .epsilon(0.006));
+                }
+            }
+        }
+    }
+}
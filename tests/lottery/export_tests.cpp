@@ -0,0 +1,187 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include "nhl/io/loader.h"
+#include "nhl/lottery/combination_table.h"
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/export.h"
+#include "nhl/lottery/machine.h"
+#include "teams_2023.h"
+
+namespace
+{
+    nhl::lottery::lottery_stats simulated_stats(std::size_t simulations)
+    {
+        using namespace nhl::lottery;
+
+        lottery_stats ret{ .simulations = simulations, .rounds = 2 };
+        ret.lottery_teams = lottery_teams{ test::teams_2023 };
+
+        std::mt19937 gen{ 2023 };
+        machine m;
+        combination_table table;
+
+        for (std::size_t i = 0; i < simulations; ++i)
+        {
+            table.populate(gen);
+            record(ret, run_draw(table, m, ret.rounds, gen));
+        }
+
+        return ret;
+    }
+
+    std::uint64_t read_u64(std::string_view bytes, std::size_t offset)
+    {
+        std::uint64_t ret{ 0 };
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            ret |= std::uint64_t{ static_cast<std::uint8_t>(
+                bytes[offset + i]) } << (8 * i);
+        }
+        return ret;
+    }
+}
+
+TEST_CASE("write_stats")
+{
+    using namespace nhl::lottery;
+
+    const auto stats = simulated_stats(1000);
+
+    const auto written = [&stats](export_format format)
+    {
+        nhl::io::output_buffer out{ export_size(stats, format) };
+        write_stats(stats, format, out);
+
+        // nothing was written past the estimate
+        REQUIRE(out.capacity() == export_size(stats, format));
+        return std::string{ out.view() };
+    };
+
+    SUBCASE("csv")
+    {
+        const auto csv = written(export_format::csv);
+
+        std::size_t rows{ 0 };
+        std::size_t ana_picks{ 0 };
+
+        nhl::io::for_each_record(csv, [&](nhl::io::record const& r)
+            {
+                ++rows;
+
+                if (r.required("kind") == "pick" &&
+                    r.required("team") == "ANA")
+                {
+                    ana_picks += static_cast<std::size_t>(
+                        r.get_int("count").value());
+                }
+            });
+
+        // 2 totals, 16 winners and the redraws per round, 16 x 16 picks
+        REQUIRE(rows == 2 + 2 * 17 + 256);
+        REQUIRE(ana_picks == stats.simulations);
+        REQUIRE(csv.starts_with(
+            "kind,round,ranking,team,pick,count,probability\n"
+            "simulations,,,,,1000,\n"));
+    }
+
+    SUBCASE("json")
+    {
+        const auto json = written(export_format::json);
+
+        REQUIRE(json.starts_with("{\"simulations\":1000,\"rounds\":2,"));
+        REQUIRE(json.find("{\"ranking\":1,\"team\":\"ANA\",\"picks\":[") !=
+            std::string::npos);
+        REQUIRE(json.ends_with("]}\n"));
+    }
+
+    SUBCASE("binary")
+    {
+        const auto bytes = written(export_format::binary);
+
+        REQUIRE(bytes.size() == export_size(stats, export_format::binary));
+        REQUIRE(bytes.starts_with(binary_export_magic));
+        REQUIRE(bytes[4] == 1);
+        REQUIRE(bytes[6] == 16);
+        REQUIRE(bytes[7] == 2);
+        REQUIRE(read_u64(bytes, 8) == 1000);
+        REQUIRE(static_cast<std::uint8_t>(bytes[24]) ==
+            static_cast<std::uint8_t>(nhl::team_id::ana));
+
+        // the picks of ranking 1 add up to the simulations
+        const auto picks = bytes.size() - 16 * 16 * 8;
+        std::uint64_t total{ 0 };
+        for (std::size_t p = 0; p < 16; ++p)
+        {
+            total += read_u64(bytes, picks + p * 8);
+        }
+        REQUIRE(total == 1000);
+    }
+
+    SUBCASE("the size doesn't depend on the number of simulations")
+    {
+        auto big = stats;
+        big.simulations = std::numeric_limits<std::size_t>::max();
+        for (auto& [pick, counts] : big.draft_order_stats)
+        {
+            for (auto& [ranking, count] : counts)
+            {
+                count = std::numeric_limits<std::size_t>::max();
+            }
+        }
+
+        for (auto format : { export_format::csv, export_format::json })
+        {
+            REQUIRE(export_size(big, format) == export_size(stats, format));
+
+            nhl::io::output_buffer out{ export_size(big, format) };
+            write_stats(big, format, out);
+            REQUIRE(out.capacity() == export_size(big, format));
+        }
+    }
+
+    REQUIRE(parse_export_format("json") == export_format::json);
+    REQUIRE_FALSE(parse_export_format("xml"));
+}
+
+TEST_CASE("parse_binary_stats")
+{
+    using namespace nhl::lottery;
+
+    const auto stats = simulated_stats(1000);
+
+    nhl::io::output_buffer out{ export_size(stats, export_format::binary) };
+    write_stats(stats, export_format::binary, out);
+    const std::string bytes{ out.view() };
+
+    SUBCASE("round trip")
+    {
+        const auto parsed = parse_binary_stats(bytes);
+
+        REQUIRE(parsed.simulations == stats.simulations);
+        REQUIRE(parsed.rounds == stats.rounds);
+        REQUIRE(parsed.original_draft_order_retained ==
+            stats.original_draft_order_retained);
+        REQUIRE(parsed.lottery_teams.has_value());
+        REQUIRE(parsed.lottery_teams->team_at(16) == nhl::team_id::cgy);
+        REQUIRE(parsed.round_winner_stats == stats.round_winner_stats);
+        REQUIRE(parsed.draft_order_stats == stats.draft_order_stats);
+        REQUIRE(parsed.redraws == stats.redraws);
+    }
+
+    SUBCASE("invalid")
+    {
+        REQUIRE_THROWS(parse_binary_stats(""));
+        REQUIRE_THROWS(parse_binary_stats(
+            std::string_view{ bytes }.substr(0, bytes.size() - 1)));
+        REQUIRE_THROWS(parse_binary_stats(bytes + "x"));
+
+        auto wrong_magic = bytes;
+        wrong_magic[0] = 'X';
+        REQUIRE_THROWS(parse_binary_stats(wrong_magic));
+    }
+}
@@ -0,0 +1,119 @@
+#include <doctest/doctest.h>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "nhl/thread_pool.h"
+#include "nhl/lottery/batch.h"
+#include "nhl/lottery/histogram.h"
+
+TEST_CASE("flat_histogram")
+{
+    using namespace nhl::lottery;
+
+    flat_histogram<std::uint64_t> histogram;
+
+    // enough keys to grow the table a few times
+    for (std::uint64_t key = 0; key < 1000; ++key)
+    {
+        histogram.add(key << 48, key % 7 + 1);
+    }
+    histogram.add(0, 10);
+
+    REQUIRE(histogram.size() == 1000);
+    REQUIRE(histogram.count(0) == 11);
+    REQUIRE(histogram.count(999ull << 48) == 999 % 7 + 1);
+    REQUIRE(histogram.count(1) == 0);
+
+    SUBCASE("sorted")
+    {
+        const auto sorted = histogram.sorted();
+        REQUIRE(sorted.size() == 1000);
+        REQUIRE(sorted.front().key == 0);
+        REQUIRE(sorted.front().count == 11);
+
+        // equal counts are in key order
+        REQUIRE(sorted[1].count == 7);
+        REQUIRE(sorted[1].key == (6ull << 48));
+        REQUIRE(sorted[2].key == (13ull << 48));
+    }
+
+    SUBCASE("merge")
+    {
+        flat_histogram<std::uint64_t> other;
+        other.add(0);
+        other.add(5);
+
+        const auto total = histogram.total();
+        histogram += other;
+
+        REQUIRE(histogram.size() == 1001);
+        REQUIRE(histogram.count(0) == 12);
+        REQUIRE(histogram.count(5) == 1);
+        REQUIRE(histogram.total() == total + 2);
+    }
+}
+
+TEST_CASE("count_draft_orders")
+{
+    using namespace nhl::lottery;
+
+    nhl::thread_pool pool{ 2 };
+
+    constexpr std::size_t draws{ 100'000 };
+    const auto format = format_of<standard_rules>();
+
+    const auto histogram = count_draft_orders(format, draws, 2023, pool);
+    REQUIRE(histogram.total() == draws);
+
+    // at most 16 first round winners times 15 second round winners
+    REQUIRE(histogram.size() <= 16 * 15);
+
+    std::size_t top_two_kept{ 0 };
+    histogram.for_each([&](packed_draft_order order, std::size_t count)
+        {
+            if (order[0] == 1 && order[1] == 2)
+            {
+                top_two_kept += count;
+            }
+        });
+
+    std::size_t first_pick_kept{ 0 };
+    histogram.for_each([&](packed_draft_order order, std::size_t count)
+        {
+            if (order[0] == 1)
+            {
+                first_pick_kept += count;
+            }
+        });
+
+    // the 1st ranking keeps the 1st pick 25.5% of the time
+    REQUIRE(static_cast<double>(first_pick_kept) / draws ==
+        doctest::Approx(0.255).epsilon(0.02));
+    REQUIRE(top_two_kept < first_pick_kept);
+
+    SUBCASE("the sorted list starts with the most frequent order")
+    {
+        const auto sorted = histogram.sorted();
+        REQUIRE(sorted.size() == histogram.size());
+        REQUIRE(sorted.front().count >= sorted.back().count);
+    }
+
+    SUBCASE("the results don't depend on the number of threads")
+    {
+        nhl::thread_pool single{ 1 };
+        const auto other = count_draft_orders(format, draws, 2023, single);
+
+        REQUIRE(other.size() == histogram.size());
+        histogram.for_each([&](packed_draft_order order, std::size_t count)
+            {
+                REQUIRE(other.count(order) == count);
+            });
+    }
+
+    SUBCASE("too many teams")
+    {
+        lottery_format big{ 1, 32, std::vector<std::size_t>(17, 50) };
+        REQUIRE_THROWS_AS(count_draft_orders(big, 10, 1, pool),
+            std::out_of_range);
+    }
+}
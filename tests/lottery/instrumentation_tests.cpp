@@ -0,0 +1,64 @@
+#include <doctest/doctest.h>
+#include <random>
+#include <type_traits>
+#include "nhl/lottery/combination_table.h"
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/instrumentation.h"
+#include "nhl/lottery/machine.h"
+
+TEST_CASE("instrumentation")
+{
+    using namespace nhl::lottery;
+    namespace inst = nhl::lottery::instrumentation;
+
+    const auto value = [](inst::thread_counters const& t, inst::counter c)
+    {
+        return t.counters[static_cast<std::size_t>(c)];
+    };
+
+    inst::reset();
+
+    std::mt19937 gen{ 2023 };
+    machine m;
+    combination_table table;
+    lottery_stats stats{ .simulations = 100, .rounds = 2 };
+
+    std::size_t redraws{ 0 };
+    for (std::size_t i = 0; i < stats.simulations; ++i)
+    {
+        table.populate(gen);
+        const auto result = run_draw(table, m, stats.rounds, gen);
+        redraws += result.redraws[0] + result.redraws[1];
+        record(stats, result);
+    }
+
+    const auto t = inst::totals();
+
+    if constexpr (inst::enabled)
+    {
+        const auto attempts = value(t, inst::counter::attempts);
+
+        REQUIRE(value(t, inst::counter::lotteries) == 100);
+        REQUIRE(value(t, inst::counter::table_populates) == 100);
+        REQUIRE(value(t, inst::counter::moves) == 200);
+        REQUIRE(attempts == 200 + redraws);
+        REQUIRE(value(t, inst::counter::lookups) == attempts);
+        REQUIRE(value(t, inst::counter::balls_drawn) ==
+            attempts * balls_to_draw);
+        REQUIRE(value(t, inst::counter::redraws_unassigned) +
+            value(t, inst::counter::redraws_previous_winner) +
+            value(t, inst::counter::redraws_locked_in) == redraws);
+
+        const auto record_stage = static_cast<std::size_t>(
+            inst::stage::record);
+        REQUIRE(t.stage_calls[record_stage] == 100);
+        REQUIRE(t.stage_samples[record_stage] ==
+            (100 + inst::sample_interval - 1) / inst::sample_interval);
+    }
+    else
+    {
+        // nothing is counted, and the timers take no space
+        REQUIRE(value(t, inst::counter::lotteries) == 0);
+        REQUIRE(std::is_empty_v<inst::stage_timer>);
+    }
+}
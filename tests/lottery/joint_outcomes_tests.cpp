@@ -0,0 +1,112 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <stdexcept>
+#include "nhl/thread_pool.h"
+#include "nhl/lottery/joint_outcomes.h"
+#include "teams_2023.h"
+
+namespace
+{
+    const nhl::lottery::lottery_teams teams_2023{
+        nhl::lottery::test::teams_2023 };
+}
+
+TEST_CASE("joint_outcomes")
+{
+    using namespace nhl::lottery;
+
+    constexpr std::size_t draws{ 100'000 };
+    constexpr round_number round_1{ 1 };
+    constexpr round_number round_2{ 2 };
+
+    nhl::thread_pool pool{ 2 };
+    const auto outcomes = count_outcomes(format_of<standard_rules>(), draws,
+        2023, pool);
+
+    const joint_outcomes joint{ outcomes, team_count, lottery_rounds,
+        teams_2023 };
+
+    REQUIRE(joint.total() == draws);
+    REQUIRE(joint.size() == outcomes.size());
+
+    SUBCASE("probability")
+    {
+        REQUIRE(joint.probability({}) == 1.0);
+        REQUIRE(joint.probability({ pick_between(5, 1, 16) }) == 1.0);
+
+        // the 16th can't move up more than 10 spots
+        REQUIRE(joint.probability({ pick_between(16, 1, 5) }) == 0.0);
+
+        REQUIRE(joint.probability({ pick_at(1, 1) }) ==
+            doctest::Approx(0.255).epsilon(0.02));
+
+        const auto ana = joint.ranking_of(nhl::team_id::ana);
+        const auto cbj = joint.ranking_of(nhl::team_id::cbj);
+        REQUIRE(ana == 1);
+
+        // ANA and CBJ both out of the top two, counted the slow way
+        std::size_t expected{ 0 };
+        outcomes.for_each([&](lottery_outcome const& o, std::size_t count)
+            {
+                if (o.draft_order.index_of(ana) >= 2 &&
+                    o.draft_order.index_of(cbj) >= 2)
+                {
+                    expected += count;
+                }
+            });
+
+        REQUIRE(expected > 0);
+        REQUIRE(joint.count(std::array{ pick_between(ana, 3, 16),
+            pick_between(cbj, 3, 16) }) == expected);
+    }
+
+    SUBCASE("conditional")
+    {
+        // winning round 1 is always the 1st pick for the top 11
+        REQUIRE(joint.conditional({ pick_at(3, 1) },
+            { won_round(3, round_1) }) == 1.0);
+        REQUIRE(joint.conditional({ pick_at(1, 1) },
+            { won_round(2, round_1) }) == 0.0);
+
+        // the 12th jumps 10 spots to 2nd, and the round 2 winner can pass
+        // it
+        REQUIRE(joint.conditional({ pick_between(12, 2, 3) },
+            { won_round(12, round_1) }) == 1.0);
+        REQUIRE(joint.conditional({ pick_at(12, 3) },
+            { won_round(12, round_1) }) > 0.0);
+
+        // a ranking can't win twice
+        REQUIRE_FALSE(joint.conditional({ pick_at(1, 1) },
+            { won_round(4, round_1), won_round(4, round_2) }));
+
+        const auto odds = joint.conditional_pick_odds(3,
+            { won_round(1, round_1) });
+        REQUIRE(odds);
+        REQUIRE(odds->size() == team_count);
+
+        double total{ 0.0 };
+        for (auto p : *odds)
+        {
+            total += p;
+        }
+        REQUIRE(total == doctest::Approx(1.0));
+
+        // with the 1st pick taken, the 3rd ends up 2nd (winning round 2),
+        // 3rd or 4th (passed by the round 2 winner)
+        REQUIRE((*odds)[0] == 0.0);
+        REQUIRE((*odds)[1] + (*odds)[2] + (*odds)[3] ==
+            doctest::Approx(1.0));
+    }
+
+    SUBCASE("invalid queries")
+    {
+        REQUIRE_THROWS_AS(joint.probability({ pick_at(17, 1) }),
+            std::out_of_range);
+        REQUIRE_THROWS_AS(joint.probability({ pick_between(1, 3, 2) }),
+            std::out_of_range);
+        REQUIRE_THROWS_AS(joint.probability({
+            won_round(1, round_number{ 3 }) }), std::out_of_range);
+        REQUIRE_THROWS_AS(joint.ranking_of(nhl::team_id::bos),
+            std::invalid_argument);
+    }
+}
@@ -0,0 +1,157 @@
+#include <doctest/doctest.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "nhl/thread_pool.h"
+#include "nhl/lottery/exact_odds.h"
+#include "nhl/lottery/odds_server.h"
+
+namespace
+{
+    constexpr std::string_view standard_order{ "ANA,CBJ,CHI,SJS,MTL,ARI,PHI,"
+        "WSH,DET,STL,VAN,OTT,BUF,PIT,NSH,CGY" };
+}
+
+TEST_CASE("parse_odds_query")
+{
+    using namespace nhl::lottery;
+
+    SUBCASE("exact")
+    {
+        const auto q = parse_odds_query(fmt::format("q1 exact {}",
+            standard_order));
+
+        REQUIRE(q.id == "q1");
+        REQUIRE(q.kind == odds_query_kind::exact);
+        REQUIRE(q.scenario.teams.size() == 16);
+        REQUIRE(q.scenario.teams[3] == nhl::team_id::sjs);
+        REQUIRE(q.scenario.format.combinations_per_ranking ==
+            format_of<standard_rules>().combinations_per_ranking);
+    }
+
+    SUBCASE("ties and options")
+    {
+        const auto q = parse_odds_query("q2 simulate ANA,CBJ=CHI=SJS,MTL "
+            "draws=500 seed=9 rounds=1 max_jump=2 "
+            "combinations=200,115,115,95,85");
+
+        REQUIRE(q.kind == odds_query_kind::simulate);
+        REQUIRE(q.draws == 500);
+        REQUIRE(q.seed == 9u);
+        REQUIRE(q.scenario.format.rounds == 1);
+        REQUIRE(q.scenario.format.max_ranking_jump == 2);
+
+        // 115 + 115 + 95 split 3 ways
+        REQUIRE(q.scenario.format.combinations_per_ranking ==
+            std::vector<std::size_t>{ 200, 109, 108, 108, 85 });
+    }
+
+    SUBCASE("the key only depends on the format")
+    {
+        const auto a = parse_odds_query("a exact ANA,CBJ,CHI");
+        const auto b = parse_odds_query("b exact TOR,BOS,NYR");
+        const auto c = parse_odds_query("c exact ANA,CBJ=CHI");
+
+        REQUIRE(odds_query_key(a) == odds_query_key(b));
+        REQUIRE(odds_query_key(a) != odds_query_key(c));
+    }
+
+    REQUIRE_THROWS_AS(parse_odds_query("q1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_odds_query("q1 guess ANA,CBJ"),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_odds_query("q1 exact ANA,XXX"),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_odds_query("q1 exact ANA,ANA"),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_odds_query("q1 exact ANA,CBJ draws=5"),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_odds_query(fmt::format("q1 simulate ANA,CBJ "
+        "draws={}", max_query_draws + 1)), std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_odds_query("q1 exact ANA,CBJ,CHI rounds=x"),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(parse_odds_query("q1 exact ANA,CBJ rounds=2"),
+        std::out_of_range);
+}
+
+TEST_CASE("odds_server")
+{
+    using namespace nhl::lottery;
+
+    nhl::thread_pool pool{ 2 };
+    odds_server server{ pool, 4 };
+
+    std::mutex mutex;
+    std::vector<std::string> responses;
+
+    const auto respond = [&](std::string_view r)
+    {
+        const std::scoped_lock lock{ mutex };
+        responses.emplace_back(r);
+    };
+
+    const auto exact = fmt::format("q1 exact {}", standard_order);
+
+    server.handle(exact, respond);
+    server.handle(exact, respond);
+
+    REQUIRE(responses.size() == 2);
+    REQUIRE(responses[0].starts_with(
+        "{\"id\":\"q1\",\"kind\":\"exact\",\"cached\":false,\"rounds\":2,"));
+    REQUIRE(responses[1].find("\"cached\":true") != std::string::npos);
+
+    // the exact 25.5% of the 1st ranking getting the 1st pick
+    REQUIRE(responses[0].find("{\"ranking\":1,\"team\":\"ANA\",\"picks\":["
+        "0.255000,") != std::string::npos);
+
+    SUBCASE("simulations are answered asynchronously")
+    {
+        const auto simulate = fmt::format("q2 simulate {} draws=20000 seed=3",
+            standard_order);
+
+        server.handle(simulate, respond);
+        server.handle(simulate, respond);
+        server.wait();
+
+        REQUIRE(responses.size() == 4);
+        REQUIRE(responses[2].find("\"kind\":\"simulate\",\"cached\":false,"
+            "\"rounds\":2,\"draws\":20000,\"seed\":3,") != std::string::npos);
+
+        // the second one found the first one's result
+        REQUIRE(responses[3].find("\"cached\":true") != std::string::npos);
+
+        // each query is counted once, whether it was a hit when it was
+        // handled or when it was run
+        const auto s = server.stats();
+        REQUIRE(s.pending == 0);
+        REQUIRE(s.entries == 2);
+        REQUIRE(s.hits + s.misses == 4);
+    }
+
+    SUBCASE("stats after a simulation")
+    {
+        server.handle(fmt::format("q5 simulate {} draws=1000 seed=3",
+            standard_order), respond);
+        server.wait();
+
+        server.handle("q6 stats", respond);
+
+        REQUIRE(responses.back() == "{\"id\":\"q6\",\"kind\":\"stats\","
+            "\"hits\":1,\"misses\":2,\"pending\":0,\"entries\":2}");
+    }
+
+    SUBCASE("errors")
+    {
+        server.handle("q\"3 exact ANA,XXX", respond);
+
+        REQUIRE(responses.back() ==
+            "{\"id\":\"q\\\"3\",\"error\":\"Invalid team 'XXX'\"}");
+    }
+
+    SUBCASE("stats")
+    {
+        server.handle("q4 stats", respond);
+
+        REQUIRE(responses.back() == "{\"id\":\"q4\",\"kind\":\"stats\","
+            "\"hits\":1,\"misses\":1,\"pending\":0,\"entries\":1}");
+    }
+}
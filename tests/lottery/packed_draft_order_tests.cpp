@@ -0,0 +1,67 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <unordered_set>
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/packed_draft_order.h"
+
+TEST_CASE("packed_draft_order")
+{
+    using namespace nhl::lottery;
+
+    SUBCASE("round trip")
+    {
+        const std::array order{ 3, 1, 2, 16, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+            14, 15 };
+        const packed_draft_order packed{ order };
+
+        REQUIRE(packed.to_array<16>() == order);
+        REQUIRE(packed.index_of(16) == 3);
+        REQUIRE(packed.index_of(3) == 0);
+        REQUIRE(packed_draft_order::from_word(packed.word()) == packed);
+
+        const std::array too_high{ 1, 17 };
+        REQUIRE_THROWS_AS(packed_draft_order{ too_high }, std::out_of_range);
+    }
+
+    SUBCASE("moves up like detail::move_up")
+    {
+        std::mt19937 gen{ 2023 };
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            std::array<int, 16> expected{};
+            std::iota(expected.begin(), expected.end(), 1);
+            packed_draft_order packed;
+
+            const auto max_jump = std::uniform_int_distribution{ 1, 16 }(gen);
+
+            for (std::size_t round_index = 0; round_index < 4; ++round_index)
+            {
+                const auto winner =
+                    std::uniform_int_distribution{ 1, 16 }(gen);
+
+                REQUIRE(packed.move_up(round_index, winner, max_jump) ==
+                    detail::move_up(expected, round_index, winner, max_jump));
+                REQUIRE(packed.to_array<16>() == expected);
+            }
+        }
+    }
+
+    SUBCASE("orders compare and hash as words")
+    {
+        packed_draft_order a;
+        packed_draft_order b;
+        REQUIRE(a == b);
+
+        a.move_up(0, 5, 10);
+        REQUIRE(a != b);
+        REQUIRE((a < b) == (a.word() < b.word()));
+
+        b.move_up(0, 5, 10);
+        const std::unordered_set<packed_draft_order> orders{ a, b };
+        REQUIRE(orders.size() == 1);
+    }
+}
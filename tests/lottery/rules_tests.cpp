@@ -0,0 +1,72 @@
+#include <doctest/doctest.h>
+#include <algorithm>
+#include "nhl/random.h"
+#include "nhl/lottery/combination_table.h"
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/machine.h"
+#include "nhl/lottery/round.h"
+#include "nhl/lottery/rules.h"
+
+namespace
+{
+    template <nhl::lottery::lottery_rules Rules>
+    void check_rules()
+    {
+        using namespace nhl::lottery;
+
+        CAPTURE(Rules::name);
+
+        auto gen = nhl::make_random_engine(2023, 0);
+
+        basic_combination_table<Rules> table;
+        table.populate(gen);
+
+        // every ranking gets exactly its combinations
+        for (std::size_t r = 0; r < Rules::team_count; ++r)
+        {
+            REQUIRE(static_cast<std::size_t>(std::ranges::count(
+                table.rankings(), static_cast<int>(r + 1))) ==
+                Rules::combinations_per_ranking[r]);
+        }
+
+        machine m;
+        for (int i = 0; i < 2000; ++i)
+        {
+            const auto result = run_draw(table, m, Rules::rounds, gen);
+
+            auto sorted = result.draft_order;
+            std::ranges::sort(sorted);
+            REQUIRE(sorted == rankings_for<Rules>);
+
+            for (std::size_t round = 0; round < Rules::rounds; ++round)
+            {
+                const auto winner = result.winners[round];
+                const auto pick = std::ranges::find(result.draft_order,
+                    winner) - result.draft_order.begin() + 1;
+
+                // a winner can't move past the round's pick, or further
+                // than the jump limit allows
+                REQUIRE(pick >= static_cast<int>(round + 1));
+                REQUIRE(pick >= winner - Rules::max_ranking_jump);
+            }
+        }
+    }
+}
+
+TEST_CASE("lottery rules")
+{
+    using namespace nhl::lottery;
+
+    static_assert(combinations_used_by<standard_rules> == 1000);
+    static_assert(combinations_used_by<rules_2019> == 1000);
+    static_assert(combinations_used_by<rules_2016> == 1000);
+    static_assert(rankings_for<rules_2016>.back() == 14);
+
+    static_assert(static_cast<int>((round_number::max)()) ==
+        static_cast<int>(max_lottery_rounds));
+
+    check_rules<standard_rules>();
+    check_rules<three_draw_rules>();
+    check_rules<rules_2019>();
+    check_rules<rules_2016>();
+}
@@ -0,0 +1,149 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "nhl/lottery/scenario.h"
+#include "teams_2023.h"
+
+namespace
+{
+    const nhl::lottery::lottery_teams teams_2023{
+        nhl::lottery::test::teams_2023 };
+
+    // The 2023 order, then the same teams with ANA and CBJ swapped and the
+    // 1st and 2nd combinations split evenly between them
+    std::string scenarios_csv()
+    {
+        std::string ret{ "scenario,ranking,team,combinations\n" };
+
+        for (std::string_view name : { "actual", "split" })
+        {
+            for (int ranking = 1; ranking <= 16; ++ranking)
+            {
+                auto team = *teams_2023.lookup(ranking);
+                std::string combinations;
+
+                if (name == "split" && ranking <= 2)
+                {
+                    team = (ranking == 1) ? nhl::team_id::cbj :
+                        nhl::team_id::ana;
+                    combinations = "160";
+                }
+
+                ret += fmt::format("{},{},{},{}\n", name, ranking,
+                    to_string(team), combinations);
+            }
+        }
+
+        return ret;
+    }
+}
+
+TEST_CASE("parse_scenarios")
+{
+    using namespace nhl::lottery;
+
+    const auto scenarios = parse_scenarios(scenarios_csv());
+
+    REQUIRE(scenarios.size() == 2);
+
+    const auto actual = make_scenario("actual", teams_2023);
+    REQUIRE(scenarios[0].name == actual.name);
+    REQUIRE(scenarios[0].teams == actual.teams);
+    REQUIRE(scenarios[0].format.combinations_per_ranking ==
+        actual.format.combinations_per_ranking);
+    REQUIRE(scenarios[0].format.rounds == actual.format.rounds);
+
+    REQUIRE(scenarios[1].name == "split");
+    REQUIRE(scenarios[1].teams[0] == nhl::team_id::cbj);
+    REQUIRE(scenarios[1].format.combinations_per_ranking[0] == 160);
+    REQUIRE(scenarios[1].format.combinations_per_ranking[1] == 160);
+
+    SUBCASE("tied teams split their combinations")
+    {
+        const auto tied = parse_scenarios(
+            "scenario,ranking,team,tie\n"
+            "a,1,ANA,\n"
+            "a,2,CBJ,x\n"
+            "a,3,CHI,x\n"
+            "a,4,SJS,x\n");
+
+        // 135 + 115 + 95 = 345 = 3 * 115
+        REQUIRE(tied[0].format.combinations_per_ranking ==
+            std::vector<std::size_t>{ 185, 115, 115, 115 });
+    }
+
+    SUBCASE("invalid scenarios")
+    {
+        // ranking 2 is missing
+        REQUIRE_THROWS_AS(parse_scenarios(
+            "scenario,ranking,team\n"
+            "a,1,ANA\n"
+            "a,3,CBJ\n"), std::invalid_argument);
+
+        // a tie between rankings that aren't next to each other
+        REQUIRE_THROWS_AS(parse_scenarios(
+            "scenario,ranking,team,tie\n"
+            "a,1,ANA,x\n"
+            "a,2,CBJ,\n"
+            "a,3,CHI,x\n"), std::invalid_argument);
+
+        // the same team twice
+        REQUIRE_THROWS_AS(parse_scenarios(
+            "scenario,ranking,team\n"
+            "a,1,ANA\n"
+            "a,2,ANA\n"
+            "a,3,CBJ\n"), std::invalid_argument);
+    }
+}
+
+TEST_CASE("run_scenarios")
+{
+    using namespace nhl::lottery;
+
+    const auto scenarios = parse_scenarios(scenarios_csv());
+
+    constexpr std::size_t draws{ 50'000 };
+
+    nhl::thread_pool pool{ 2 };
+    const auto results = run_scenarios(scenarios, draws, 2023, pool);
+
+    REQUIRE(results.size() == scenarios.size());
+
+    for (auto const& r : results)
+    {
+        REQUIRE(r.draws == draws);
+
+        // every ranking gets exactly one pick per draw
+        for (int ranking = 1; ranking <= 16; ++ranking)
+        {
+            REQUIRE(r.pick_probability(ranking, 1, 16) ==
+                doctest::Approx(1.0));
+        }
+    }
+
+    // 1st: 185 combinations plus the 70 of the teams that can't jump to 1st
+    REQUIRE(results[0].pick_probability(1, 1) ==
+        doctest::Approx(0.255).epsilon(0.05));
+
+    // after an even split the 2 teams win the first draw equally often, but
+    // only the 1st ranked team keeps the pick when a team ranked 12th or
+    // lower wins
+    REQUIRE(results[1].pick_probability(1, 1) ==
+        doctest::Approx(0.230).epsilon(0.05));
+    REQUIRE(results[1].pick_probability(2, 1) ==
+        doctest::Approx(0.160).epsilon(0.05));
+
+    SUBCASE("the results don't depend on the number of threads")
+    {
+        nhl::thread_pool single{ 1 };
+        const auto other = run_scenarios(scenarios, draws, 2023, single);
+
+        for (std::size_t s = 0; s < results.size(); ++s)
+        {
+            REQUIRE(other[s].picks == results[s].picks);
+        }
+    }
+}
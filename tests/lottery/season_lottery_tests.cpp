@@ -0,0 +1,76 @@
+#include <doctest/doctest.h>
+#include "nhl/lottery/season_lottery.h"
+#include "nhl/schedule.h"
+
+TEST_CASE("simulate_season_lottery")
+{
+    using namespace nhl::lottery;
+
+    const nhl::season_model model
+    {
+        nhl::index_by_team(nhl::standings),
+        nhl::remaining_games
+    };
+
+    const season_lottery_options options
+    {
+        .seasons = 2000,
+        .draws_per_season = 2,
+        .rounds = 2,
+        .seed = 2023
+    };
+
+    nhl::thread_pool pool{ 2 };
+    const auto stats = simulate_season_lottery(model, options, pool);
+
+    REQUIRE(stats.seasons == options.seasons);
+    REQUIRE(stats.draws() == options.seasons * options.draws_per_season);
+
+    SUBCASE("every pick is handed out once per draw")
+    {
+        for (std::size_t pick = 0; pick < rankings_count; ++pick)
+        {
+            std::size_t count{ 0 };
+            for (auto const& team_picks : stats.picks)
+            {
+                count += team_picks[pick];
+            }
+
+            CAPTURE(pick);
+            REQUIRE(count == stats.draws());
+        }
+    }
+
+    SUBCASE("every ranking is handed out once per season")
+    {
+        for (std::size_t ranking = 0; ranking < rankings_count; ++ranking)
+        {
+            std::size_t count{ 0 };
+            for (auto const& team_rankings : stats.lottery_rankings)
+            {
+                count += team_rankings[ranking];
+            }
+
+            CAPTURE(ranking);
+            REQUIRE(count == stats.seasons);
+        }
+    }
+
+    SUBCASE("clinched teams never enter the lottery")
+    {
+        for (auto const& count :
+            stats.picks[static_cast<std::size_t>(nhl::team_id::bos)])
+        {
+            REQUIRE(count == 0);
+        }
+    }
+
+    SUBCASE("the results don't depend on the number of threads")
+    {
+        nhl::thread_pool single{ 1 };
+        const auto other = simulate_season_lottery(model, options, single);
+
+        REQUIRE(other.picks == stats.picks);
+        REQUIRE(other.lottery_rankings == stats.lottery_rankings);
+    }
+}
@@ -0,0 +1,88 @@
+#include <doctest/doctest.h>
+#include <cmath>
+#include <stdexcept>
+#include "nhl/thread_pool.h"
+#include "nhl/lottery/exact_odds.h"
+#include "nhl/lottery/sensitivity.h"
+
+TEST_CASE("run_odds_sensitivity")
+{
+    using namespace nhl::lottery;
+
+    // 10 combinations short of 1000, so the exact odds can be taken with 5
+    // more or 5 fewer for any ranking
+    auto format = format_of<standard_rules>();
+    format.combinations_per_ranking[0] -= 10;
+
+    constexpr std::size_t draws{ 200'000 };
+    constexpr std::size_t step{ 5 };
+
+    nhl::thread_pool pool{ 2 };
+    const auto sensitivity = run_odds_sensitivity(format, draws, step, 2023,
+        pool);
+
+    REQUIRE(sensitivity.team_count() == 16);
+    REQUIRE(sensitivity.base.draws == draws);
+    REQUIRE(sensitivity.decreases[0] == step);
+
+    const auto exact_derivative = [&](int moved, int ranking, int pick)
+    {
+        auto up = format;
+        auto down = format;
+        up.combinations_per_ranking[static_cast<std::size_t>(moved - 1)] +=
+            step;
+        down.combinations_per_ranking[static_cast<std::size_t>(moved - 1)] -=
+            step;
+
+        return (exact_pick_odds(up).pick_probability(ranking, pick) -
+            exact_pick_odds(down).pick_probability(ranking, pick)) /
+            (2.0 * step);
+    };
+
+    SUBCASE("the derivatives match the exact odds")
+    {
+        for (int moved : { 1, 4, 12 })
+        {
+            for (int ranking : { 1, 2, moved })
+            {
+                const auto exact = exact_derivative(moved, ranking, 1);
+                const auto estimate = sensitivity.derivative(moved, ranking,
+                    1);
+
+                // within 15% or 0.00005 per combination
+                REQUIRE(std::abs(estimate - exact) <=
+                    std::max(0.15 * std::abs(exact), 0.00005));
+            }
+        }
+    }
+
+    SUBCASE("the base draws have the format's odds")
+    {
+        const auto exact = exact_pick_odds(format);
+        REQUIRE(sensitivity.base.pick_probability(1, 1) ==
+            doctest::Approx(exact.pick_probability(1, 1)).epsilon(0.02));
+    }
+
+    SUBCASE("the results don't depend on the number of threads")
+    {
+        nhl::thread_pool single{ 1 };
+        const auto other = run_odds_sensitivity(format, 10'000, step, 7,
+            single);
+        const auto same = run_odds_sensitivity(format, 10'000, step, 7, pool);
+
+        REQUIRE(other.base.picks == same.base.picks);
+        REQUIRE(other.increased[3].picks == same.increased[3].picks);
+        REQUIRE(other.decreased[15].picks == same.decreased[15].picks);
+    }
+
+    SUBCASE("a ranking keeps at least 1 combination")
+    {
+        auto small = format_of<standard_rules>();
+        small.combinations_per_ranking[15] = 3;
+
+        const auto s = run_odds_sensitivity(small, 100, step, 1, pool);
+        REQUIRE(s.decreases[15] == 2);
+        REQUIRE_THROWS_AS(run_odds_sensitivity(small, 100, 0, 1, pool),
+            std::out_of_range);
+    }
+}
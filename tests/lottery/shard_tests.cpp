@@ -0,0 +1,149 @@
+#include <doctest/doctest.h>
+#include <filesystem>
+#include <vector>
+#include "nhl/thread_pool.h"
+#include "nhl/lottery/shard.h"
+#include "nhl/lottery/ties.h"
+#include "teams_2023.h"
+
+namespace
+{
+    nhl::lottery::lottery_stats empty_stats(std::size_t simulations)
+    {
+        using namespace nhl::lottery;
+
+        lottery_stats ret{ .simulations = simulations, .rounds = 2 };
+        ret.lottery_teams = lottery_teams{ test::teams_2023 };
+        return ret;
+    }
+
+    void require_same(nhl::lottery::lottery_stats const& a,
+        nhl::lottery::lottery_stats const& b)
+    {
+        REQUIRE(a.simulations == b.simulations);
+        REQUIRE(a.original_draft_order_retained ==
+            b.original_draft_order_retained);
+        REQUIRE(a.round_winner_stats == b.round_winner_stats);
+        REQUIRE(a.draft_order_stats == b.draft_order_stats);
+        REQUIRE(a.redraws == b.redraws);
+    }
+}
+
+TEST_CASE("shard")
+{
+    using nhl::lottery::shard;
+
+    // 10 blocks
+    constexpr std::size_t simulations{ 9 * nhl::simulation_block_size + 1 };
+
+    std::size_t total{ 0 };
+    std::size_t next_block{ 0 };
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        const shard s{ i, 3 };
+        const auto blocks = s.blocks(simulations);
+
+        REQUIRE(blocks.first == next_block);
+        next_block = blocks.last;
+        total += s.simulations(simulations);
+    }
+
+    REQUIRE(next_block == 10);
+    REQUIRE(total == simulations);
+
+    // more shards than blocks leaves some of them empty
+    REQUIRE(shard{ 0, 4 }.simulations(100) == 0);
+    REQUIRE(shard{ 3, 4 }.simulations(100) == 100);
+
+    REQUIRE_THROWS((shard{ 2, 2 }.validate()));
+    REQUIRE_THROWS((shard{ 0, 0 }.validate()));
+}
+
+TEST_CASE("simulate_stats")
+{
+    using namespace nhl::lottery;
+
+    constexpr std::size_t simulations{ 3 * nhl::simulation_block_size + 7 };
+
+    const auto empty = empty_stats(simulations);
+    nhl::thread_pool pool{ 3 };
+    nhl::thread_pool one{ 1 };
+
+    for (auto method : { draw_method::draw, draw_method::sampled })
+    {
+        CAPTURE(to_string(method));
+
+        const auto whole = simulate_stats(empty, 11, method, pool);
+        REQUIRE(whole.simulations == simulations);
+
+        // the threads don't change the stats
+        require_same(whole, simulate_stats(empty, 11, method, one));
+
+        // and neither do the shards, in any order
+        auto merged = simulate_stats(empty, 11, method, one, shard{ 1, 2 });
+        merged += simulate_stats(empty, 11, method, pool, shard{ 0, 2 });
+        require_same(whole, merged);
+    }
+}
+
+TEST_CASE("merge_shards")
+{
+    using namespace nhl::lottery;
+
+    constexpr std::size_t simulations{ 2 * nhl::simulation_block_size };
+
+    const auto empty = empty_stats(simulations);
+    const stats_key key{ format_for(*empty.lottery_teams, 2),
+        empty.lottery_teams, simulations, 3 };
+
+    nhl::thread_pool pool{ 2 };
+
+    const auto directory = std::filesystem::temp_directory_path() /
+        "nhl_shard_tests";
+    std::filesystem::create_directories(directory);
+
+    std::vector<shard_file> files;
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        const shard s{ i, 2 };
+        const auto path = directory / ("shard" + std::to_string(i));
+
+        write_shard_file(path, key, s,
+            simulate_stats(empty, 3, draw_method::draw, pool, s));
+        files.push_back(load_shard_file(path));
+
+        REQUIRE(files.back().shard == s);
+        REQUIRE(files.back().key == key.text());
+    }
+
+    std::filesystem::remove_all(directory);
+
+    require_same(merge_shards(files),
+        simulate_stats(empty, 3, draw_method::draw, pool));
+
+    SUBCASE("a shard twice")
+    {
+        files.push_back(files.front());
+        REQUIRE_THROWS_AS(merge_shards(files), std::invalid_argument);
+    }
+
+    SUBCASE("a missing shard")
+    {
+        files.pop_back();
+        REQUIRE_THROWS_AS(merge_shards(files), std::invalid_argument);
+    }
+
+    SUBCASE("a different run")
+    {
+        files.back().key += "x";
+        REQUIRE_THROWS_AS(merge_shards(files), std::invalid_argument);
+    }
+
+    SUBCASE("a different shard count")
+    {
+        files.back().shard.count = 3;
+        REQUIRE_THROWS_AS(merge_shards(files), std::invalid_argument);
+    }
+
+    REQUIRE_THROWS(parse_shard_file("NHLC"));
+}
@@ -0,0 +1,147 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/stats_cache.h"
+#include "nhl/lottery/ties.h"
+#include "teams_2023.h"
+
+namespace
+{
+    nhl::lottery::lottery_teams tied_teams()
+    {
+        using namespace nhl::lottery;
+
+        constexpr std::array ties{ tie_group{ 2, 3 } };
+
+        return lottery_teams{ test::teams_2023, ties };
+    }
+
+    nhl::lottery::lottery_stats sampled_stats(
+        nhl::lottery::lottery_format const& format,
+        nhl::lottery::lottery_teams const& teams, std::size_t simulations)
+    {
+        using namespace nhl::lottery;
+
+        lottery_stats ret{ .simulations = simulations,
+            .rounds = format.rounds };
+        ret.lottery_teams = teams;
+
+        std::mt19937 gen{ 2024 };
+        for (std::size_t i = 0; i < simulations; ++i)
+        {
+            const auto result = sample_draw(format, gen);
+
+            for (std::size_t pick = 0; pick < result.draft_order().size();
+                ++pick)
+            {
+                ++ret.draft_order_stats[static_cast<int>(pick + 1)]
+                    [result.draft_order()[pick]];
+            }
+        }
+
+        return ret;
+    }
+}
+
+TEST_CASE("stats_key")
+{
+    using namespace nhl::lottery;
+
+    const auto teams = tied_teams();
+    const auto format = format_for(teams, 2);
+
+    const stats_key key{ format, teams, 1000, 5 };
+
+    REQUIRE(key == stats_key{ format, teams, 1000, 5 });
+    REQUIRE(key.hash() == stats_key{ format, teams, 1000, 5 }.hash());
+    REQUIRE(key.file_name().ends_with(".nhlc"));
+    REQUIRE(key.text().find("ties=2-3\n") != std::string::npos);
+
+    // every input is part of the key
+    REQUIRE(key != stats_key{ format, teams, 1001, 5 });
+    REQUIRE(key != stats_key{ format, teams, 1000, 6 });
+    REQUIRE(key != stats_key{ format, teams, 1000, 5, "sampled" });
+    REQUIRE(key != stats_key{ format, std::nullopt, 1000, 5 });
+    REQUIRE(key != stats_key{ format_for(teams, 3), teams, 1000, 5 });
+    REQUIRE(key.hash() != stats_key{ format, teams, 1001, 5 }.hash());
+}
+
+TEST_CASE("stats_cache")
+{
+    using namespace nhl::lottery;
+
+    const auto directory = std::filesystem::temp_directory_path() /
+        "nhl_stats_cache_tests";
+    std::filesystem::remove_all(directory);
+
+    const stats_cache cache{ directory };
+
+    const auto teams = tied_teams();
+    const auto format = format_for(teams, 2);
+    const stats_key key{ format, teams, 500, 5 };
+    const auto stats = sampled_stats(format, teams, 500);
+
+    REQUIRE_FALSE(cache.load(key));
+
+    std::size_t computed{ 0 };
+    const auto compute = [&]()
+    {
+        ++computed;
+        return stats;
+    };
+
+    SUBCASE("round trip")
+    {
+        const auto [first, first_hit] = cache.load_or_compute(key, teams,
+            compute);
+        const auto [second, second_hit] = cache.load_or_compute(key, teams,
+            compute);
+
+        REQUIRE_FALSE(first_hit);
+        REQUIRE(second_hit);
+        REQUIRE(computed == 1);
+
+        REQUIRE(second.simulations == 500);
+        REQUIRE(second.draft_order_stats == stats.draft_order_stats);
+
+        // the teams come from the key, with their ties
+        REQUIRE(second.lottery_teams->ties().size() == 1);
+
+        // only the finished file is left in the directory
+        REQUIRE(std::distance(std::filesystem::directory_iterator{ directory },
+            std::filesystem::directory_iterator{}) == 1);
+    }
+
+    SUBCASE("a different key misses")
+    {
+        cache.store(key, stats);
+
+        REQUIRE(cache.load(key));
+        REQUIRE_FALSE(cache.load(stats_key{ format, teams, 500, 6 }));
+    }
+
+    SUBCASE("a damaged file misses")
+    {
+        cache.store(key, stats);
+
+        std::filesystem::resize_file(cache.path_of(key),
+            std::filesystem::file_size(cache.path_of(key)) - 1);
+        REQUIRE_FALSE(cache.load(key));
+
+        {
+            std::ofstream out{ cache.path_of(key), std::ios::binary };
+            out << "NHLC";
+        }
+        REQUIRE_FALSE(cache.load(key));
+
+        // and is replaced by the next store
+        cache.load_or_compute(key, teams, compute);
+        REQUIRE(computed == 1);
+        REQUIRE(cache.load(key));
+    }
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "nhl/team.h"
+#include "nhl/lottery/team.h"
+#include "nhl/lottery/teams.h"
+
+namespace nhl::lottery::test
+{
+    // The teams of the 2023 draft lottery, which the lottery tests use
+    inline constexpr lottery_teams::teams_type teams_2023
+    {
+        team{ 1, nhl::team_id::ana },
+        team{ 2, nhl::team_id::cbj },
+        team{ 3, nhl::team_id::chi },
+        team{ 4, nhl::team_id::sjs },
+        team{ 5, nhl::team_id::mtl },
+        team{ 6, nhl::team_id::ari },
+        team{ 7, nhl::team_id::phi },
+        team{ 8, nhl::team_id::wsh },
+        team{ 9, nhl::team_id::det },
+        team{ 10, nhl::team_id::stl },
+        team{ 11, nhl::team_id::van },
+        team{ 12, nhl::team_id::ott },
+        team{ 13, nhl::team_id::buf },
+        team{ 14, nhl::team_id::pit },
+        team{ 15, nhl::team_id::nsh },
+        team{ 16, nhl::team_id::cgy }
+    };
+}
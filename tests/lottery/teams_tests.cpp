@@ -0,0 +1,80 @@
+#include <doctest/doctest.h>
+#include <stdexcept>
+#include "nhl/lottery/teams.h"
+
+namespace
+{
+    // 2023 final standings, out of order
+    constexpr nhl::lottery::lottery_teams::teams_type teams_2023
+    {
+        nhl::lottery::team{ 16, nhl::team_id::cgy },
+        nhl::lottery::team{ 2, nhl::team_id::cbj },
+        nhl::lottery::team{ 3, nhl::team_id::chi },
+        nhl::lottery::team{ 4, nhl::team_id::sjs },
+        nhl::lottery::team{ 5, nhl::team_id::mtl },
+        nhl::lottery::team{ 6, nhl::team_id::ari },
+        nhl::lottery::team{ 7, nhl::team_id::phi },
+        nhl::lottery::team{ 8, nhl::team_id::wsh },
+        nhl::lottery::team{ 9, nhl::team_id::det },
+        nhl::lottery::team{ 10, nhl::team_id::stl },
+        nhl::lottery::team{ 11, nhl::team_id::van },
+        nhl::lottery::team{ 12, nhl::team_id::ott },
+        nhl::lottery::team{ 13, nhl::team_id::buf },
+        nhl::lottery::team{ 14, nhl::team_id::pit },
+        nhl::lottery::team{ 15, nhl::team_id::nsh },
+        nhl::lottery::team{ 1, nhl::team_id::ana }
+    };
+}
+
+TEST_CASE("lottery_teams")
+{
+    using namespace nhl::lottery;
+
+    constexpr lottery_teams teams{ teams_2023 };
+
+    SUBCASE("ranking to team")
+    {
+        static_assert(teams.lookup(1) == nhl::team_id::ana);
+        static_assert(teams.lookup(16) == nhl::team_id::cgy);
+        static_assert(teams.team_at(3) == nhl::team_id::chi);
+
+        static_assert(!teams.lookup(0));
+        static_assert(!teams.lookup(17));
+    }
+
+    SUBCASE("team to ranking")
+    {
+        static_assert(teams.ranking_of(nhl::team_id::ana) == 1);
+        static_assert(teams.ranking_of(nhl::team_id::nsh) == 15);
+
+        // playoff teams
+        static_assert(!teams.ranking_of(nhl::team_id::bos));
+        static_assert(!teams.ranking_of(nhl::team_id::tor));
+    }
+
+    SUBCASE("both directions agree")
+    {
+        for (int ranking = 1; ranking <= 16; ++ranking)
+        {
+            REQUIRE(teams.ranking_of(teams.team_at(ranking)) == ranking);
+        }
+    }
+
+    SUBCASE("invalid teams")
+    {
+        auto duplicate_ranking = teams_2023;
+        duplicate_ranking[0].ranking = 1;
+        REQUIRE_THROWS_AS(lottery_teams{ duplicate_ranking },
+            std::invalid_argument);
+
+        auto duplicate_team = teams_2023;
+        duplicate_team[0].team_id = nhl::team_id::ana;
+        REQUIRE_THROWS_AS(lottery_teams{ duplicate_team },
+            std::invalid_argument);
+
+        auto out_of_range = teams_2023;
+        out_of_range[0].ranking = 17;
+        REQUIRE_THROWS_AS(lottery_teams{ out_of_range },
+            std::invalid_argument);
+    }
+}
@@ -0,0 +1,89 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "nhl/lottery/ties.h"
+#include "teams_2023.h"
+
+namespace
+{
+    constexpr auto const& teams{ nhl::lottery::test::teams_2023 };
+}
+
+TEST_CASE("split_tied_combinations")
+{
+    using namespace nhl::lottery;
+
+    auto combinations = format_of<standard_rules>().combinations_per_ranking;
+    const auto total = std::accumulate(combinations.begin(),
+        combinations.end(), std::size_t{ 0 });
+
+    SUBCASE("an even split")
+    {
+        // 185 + 135 = 2 * 160
+        const std::vector<tie_group> ties{ { 1, 2 } };
+        split_tied_combinations(combinations, ties);
+
+        REQUIRE(combinations[0] == 160);
+        REQUIRE(combinations[1] == 160);
+        REQUIRE(combinations[2] == 115);
+    }
+
+    SUBCASE("the remainder goes to the first teams")
+    {
+        // 95 + 85 + 75 + 65 = 320 = 4 * 80, 60 + 50 + 35 = 145 = 3 * 48 + 1
+        const std::vector<tie_group> ties{ { 4, 7 }, { 8, 10 } };
+        split_tied_combinations(combinations, ties);
+
+        REQUIRE(combinations[3] == 80);
+        REQUIRE(combinations[6] == 80);
+        REQUIRE(combinations[7] == 49);
+        REQUIRE(combinations[8] == 48);
+        REQUIRE(combinations[9] == 48);
+    }
+
+    SUBCASE("no combinations are lost")
+    {
+        const std::vector<tie_group> ties{ { 2, 5 }, { 11, 16 } };
+        split_tied_combinations(combinations, ties);
+
+        REQUIRE(std::accumulate(combinations.begin(), combinations.end(),
+            std::size_t{ 0 }) == total);
+    }
+
+    SUBCASE("invalid groups")
+    {
+        const std::vector<tie_group> past_the_end{ { 15, 17 } };
+        REQUIRE_THROWS_AS(split_tied_combinations(combinations,
+            past_the_end), std::out_of_range);
+
+        const std::vector<tie_group> one_team{ { 3, 3 } };
+        REQUIRE_THROWS_AS(split_tied_combinations(combinations,
+            one_team), std::out_of_range);
+    }
+}
+
+TEST_CASE("lottery_teams with ties")
+{
+    using namespace nhl::lottery;
+
+    const std::array ties{ tie_group{ 12, 13 }, tie_group{ 2, 4 } };
+    const lottery_teams tied{ teams, ties };
+
+    REQUIRE(tied.ties().size() == 2);
+    REQUIRE(tied.ties()[0].first_ranking == 2);
+    REQUIRE(tied.ties()[1].first_ranking == 12);
+
+    const auto format = format_for(tied);
+    REQUIRE(format.combinations_per_ranking[1] == 115);
+    REQUIRE(format.combinations_per_ranking[3] == 115);
+    REQUIRE(format.combinations_per_ranking[11] == 23);
+    REQUIRE(format.combinations_per_ranking[12] == 22);
+
+    REQUIRE(lottery_teams{ teams }.ties().empty());
+
+    const std::array overlapping{ tie_group{ 2, 4 }, tie_group{ 4, 5 } };
+    REQUIRE_THROWS_AS((lottery_teams{ teams, overlapping }),
+        std::invalid_argument);
+}
@@ -0,0 +1,267 @@
+#include <doctest/doctest.h>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "nhl/random.h"
+#include "nhl/math/goodness_of_fit.h"
+#include "nhl/lottery/ball.h"
+#include "nhl/lottery/combination.h"
+#include "nhl/lottery/combination_table.h"
+#include "nhl/lottery/draw.h"
+#include "nhl/lottery/exact_odds.h"
+#include "nhl/lottery/machine.h"
+#include "nhl/lottery/rules.h"
+
+// Every way of drawing a lottery has to give the exact distributions, so each
+// backend is run for a fixed number of draws and its counts are tested
+// against them with both the chi-square and the G test. The seeds are fixed,
+// so a failure is repeatable; at this significance level a correct backend
+// only fails for about 1 seed in 10,000 per test.
+
+namespace
+{
+    constexpr double significance{ 1e-4 };
+
+    void require_fit(std::string_view name,
+        std::span<std::size_t const> observed,
+        std::span<double const> probabilities)
+    {
+        const auto chi = math::chi_square_test(observed, probabilities);
+        const auto g = math::g_test(observed, probabilities);
+
+        CAPTURE(name);
+        CAPTURE(chi.statistic);
+        CAPTURE(chi.degrees_of_freedom);
+        CAPTURE(g.statistic);
+        REQUIRE(chi.p_value >= significance);
+        REQUIRE(g.p_value >= significance);
+    }
+
+    // The winner of each round and the ranking with the 1st pick
+    struct winner_counts
+    {
+        std::array<std::array<std::size_t, 16>, 2> round_winners{};
+        std::array<std::size_t, 16> first_pick{};
+
+        void record(std::span<int const> winners,
+            std::span<int const> draft_order)
+        {
+            for (std::size_t r = 0; r < round_winners.size(); ++r)
+            {
+                ++round_winners[r][static_cast<std::size_t>(winners[r] - 1)];
+            }
+            ++first_pick[static_cast<std::size_t>(draft_order[0] - 1)];
+        }
+
+        void require_exact(std::string_view backend) const
+        {
+            using namespace nhl::lottery;
+
+            CAPTURE(backend);
+
+            require_fit("round 1 winners", round_winners[0],
+                standard_round_winner_table[0]);
+            require_fit("round 2 winners", round_winners[1],
+                standard_round_winner_table[1]);
+
+            std::array<double, 16> first_pick_odds{};
+            for (std::size_t r = 0; r < first_pick_odds.size(); ++r)
+            {
+                first_pick_odds[r] = standard_pick_table[r][0];
+            }
+            require_fit("1st pick", first_pick, first_pick_odds);
+        }
+    };
+
+    constexpr std::size_t draws{ 50'000 };
+}
+
+TEST_CASE("the machine draws the balls uniformly")
+{
+    using namespace nhl::lottery;
+
+    constexpr std::size_t combinations_drawn{ 100'000 };
+
+    auto gen = nhl::make_random_engine(49, 0);
+    machine m;
+
+    // each ball is as likely to come out at each position, and every
+    // combination is as likely
+    std::array<std::array<std::size_t, ball_count>, balls_to_draw> positions{};
+    std::vector<std::size_t> combinations(combination_count);
+
+    for (std::size_t i = 0; i < combinations_drawn; ++i)
+    {
+        m.load_balls(std::span{ balls });
+
+        combination::balls_type drawn;
+        for (std::size_t b = 0; b < balls_to_draw; ++b)
+        {
+            drawn[b] = m.draw_ball(gen);
+            ++positions[b][static_cast<std::size_t>(
+                static_cast<int>(drawn[b]) - 1)];
+        }
+
+        ++combinations[combination_index(to_value(combination{ drawn }))];
+    }
+
+    std::array<double, ball_count> uniform_balls{};
+    uniform_balls.fill(1.0);
+
+    for (auto const& counts : positions)
+    {
+        require_fit("balls", counts, uniform_balls);
+    }
+
+    const std::vector<double> uniform_combinations(combination_count, 1.0);
+    require_fit("combinations", combinations, uniform_combinations);
+}
+
+TEST_CASE("the tables assign the combinations in proportion")
+{
+    using namespace nhl::lottery;
+
+    constexpr std::size_t populates{ 20'000 };
+
+    // the owner of a few combinations spread over the table (ranking 0 is
+    // a redraw), which is each ranking in proportion to its combinations;
+    // the last combination in lexicographic order is always the redraw
+    constexpr std::array<std::size_t, 3> positions{ 0, 500, 999 };
+
+    std::array<double, 17> owner_odds{};
+    for (std::size_t r = 0; r < 16; ++r)
+    {
+        owner_odds[r + 1] = static_cast<double>(
+            standard_rules::combinations_per_ranking[r]);
+    }
+
+    const auto owners = [&](auto& table)
+    {
+        auto gen = nhl::make_random_engine(49, 1);
+        std::array<std::array<std::size_t, 17>, positions.size()> ret{};
+
+        for (std::size_t i = 0; i < populates; ++i)
+        {
+            table.populate(gen);
+            for (std::size_t p = 0; p < positions.size(); ++p)
+            {
+                ++ret[p][table.rankings()[
+                    detail::lexicographic_combination_indices[positions[p]]]];
+            }
+
+            REQUIRE(table.rankings()[detail::lexicographic_combination_indices[
+                combination_count - 1]] == 0);
+        }
+
+        return ret;
+    };
+
+    combination_table standard;
+    for (auto const& counts : owners(standard))
+    {
+        require_fit("combination_table", counts, owner_odds);
+    }
+
+    format_combination_table format{ format_of<standard_rules>() };
+    for (auto const& counts : owners(format))
+    {
+        require_fit("format_combination_table", counts, owner_odds);
+    }
+}
+
+TEST_CASE("every backend draws the exact winner odds")
+{
+    using namespace nhl::lottery;
+
+    const auto format = format_of<standard_rules>();
+
+    SUBCASE("run_draw")
+    {
+        auto gen = nhl::make_random_engine(49, 2);
+        combination_table table;
+        machine m;
+        winner_counts counts;
+
+        for (std::size_t i = 0; i < draws; ++i)
+        {
+            table.populate(gen);
+            const auto result = run_draw(table, m, 2, gen);
+            counts.record(result.winners, result.draft_order);
+        }
+
+        counts.require_exact("run_draw");
+    }
+
+    SUBCASE("run_draw with a format")
+    {
+        auto gen = nhl::make_random_engine(49, 3);
+        format_combination_table table{ format };
+        machine m;
+        winner_counts counts;
+
+        for (std::size_t i = 0; i < draws; ++i)
+        {
+            table.populate(gen);
+            const auto result = run_draw(table, m, gen);
+            counts.record(result.winners, result.draft_order());
+        }
+
+        counts.require_exact("run_draw with a format");
+    }
+
+    SUBCASE("sample_draw")
+    {
+        auto gen = nhl::make_random_engine(49, 4);
+        winner_counts counts;
+
+        for (std::size_t i = 0; i < draws; ++i)
+        {
+            const auto result = sample_draw<standard_rules>(2, gen);
+            counts.record(result.winners, result.draft_order);
+        }
+
+        counts.require_exact("sample_draw");
+    }
+
+    SUBCASE("sample_draw with a format")
+    {
+        auto gen = nhl::make_random_engine(49, 5);
+        winner_counts counts;
+
+        for (std::size_t i = 0; i < draws; ++i)
+        {
+            const auto result = sample_draw(format, gen);
+            counts.record(result.winners, result.draft_order());
+        }
+
+        counts.require_exact("sample_draw with a format");
+    }
+}
+
+TEST_CASE("a biased backend fails the validation")
+{
+    using namespace nhl::lottery;
+
+    // sample_draw with the last two rankings' combinations given to the
+    // 1st: a 1% shift that the tests have to catch
+    auto biased = format_of<standard_rules>();
+    biased.combinations_per_ranking[0] += 10;
+    biased.combinations_per_ranking[14] -= 5;
+    biased.combinations_per_ranking[15] -= 5;
+
+    auto gen = nhl::make_random_engine(49, 6);
+    std::array<std::size_t, 16> round_winners{};
+
+    for (std::size_t i = 0; i < draws; ++i)
+    {
+        ++round_winners[static_cast<std::size_t>(
+            sample_draw(biased, gen).winners[0] - 1)];
+    }
+
+    REQUIRE(math::chi_square_test(round_winners,
+        standard_round_winner_table[0]).p_value < significance);
+    REQUIRE(math::g_test(round_winners,
+        standard_round_winner_table[0]).p_value < significance);
+}
@@ -0,0 +1,30 @@
+#include <doctest/doctest.h>
+#include <string>
+#include "nhl/lru_cache.h"
+
+TEST_CASE("lru_cache")
+{
+    nhl::lru_cache<std::string, int> cache{ 2 };
+
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+
+    REQUIRE(cache.size() == 2);
+    REQUIRE(*cache.find("a") == 1);
+
+    // "b" is now the least recently used
+    cache.insert("c", 3);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.find("b") == nullptr);
+    REQUIRE(*cache.find("a") == 1);
+    REQUIRE(*cache.find("c") == 3);
+
+    // replacing a value doesn't drop anything
+    cache.insert("a", 4);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(*cache.find("a") == 4);
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.find("a") == nullptr);
+}
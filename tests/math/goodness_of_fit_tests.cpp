@@ -0,0 +1,48 @@
+#include <doctest/doctest.h>
+#include "nhl/math/goodness_of_fit.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+TEST_CASE("chi_square_p_value")
+{
+    using math::chi_square_p_value;
+
+    // the 5% critical values
+    REQUIRE(chi_square_p_value(3.841459, 1) == doctest::Approx(0.05));
+    REQUIRE(chi_square_p_value(18.307038, 10) == doctest::Approx(0.05));
+    REQUIRE(chi_square_p_value(1073.643, 999) == doctest::Approx(0.05));
+
+    // with 2 degrees of freedom it's exp(-x / 2)
+    REQUIRE(chi_square_p_value(2.0, 2) == doctest::Approx(std::exp(-1.0)));
+    REQUIRE(chi_square_p_value(0.5, 2) == doctest::Approx(std::exp(-0.25)));
+
+    REQUIRE(chi_square_p_value(0.0, 5) == 1.0);
+    REQUIRE(chi_square_p_value(1.0, 0) == 0.0);
+}
+
+TEST_CASE("chi_square_test")
+{
+    const std::array<std::size_t, 4> observed{ 30, 20, 25, 25 };
+    const std::array probabilities{ 0.25, 0.25, 0.25, 0.25 };
+
+    const auto chi = math::chi_square_test(observed, probabilities);
+    REQUIRE(chi.statistic == doctest::Approx(2.0));
+    REQUIRE(chi.degrees_of_freedom == 3);
+    REQUIRE(chi.p_value == doctest::Approx(0.572407));
+
+    const auto g = math::g_test(observed, probabilities);
+    REQUIRE(g.statistic == doctest::Approx(2.0 * (30 * std::log(1.2) +
+        20 * std::log(0.8))));
+    REQUIRE(g.degrees_of_freedom == 3);
+
+    // a bin that can't happen only counts if it was observed
+    const std::array impossible{ 0.5, 0.5, 0.0, 0.0 };
+    const std::array<std::size_t, 4> possible{ 50, 50, 0, 0 };
+
+    REQUIRE(math::chi_square_test(possible, impossible).statistic == 0.0);
+    REQUIRE(math::chi_square_test(possible, impossible).degrees_of_freedom ==
+        1);
+    REQUIRE(math::chi_square_test(observed, impossible).p_value == 0.0);
+}
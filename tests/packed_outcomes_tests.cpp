@@ -0,0 +1,87 @@
+#include <doctest/doctest.h>
+#include <unordered_set>
+#include "nhl/packed_outcomes.h"
+#include "nhl/schedule.h"
+
+TEST_CASE("packed_outcomes")
+{
+    using namespace nhl;
+
+    constexpr auto games_count = remaining_games.size();
+
+    const auto outcome_at = [](std::size_t i)
+    {
+        return static_cast<game_outcome>((i * 5 + 3) % game_outcome_count);
+    };
+
+    SUBCASE("round trip")
+    {
+        packed_outcomes outcomes{ games_count };
+        REQUIRE(outcomes.words().size() == 4);
+
+        for (std::size_t i = 0; i < games_count; ++i)
+        {
+            outcomes.set(i, outcome_at(i));
+        }
+
+        for (std::size_t i = 0; i < games_count; ++i)
+        {
+            REQUIRE(outcomes[i] == outcome_at(i));
+        }
+
+        // overwriting a value doesn't touch its neighbours
+        outcomes.set(20, game_outcome::visitor_shootout);
+        REQUIRE(outcomes[19] == outcome_at(19));
+        REQUIRE(outcomes[20] == game_outcome::visitor_shootout);
+        REQUIRE(outcomes[21] == outcome_at(21));
+
+        REQUIRE_THROWS_AS(outcomes.set(games_count,
+            game_outcome::home_regulation), std::out_of_range);
+    }
+
+    SUBCASE("apply")
+    {
+        packed_outcomes outcomes{ games_count };
+        auto expected = index_by_team(standings);
+
+        for (std::size_t i = 0; i < games_count; ++i)
+        {
+            outcomes.set(i, outcome_at(i));
+            apply(expected, remaining_games[i], outcome_at(i));
+        }
+
+        auto actual = index_by_team(standings);
+        apply(actual, remaining_games, outcomes);
+
+        for (std::size_t t = 0; t < team_count; ++t)
+        {
+            REQUIRE(points(actual[t]) == points(expected[t]));
+            REQUIRE(actual[t].games_played == expected[t].games_played);
+            REQUIRE(actual[t].regulation_wins == expected[t].regulation_wins);
+        }
+    }
+
+    SUBCASE("deduplication")
+    {
+        packed_outcomes a{ games_count };
+        packed_outcomes b{ games_count };
+        b.set(74, game_outcome::home_overtime);
+
+        std::unordered_set<packed_outcomes> seen{ a, b, a };
+        REQUIRE(seen.size() == 2);
+        REQUIRE(a < b);
+
+        packed_outcome_store store{ games_count };
+        store.push_back(a);
+        store.push_back(b);
+        store.push_back(a);
+
+        REQUIRE(store.size() == 3);
+        REQUIRE(store.memory_usage() == 3 * 4 * sizeof(std::uint64_t));
+        REQUIRE(store[1] == b);
+        REQUIRE(store.outcome(1, 74) == game_outcome::home_overtime);
+        REQUIRE(store.equal(0, 2));
+        REQUIRE(store.hash(0) == std::hash<packed_outcomes>{}(a));
+        REQUIRE(store.distinct_count() == 2);
+    }
+}
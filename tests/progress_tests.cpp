@@ -0,0 +1,67 @@
+#include <doctest/doctest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "nhl/progress.h"
+#include "nhl/thread_pool.h"
+#include "nhl/lottery/scenario.h"
+
+TEST_CASE("progress_counters")
+{
+    SUBCASE("every worker's additions are counted")
+    {
+        nhl::progress_counters progress{ 4 * 10'000, 4 };
+
+        {
+            std::vector<std::jthread> workers;
+            for (int w = 0; w < 4; ++w)
+            {
+                workers.emplace_back([&progress]()
+                {
+                    const auto counter = progress.claim();
+                    for (int i = 0; i < 10'000; ++i)
+                    {
+                        progress.add(counter, 1);
+                    }
+                });
+            }
+        }
+
+        REQUIRE(progress.completed() == progress.total());
+    }
+
+    SUBCASE("more workers than counters share them")
+    {
+        nhl::progress_counters progress{ 3, 2 };
+
+        progress.add(progress.claim(), 1);
+        progress.add(progress.claim(), 1);
+        progress.add(progress.claim(), 1);
+
+        REQUIRE(progress.completed() == 3);
+    }
+
+    SUBCASE("a batch counts all its draws")
+    {
+        using namespace nhl::lottery;
+
+        const scenario scenarios[]
+        {
+            { "standard", format_of<standard_rules>(), {} },
+            { "standard", format_of<standard_rules>(), {} }
+        };
+
+        nhl::thread_pool pool{ 3 };
+        nhl::progress_counters progress{ 2 * 10'000, pool.size() };
+
+        {
+            // stops as soon as it's destroyed
+            const nhl::progress_reporter reporter{ progress,
+                std::chrono::hours{ 1 }, 2 };
+
+            run_scenarios(scenarios, 10'000, 7, pool, &progress);
+        }
+
+        REQUIRE(progress.completed() == 2 * 10'000);
+    }
+}
@@ -0,0 +1,67 @@
+#include <doctest/doctest.h>
+#include "nhl/standings.h"
+
+TEST_CASE("ranks_ahead")
+{
+    using nhl::team_record;
+    using nhl::ranks_ahead;
+    using enum nhl::team_id;
+
+    SUBCASE("points")
+    {
+        constexpr team_record lhs{ ana, 80, 40, 30, 10 };
+        constexpr team_record rhs{ bos, 80, 40, 35, 5 };
+
+        static_assert(ranks_ahead(lhs, rhs));
+        static_assert(!ranks_ahead(rhs, lhs));
+    }
+
+    SUBCASE("games played")
+    {
+        constexpr team_record lhs{ ana, 79, 40, 29, 10 };
+        constexpr team_record rhs{ bos, 80, 40, 30, 10 };
+
+        static_assert(ranks_ahead(lhs, rhs));
+        static_assert(!ranks_ahead(rhs, lhs));
+    }
+
+    SUBCASE("regulation wins")
+    {
+        constexpr team_record lhs{ ana, 80, 40, 30, 10, 35 };
+        constexpr team_record rhs{ bos, 80, 40, 30, 10, 30 };
+
+        static_assert(ranks_ahead(lhs, rhs));
+        static_assert(!ranks_ahead(rhs, lhs));
+    }
+
+    SUBCASE("team id")
+    {
+        constexpr team_record lhs{ ana, 80, 40, 30, 10, 35 };
+        constexpr team_record rhs{ bos, 80, 40, 30, 10, 35 };
+
+        static_assert(ranks_ahead(lhs, rhs));
+        static_assert(!ranks_ahead(rhs, lhs));
+        static_assert(!ranks_ahead(lhs, lhs));
+    }
+}
+
+TEST_CASE("non_playoff_teams")
+{
+    using enum nhl::team_id;
+
+    constexpr auto records = nhl::index_by_team(nhl::standings);
+
+    static_assert(records[static_cast<std::size_t>(ana)].id == ana);
+    static_assert(records[static_cast<std::size_t>(wsh)].id == wsh);
+
+    constexpr auto teams = nhl::non_playoff_teams(records);
+
+    // worst record first
+    constexpr std::array expected
+    {
+        ana, cbj, chi, sjs, mtl, ari, phi, van,
+        wsh, stl, det, ott, buf, pit, nsh, cgy
+    };
+
+    static_assert(teams == expected);
+}
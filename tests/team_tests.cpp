@@ -124,4 +124,62 @@ TEST_CASE("team_id")
 
         static_assert(to_string(static_cast<team_id>(100)) == "?");
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("to_team_id")
+{
+    using namespace nhl;
+
+    static_assert(to_team_id("ANA") == team_id::ana);
+    static_assert(to_team_id("TOR") == team_id::tor);
+    static_assert(to_team_id("WSH") == team_id::wsh);
+
+    for (std::size_t i = 0; i < text_literals::team_ids.size(); ++i)
+    {
+        CAPTURE(text_literals::team_ids[i]);
+        REQUIRE(to_team_id(text_literals::team_ids[i]) ==
+            static_cast<team_id>(i));
+    }
+
+    static_assert(!to_team_id(""));
+    static_assert(!to_team_id("TO"));
+    static_assert(!to_team_id("TORO"));
+    static_assert(!to_team_id("tor"));
+    static_assert(!to_team_id("XYZ"));
+
+    // every other 3 letter string misses
+    std::size_t hits{ 0 };
+    for (char a = 'A'; a <= 'Z'; ++a)
+    {
+        for (char b = 'A'; b <= 'Z'; ++b)
+        {
+            for (char c = 'A'; c <= 'Z'; ++c)
+            {
+                const char s[]{ a, b, c };
+                if (const auto id = to_team_id({ s, 3 }))
+                {
+                    REQUIRE(to_string(*id) == std::string_view{ s, 3 });
+                    ++hits;
+                }
+            }
+        }
+    }
+    REQUIRE(hits == text_literals::team_ids.size());
+
+    const char nuls[3]{};
+    REQUIRE(!to_team_id({ nuls, 3 }));
+}
+
+TEST_CASE("lookup")
+{
+    using namespace nhl;
+
+    static_assert(lookup(team_id::tor).name == "Toronto Maple Leafs");
+
+    for (auto const& t : teams)
+    {
+        REQUIRE(lookup(t.id).id == t.id);
+    }
+
+    REQUIRE_THROWS_AS(lookup(static_cast<team_id>(32)), std::out_of_range);
+}
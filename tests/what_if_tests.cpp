@@ -0,0 +1,132 @@
+#include <doctest/doctest.h>
+#include "nhl/what_if.h"
+#include "nhl/schedule.h"
+
+TEST_CASE("what_if_engine")
+{
+    using enum nhl::team_id;
+
+    const nhl::season_model model
+    {
+        nhl::index_by_team(nhl::standings),
+        nhl::remaining_games
+    };
+
+    nhl::thread_pool pool{ 2 };
+    nhl::what_if_engine engine{ model, 20000, 42, pool,
+        { .min_effective_samples = 1000.0, .resample_simulations = 5000 } };
+
+    const auto unconditional = engine.query({});
+    REQUIRE(unconditional.samples == 20000);
+    REQUIRE(unconditional.effective_samples == doctest::Approx(20000.0));
+    REQUIRE_FALSE(unconditional.resampled);
+
+    // game 6 is TOR @ BOS
+    REQUIRE(nhl::remaining_games[6].visitor == tor);
+    REQUIRE(nhl::remaining_games[6].home == bos);
+
+    REQUIRE_THROWS_AS(nhl::fix_winner(model, nhl::remaining_games.size(),
+        tor), std::out_of_range);
+
+    SUBCASE("fixing a result filters the samples")
+    {
+        const auto result = engine.query({ nhl::fix_winner(model, 6, tor) });
+        REQUIRE_FALSE(result.resampled);
+
+        std::size_t matches{ 0 };
+        for (std::size_t s = 0; s < engine.samples().size(); ++s)
+        {
+            if (!nhl::home_win(engine.samples().outcome(s, 6)))
+            {
+                ++matches;
+            }
+        }
+
+        REQUIRE(result.samples == matches);
+        REQUIRE(result.effective_samples == doctest::Approx(
+            static_cast<double>(matches)));
+    }
+
+    SUBCASE("odds add up")
+    {
+        const auto result = engine.query({ nhl::fix_winner(model, 6, tor) });
+
+        for (std::size_t r = 0; r < nhl::non_playoff_team_count; ++r)
+        {
+            double total{ 0.0 };
+            for (auto const& team_odds : result.lottery_ranking_odds)
+            {
+                total += team_odds[r];
+            }
+
+            CAPTURE(r);
+            REQUIRE(total == doctest::Approx(1.0));
+        }
+
+        double playoff_spots{ 0.0 };
+        for (auto const& odds : result.playoff_odds)
+        {
+            playoff_spots += odds;
+        }
+        REQUIRE(playoff_spots == doctest::Approx(nhl::playoff_team_count));
+    }
+
+    SUBCASE("too few matches are resampled")
+    {
+        // every game of PIT's is won in a shootout
+        std::vector<nhl::game_condition> conditions;
+        for (std::size_t i = 0; i < nhl::remaining_games.size(); ++i)
+        {
+            auto const& g = nhl::remaining_games[i];
+            if (g.home == pit)
+            {
+                conditions.push_back(nhl::fix_outcomes(model, i,
+                    std::array{ nhl::game_outcome::home_shootout }));
+            }
+            else if (g.visitor == pit)
+            {
+                conditions.push_back(nhl::fix_outcomes(model, i,
+                    std::array{ nhl::game_outcome::visitor_shootout }));
+            }
+        }
+
+        const auto result = engine.query(conditions);
+        REQUIRE(result.resampled);
+        REQUIRE(result.samples == 5000);
+
+        // the cached conditional samples are used the next time
+        const auto again = engine.query(conditions);
+        REQUIRE(again.resampled);
+        REQUIRE(again.playoff_odds == result.playoff_odds);
+    }
+}
+
+TEST_CASE("what_if_engine keeps a bounded number of resampled queries")
+{
+    using enum nhl::team_id;
+
+    const nhl::season_model model
+    {
+        nhl::index_by_team(nhl::standings),
+        nhl::remaining_games
+    };
+
+    // every query with a condition is resampled, and only one is kept
+    nhl::thread_pool pool{ 2 };
+    nhl::what_if_engine engine{ model, 1000, 42, pool,
+        { .min_effective_samples = 1e9, .resample_simulations = 1000,
+            .resampled_queries = 1 } };
+
+    const auto tor_wins = engine.query({ nhl::fix_winner(model, 6, tor) });
+    REQUIRE(tor_wins.resampled);
+    REQUIRE(engine.resampled_count() == 1);
+
+    const auto bos_wins = engine.query({ nhl::fix_winner(model, 6, bos) });
+    REQUIRE(bos_wins.resampled);
+    REQUIRE(engine.resampled_count() == 1);
+
+    // dropped and resampled again, from the same random streams
+    const auto again = engine.query({ nhl::fix_winner(model, 6, tor) });
+    REQUIRE(engine.resampled_count() == 1);
+    REQUIRE(again.playoff_odds == tor_wins.playoff_odds);
+}